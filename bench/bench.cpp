@@ -0,0 +1,482 @@
+// kernel-sim-bench: micro-benchmarks de las estructuras calientes y escenarios
+// macro con cargas sinteticas. Los resultados se imprimen en consola y,
+// opcionalmente, se vuelcan a CSV/JSON para comparar entre versiones.
+//
+// Uso: kernel-sim-bench [--csv archivo] [--json archivo] [--max n] [--semilla s]
+#include "../modules/cpu/carga.h"
+#include "../modules/cpu/cpu.h"
+#include "../modules/cpu/politicas.h"
+#include "../modules/cpu/rueda_temporizadores.h"
+#include "../modules/cpu/cola_prioridad.h"
+#include "../modules/cpu/cfs.h"
+#include "../modules/cpu/proporcional.h"
+#include "../modules/cpu/tabla_procesos.h"
+#include "../modules/cpu/traza.h"
+#include "../modules/cpu/vectorial.h"
+#include "../modules/disk/disk.h"
+#include "../modules/mem/buddy.h"
+#include "../modules/mem/mem.h"
+#include "../modules/mem/paginacion.h"
+#include "../modules/mem/slab.h"
+#include "../modules/sync/bounded_buffer.h"
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <malloc.h>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct Resultado {
+    string grupo;   // micro | macro
+    string nombre;
+    uint64_t n;     // tamaño del escenario
+    uint64_t operaciones;
+    double segundos;
+    vector<pair<string, double>> extra;
+
+    double nsPorOperacion() const { return operaciones ? segundos * 1e9 / operaciones : 0.0; }
+};
+
+vector<Resultado> resultados;
+
+template <typename F>
+double cronometrar(F f) {
+    auto inicio = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+}
+
+void anotar(Resultado r) {
+    cout << left << setw(6) << r.grupo << setw(34) << r.nombre << right << setw(9) << r.n
+         << setw(14) << r.operaciones << setw(12) << fixed << setprecision(4) << r.segundos
+         << setw(12) << setprecision(1) << r.nsPorOperacion();
+    for (auto& [clave, valor] : r.extra) cout << "  " << clave << "=" << setprecision(2) << valor;
+    cout << "\n";
+    resultados.push_back(std::move(r));
+}
+
+// Evita que el compilador descarte resultados de los ciclos medidos
+volatile uint64_t sumidero;
+
+// ---------------------------------------------------------------- micro
+
+template <typename Politica>
+void benchPolitica(const string& nombre, size_t n) {
+    TablaProcesos tabla;
+    vector<PCB*> procesos;
+    procesos.reserve(n);
+    for (PCB& programa : generarCarga(Distribucion::Exponencial, n, 1))
+        procesos.push_back(tabla.crear(programa));
+
+    // encolar + siguiente de toda la carga
+    Politica politica;
+    double t = cronometrar([&] {
+        for (PCB* p : procesos) politica.encolar(p);
+        uint64_t suma = 0;
+        while (!politica.vacia()) suma += politica.siguiente()->pid.indice;
+        sumidero = suma;
+    });
+    anotar({"micro", nombre + "/encolar+siguiente", n, 2 * n, t, {}});
+
+    // elegir el siguiente con la cola llena (rotacion en estado estable)
+    for (PCB* p : procesos) politica.encolar(p);
+    const size_t vueltas = max<size_t>(n, 1000000);
+    t = cronometrar([&] {
+        uint64_t suma = 0;
+        for (size_t i = 0; i < vueltas; ++i) {
+            PCB* p = politica.siguiente();
+            if constexpr (requires { politica.contabilizar(*p, 1); }) politica.contabilizar(*p, 1);
+            suma += p->pid.indice;
+            politica.encolar(p);
+        }
+        sumidero = suma;
+    });
+    anotar({"micro", nombre + "/elegir-siguiente", n, vueltas, t, {}});
+}
+
+// Round robin con rafagas largas: casi todo el tiempo lo resuelve el salto cerrado
+void benchAvanceRapido(size_t n) {
+    CPU cpu(5);
+    for (size_t i = 0; i < n; ++i) cpu.add_process(PCB("p" + to_string(i), 1000000));
+    const long long ticks = 1000000000LL;
+    double t = cronometrar([&] { cpu.ejecutar(ticks); });
+    anotar({"micro", "avance-rapido/rr", n, (uint64_t) ticks, t, {{"terminados", (double) cpu.estadisticas().terminados}}});
+}
+
+// Rueda de temporizadores: programar, cancelar la mitad y vencer el resto
+void benchTemporizadores(size_t n) {
+    RuedaTemporizadores rueda;
+    vector<RuedaTemporizadores::Id> ids(n);
+    mt19937_64 generador(7);
+    double t = cronometrar([&] {
+        for (size_t i = 0; i < n; ++i) ids[i] = rueda.programar(1 + generador() % 1000000, nullptr);
+    });
+    anotar({"micro", "temporizadores/programar", n, n, t, {}});
+
+    t = cronometrar([&] {
+        for (size_t i = 0; i < n; i += 2) rueda.cancelar(ids[i]);
+    });
+    anotar({"micro", "temporizadores/cancelar", n, n / 2, t, {}});
+
+    uint64_t vencidos = 0;
+    t = cronometrar([&] { rueda.avanzar(1000001, [&](PCB*) { ++vencidos; }); });
+    anotar({"micro", "temporizadores/avanzar", n, vencidos, t, {}});
+}
+
+// Kernels vectoriales sobre los arreglos calientes, con y sin AVX2
+void benchKernels(size_t n) {
+    vector<int> restante(n);
+    vector<EstadoProceso> estado(n);
+    for (size_t i = 0; i < n; ++i) {
+        restante[i] = 1000000 + (int) (i % 977);
+        estado[i] = i % 8 == 7 ? EstadoProceso::Libre : EstadoProceso::Listo;
+    }
+
+    for (bool escalar : {false, true}) {
+        vectorial::forzarEscalar(escalar);
+        const string nombre = string("kernel/") + vectorial::implementacion();
+        const int repeticiones = 20;
+
+        double t = cronometrar([&] {
+            uint64_t suma = 0;
+            for (int r = 0; r < repeticiones; ++r)
+                suma += vectorial::minRestante(restante.data(), estado.data(), n, EstadoProceso::Listo);
+            sumidero = suma;
+        });
+        anotar({"micro", nombre + "/minRestante", n, n * repeticiones, t, {}});
+
+        t = cronometrar([&] {
+            for (int r = 0; r < repeticiones; ++r)
+                vectorial::avanzar(restante.data(), estado.data(), n, EstadoProceso::Listo, 1);
+        });
+        anotar({"micro", nombre + "/avanzar", n, n * repeticiones, t, {}});
+    }
+    vectorial::forzarEscalar(false);
+}
+
+void benchMemoria(int bloques) {
+    Memoria memoria(bloques);
+    const int rondas = 4;
+    double t = cronometrar([&] {
+        uint64_t suma = 0;
+        for (int r = 0; r < rondas; ++r) {
+            for (int i = 0; i < bloques; ++i) suma += memoria.asignar(1);
+            for (int i = 0; i < bloques; ++i) memoria.liberar(i, 1);
+        }
+        sumidero = suma;
+    });
+    anotar({"micro", "memoria/asignar+liberar", (uint64_t) bloques, 2ull * bloques * rondas, t, {}});
+}
+
+// La misma traza de asignaciones (tamanos log-uniformes de 1 a 256 paginas, vidas
+// aleatorias) contra cada ajuste del asignador por extensiones y contra el buddy.
+// Cuando la memoria se llena se liberan los bloques mas viejos hasta que el pedido entra.
+void benchTrazaMemoria(int paginas, size_t operaciones, uint64_t semilla) {
+    struct Pedido {
+        int cantidad;
+        size_t vida; // operaciones hasta liberarlo
+    };
+    mt19937_64 generador(semilla);
+    vector<Pedido> traza(operaciones);
+    for (Pedido& p : traza) {
+        p.cantidad = max(1, (int) exp2(uniform_real_distribution<double>(0.0, 8.0)(generador)));
+        p.vida = uniform_int_distribution<size_t>(1, 2000)(generador);
+    }
+
+    auto reproducir = [&](const string& nombre, auto&& asignar, auto&& liberar, auto&& extra) {
+        struct Vivo {
+            size_t vence;
+            int64_t inicio;
+            int cantidad;
+        };
+        multimap<size_t, size_t> vencimientos;
+        vector<Vivo> porIndice(traza.size());
+        vector<bool> liberado(traza.size(), false);
+        uint64_t desalojos = 0;
+        size_t viejo = 0; // el pedido vivo mas antiguo
+        double t = cronometrar([&] {
+            for (size_t i = 0; i < traza.size(); ++i) {
+                for (auto it = vencimientos.begin(); it != vencimientos.end() && it->first <= i;) {
+                    if (!liberado[it->second]) {
+                        liberar(porIndice[it->second].inicio, porIndice[it->second].cantidad);
+                        liberado[it->second] = true;
+                    }
+                    it = vencimientos.erase(it);
+                }
+                int64_t inicio;
+                while ((inicio = asignar(traza[i].cantidad)) < 0 && viejo < i) {
+                    if (!liberado[viejo]) {
+                        liberar(porIndice[viejo].inicio, porIndice[viejo].cantidad);
+                        liberado[viejo] = true;
+                        ++desalojos;
+                    }
+                    ++viejo;
+                }
+                porIndice[i] = {i + traza[i].vida, inicio, traza[i].cantidad};
+                liberado[i] = inicio < 0;
+                vencimientos.emplace(i + traza[i].vida, i);
+            }
+        });
+        auto r = extra();
+        r.push_back({"desalojos", (double) desalojos});
+        anotar({"micro", "memoria/traza/" + nombre, (uint64_t) paginas, traza.size(), t, r});
+    };
+
+    for (Ajuste ajuste : {Ajuste::Primero, Ajuste::Siguiente, Ajuste::Mejor, Ajuste::Peor}) {
+        Memoria memoria(paginas, ajuste);
+        reproducir(nombreAjuste(ajuste),
+                   [&](int c) { return (int64_t) memoria.asignar(c); },
+                   [&](int64_t inicio, int c) { memoria.liberar((int) inicio, c); },
+                   [&] { return vector<pair<string, double>>{{"frag_ext%", 100 * memoria.fragmentacionExterna()},
+                                                             {"frag_int%", 0.0}}; });
+    }
+    Buddy buddy(paginas);
+    reproducir("buddy",
+               [&](int c) { return buddy.asignar(c); },
+               [&](int64_t inicio, int c) { buddy.liberar(inicio, c); },
+               [&] { return vector<pair<string, double>>{{"frag_ext%", 100 * buddy.fragmentacionExterna()},
+                                                         {"frag_int%", 100 * buddy.fragmentacionInterna()}}; });
+}
+
+void benchBoundedBuffer(size_t elementos, int productores, int consumidores) {
+    BoundedBuffer<uint64_t> buffer(1024);
+    const size_t porProductor = elementos / productores;
+    const size_t total = porProductor * productores;
+    const size_t porConsumidor = total / consumidores;
+
+    double t = cronometrar([&] {
+        vector<thread> hilos;
+        for (int p = 0; p < productores; ++p)
+            hilos.emplace_back([&] { for (size_t i = 0; i < porProductor; ++i) buffer.produce(i); });
+        for (int c = 0; c < consumidores; ++c)
+            hilos.emplace_back([&, c] {
+                size_t cuantos = porConsumidor + (c == consumidores - 1 ? total % consumidores : 0);
+                uint64_t suma = 0;
+                for (size_t i = 0; i < cuantos; ++i) suma += buffer.consume();
+                sumidero = suma;
+            });
+        for (thread& h : hilos) h.join();
+    });
+    anotar({"micro", "bounded-buffer/" + to_string(productores) + "p" + to_string(consumidores) + "c",
+            total, total, t, {}});
+}
+
+void benchDirectorio(int entradas) {
+    Disk disco("bench");
+    Directory* raiz = disco.get_current_directory();
+    for (int i = 0; i < entradas; ++i) raiz->command("new d" + to_string(i), nullptr);
+
+    const int busquedas = 2000;
+    double t = cronometrar([&] {
+        for (int i = 0; i < busquedas; ++i) {
+            disco.go_to_path("d" + to_string((i * 7919) % entradas));
+            disco.go_to_path("..");
+        }
+    });
+    anotar({"micro", "directorio/buscar", (uint64_t) entradas, busquedas, t, {}});
+}
+
+// `n` PCB y `n` archivos vivos con reemplazos al azar (cada reemplazo libera uno y
+// crea otro), con los caches de slabs y con el heap. La memoria es la de los slabs en
+// uso o lo que el heap tiene entregado, con la poblacion completa.
+void benchObjetos(size_t n, uint64_t semilla) {
+    auto bytesSlabs = [] {
+        size_t total = 0;
+        for (const auto& e : slab::estadisticas()) total += e.bytesSlabs;
+        return total;
+    };
+    bool previo = slab::activo();
+    for (bool activo : {true, false}) {
+        slab::fijarActivo(activo);
+        vector<PCB*> procesos(n);
+        vector<File*> archivos(n);
+        mt19937_64 azar(semilla);
+        size_t antes = activo ? bytesSlabs() : mallinfo2().uordblks, lleno = 0;
+        double tCrear = cronometrar([&] {
+            for (size_t i = 0; i < n; ++i) {
+                procesos[i] = new PCB("p", 10);
+                archivos[i] = new File("f", "txt");
+            }
+        });
+        lleno = activo ? bytesSlabs() : mallinfo2().uordblks;
+        double tReemplazar = cronometrar([&] {
+            for (size_t i = 0; i < n; ++i) {
+                PCB*& proceso = procesos[azar() % n];
+                delete proceso;
+                proceso = new PCB("q", 5);
+                File*& archivo = archivos[azar() % n];
+                delete archivo;
+                archivo = new File("g", "txt");
+            }
+        });
+        double tBorrar = cronometrar([&] {
+            for (size_t i = 0; i < n; ++i) {
+                delete procesos[i];
+                delete archivos[i];
+            }
+        });
+        double porObjeto = (double) (lleno - antes) / (2.0 * n);
+        anotar({"micro", string("objetos/") + (activo ? "slab" : "heap"), n, 8ull * n, tCrear + tReemplazar + tBorrar,
+                {{"crear_ns", tCrear * 1e9 / (2.0 * n)},
+                 {"reemplazar_ns", tReemplazar * 1e9 / (2.0 * n)},
+                 {"borrar_ns", tBorrar * 1e9 / (2.0 * n)},
+                 {"bytes_por_objeto", porObjeto},
+                 {"sobrecarga_pct", 100.0 * (porObjeto / ((sizeof(PCB) + sizeof(File)) / 2.0) - 1.0)}}});
+    }
+    slab::fijarActivo(previo);
+}
+
+// Trazas de referencias de un proceso con 64 MiB mapeados: "local" recorre palabras
+// de 8 bytes seguidas y salta a otra pagina al azar cada ~512 referencias; "azar"
+// toca una pagina al azar en cada referencia. Una por una contra traducirLote.
+void benchTraduccion(size_t referencias, uint64_t semilla) {
+    const uint64_t base = 0x400000, paginas = 16384;
+    mt19937_64 azar(semilla);
+    for (const char* patron : {"local", "azar"}) {
+        vector<uint64_t> traza(referencias), fisicas(referencias);
+        uint64_t direccion = base;
+        for (uint64_t& d : traza) {
+            bool salto = patron[0] == 'a' || azar() % 512 == 0;
+            direccion = salto ? base + azar() % paginas * TAMANO_PAGINA + azar() % 512 * 8
+                              : base + (direccion + 8 - base) % (paginas * TAMANO_PAGINA);
+            d = direccion;
+        }
+        for (bool lote : {false, true}) {
+            MemoriaVirtual memoria(1 << 16);
+            memoria.crearEspacio(0);
+            memoria.mapear(0, base, paginas);
+            double t = cronometrar([&] {
+                if (lote) {
+                    memoria.traducirLote(0, traza.data(), fisicas.data(), traza.size());
+                } else {
+                    for (size_t i = 0; i < traza.size(); ++i) fisicas[i] = memoria.traducir(0, traza[i]);
+                }
+            });
+            sumidero = fisicas.back();
+            const TLB& tlb = memoria.tlb();
+            anotar({"micro", string("traducir/") + patron + (lote ? "/lote" : "/una"), paginas, referencias, t,
+                    {{"acierto_tlb_pct", 100.0 * tlb.aciertos() / max<uint64_t>(1, tlb.aciertos() + tlb.fallos())},
+                     {"recorridos", (double) memoria.recorridos()}}});
+        }
+    }
+}
+
+// ---------------------------------------------------------------- macro
+
+// Corre la carga completa hasta que terminan todos los procesos
+void escenario(Distribucion distribucion, size_t n, uint64_t semilla) {
+    vector<PCB> carga = generarCarga(distribucion, n, semilla);
+    long long servicio = 0;
+    for (const PCB& p : carga) servicio += p.tiempoEjecucion;
+
+    CPU cpu(5);
+    double tCarga = cronometrar([&] { for (const PCB& p : carga) cpu.add_process(p); });
+    double t = cronometrar([&] { cpu.ejecutar(servicio); });
+
+    Metricas m = cpu.estadisticas();
+    uint64_t cambios = 0;
+    for (uint64_t c : m.cambiosContexto) cambios += c;
+    anotar({"macro", "rr/" + nombreDistribucion(distribucion), n, (uint64_t) servicio, t,
+            {{"carga_s", tCarga},
+             {"terminados", (double) m.terminados},
+             {"retorno_p50", (double) m.retorno.percentil(0.50)},
+             {"retorno_p99", (double) m.retorno.percentil(0.99)},
+             {"respuesta_p99", (double) m.respuesta.percentil(0.99)},
+             {"cambios", (double) cambios}}});
+}
+
+// ---------------------------------------------------------------- salida
+
+string escaparCSV(const string& s) {
+    return s.find(',') == string::npos ? s : "\"" + s + "\"";
+}
+
+void volcarCSV(const string& archivo) {
+    ofstream out(archivo);
+    out << "grupo,nombre,n,operaciones,segundos,ns_por_op,extra\n";
+    for (const Resultado& r : resultados) {
+        out << r.grupo << "," << escaparCSV(r.nombre) << "," << r.n << "," << r.operaciones << ","
+            << setprecision(9) << r.segundos << "," << r.nsPorOperacion() << ",";
+        for (size_t i = 0; i < r.extra.size(); ++i)
+            out << (i ? ";" : "") << r.extra[i].first << "=" << r.extra[i].second;
+        out << "\n";
+    }
+}
+
+void volcarJSON(const string& archivo) {
+    ofstream out(archivo);
+    out << "{\"implementacion_vectorial\":\"" << vectorial::implementacion() << "\",\"resultados\":[";
+    for (size_t i = 0; i < resultados.size(); ++i) {
+        const Resultado& r = resultados[i];
+        out << (i ? "," : "") << "\n  {\"grupo\":\"" << r.grupo << "\",\"nombre\":\"" << r.nombre
+            << "\",\"n\":" << r.n << ",\"operaciones\":" << r.operaciones << ",\"segundos\":"
+            << setprecision(9) << r.segundos << ",\"ns_por_op\":" << r.nsPorOperacion();
+        for (auto& [clave, valor] : r.extra) out << ",\"" << clave << "\":" << valor;
+        out << "}";
+    }
+    out << "\n]}\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    string archivoCSV, archivoJSON;
+    size_t maximo = 1000000;
+    uint64_t semilla = 42;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--csv" && i + 1 < argc) archivoCSV = argv[++i];
+        else if (arg == "--json" && i + 1 < argc) archivoJSON = argv[++i];
+        else if (arg == "--max" && i + 1 < argc) maximo = stoull(argv[++i]);
+        else if (arg == "--semilla" && i + 1 < argc) semilla = stoull(argv[++i]);
+        else {
+            cerr << "Uso: " << argv[0] << " [--csv archivo] [--json archivo] [--max n] [--semilla s]\n";
+            return 1;
+        }
+    }
+
+    // La consola del planificador no debe medir nada
+    traza::fijarConsola(traza::Consola::Nada);
+
+    cout << "vectorial: " << vectorial::implementacion() << "\n";
+    cout << left << setw(6) << "grupo" << setw(34) << "nombre" << right << setw(9) << "n"
+         << setw(14) << "operaciones" << setw(12) << "segundos" << setw(12) << "ns/op" << "\n";
+
+    const size_t nMicro = min<size_t>(100000, maximo);
+    benchPolitica<politicas::FIFO>("fifo", nMicro);
+    benchPolitica<politicas::SJF>("sjf", nMicro);
+    benchPolitica<politicas::PrioridadO1>("o1", nMicro);
+    benchPolitica<politicas::CFS>("cfs", nMicro);
+    benchPolitica<politicas::Loteria>("loteria", nMicro);
+    benchPolitica<politicas::Stride>("stride", nMicro);
+    benchAvanceRapido(nMicro);
+    benchTemporizadores(min<size_t>(1000000, maximo * 10));
+    benchKernels(min<size_t>(10000000, maximo * 10));
+    benchMemoria(8192);
+    benchTrazaMemoria(1 << 17, min<size_t>(200000, maximo * 2), semilla);
+    benchBoundedBuffer(1000000, 1, 1);
+    benchBoundedBuffer(1000000, 4, 4);
+    benchDirectorio(2000);
+    benchObjetos(min<size_t>(1000000, maximo * 10), semilla);
+    benchTraduccion(min<size_t>(10000000, maximo * 100), semilla);
+
+    for (size_t n : {size_t(1000), size_t(100000), size_t(1000000)}) {
+        if (n > maximo) break;
+        for (Distribucion d : {Distribucion::Exponencial, Distribucion::Bimodal, Distribucion::ColaPesada})
+            escenario(d, n, semilla);
+    }
+
+    if (!archivoCSV.empty()) volcarCSV(archivoCSV);
+    if (!archivoJSON.empty()) volcarJSON(archivoJSON);
+    return 0;
+}
@@ -3,6 +3,10 @@
 #include "../modules/disk/disk.h"
 #include "../modules/cpu/pcb.h"
 #include "../modules/cpu/cpu.h"
+#include "../modules/cpu/traza.h"
+#include "../modules/snapshot/instantanea.h"
+#include "../modules/sweep/barrido.h"
+#include "../modules/mem/slab.h"
 
 vector<string> spltstring(const string &str, const string &delimiter) {
     std::vector<std::string> tokens;
@@ -18,10 +22,165 @@ vector<string> spltstring(const string &str, const string &delimiter) {
     return tokens;
 }
 
-int main() {
+// Kernel-Sim sweep [opciones]: barrido de parametros sobre una carga sintetica.
+// Las listas van separadas por comas, p. ej. --quantum 2,5,10 --nucleos 1,2,4
+// (o --tipos gggg,ggee,eeee con --dvfs, --colocacion y --umbral para comparar energia)
+int barrido(int argc, char* argv[]) {
+    Grilla grilla;
+    int hilos = 0;
+    string archivoCSV;
+    auto enteros = [](const string& lista) {
+        vector<int> valores;
+        for (const string& t : spltstring(lista, ",")) valores.push_back(stoi(t));
+        return valores;
+    };
+
+    try {
+        for (int i = 0; i < argc; ++i) {
+            string arg = argv[i];
+            string valor = i + 1 < argc ? argv[i + 1] : "";
+            if (valor.empty()) {
+                cout << "Falta el valor de " << arg << "\n";
+                return 1;
+            }
+            ++i;
+            if (arg == "--carga") {
+                auto distribucion = distribucionDesdeNombre(valor);
+                if (!distribucion) {
+                    cout << "Carga desconocida: " << valor << ". Usa exponencial, bimodal o colapesada.\n";
+                    return 1;
+                }
+                grilla.distribucion = *distribucion;
+            } else if (arg == "--procesos") {
+                grilla.procesos = stoull(valor);
+            } else if (arg == "--media") {
+                grilla.media = stod(valor);
+            } else if (arg == "--semillas") {
+                grilla.semillas.clear();
+                for (const string& t : spltstring(valor, ",")) grilla.semillas.push_back(stoull(t));
+            } else if (arg == "--politica") {
+                grilla.politicas.clear();
+                for (const string& t : spltstring(valor, ",")) {
+                    auto politica = planificacionDesdeNombre(t);
+                    if (!politica) {
+                        cout << "Politica desconocida: " << t << "\n";
+                        return 1;
+                    }
+                    grilla.politicas.push_back(*politica);
+                }
+            } else if (arg == "--quantum") {
+                grilla.quantums = enteros(valor);
+            } else if (arg == "--nucleos") {
+                grilla.nucleos = enteros(valor);
+            } else if (arg == "--tipos") {
+                grilla.tipos = spltstring(valor, ",");
+                for (const string& t : grilla.tipos) {
+                    if (!tiposDesdeTexto(t) || t == "e") {
+                        cout << "Tipos de nucleo invalidos: " << t << ". Usa g (grande) y e (eficiente), p. ej. ggee;"
+                                " con un nucleo solo vale g.\n";
+                        return 1;
+                    }
+                }
+            } else if (arg == "--dvfs") {
+                auto gobernador = gobernadorDesdeNombre(valor);
+                if (!gobernador) {
+                    cout << "Gobernador desconocido: " << valor << ". Usa rendimiento, ahorro o demanda.\n";
+                    return 1;
+                }
+                grilla.energia.gobernador = *gobernador;
+            } else if (arg == "--colocacion") {
+                auto colocacion = colocacionDesdeNombre(valor);
+                if (!colocacion) {
+                    cout << "Colocacion desconocida: " << valor << ". Usa rr o energia.\n";
+                    return 1;
+                }
+                grilla.energia.colocacion = *colocacion;
+            } else if (arg == "--umbral") {
+                grilla.energia.umbralCorta = stoi(valor);
+            } else if (arg == "--memoria") {
+                grilla.memorias = enteros(valor);
+            } else if (arg == "--paso") {
+                grilla.paso = stoll(valor);
+            } else if (arg == "--hilos") {
+                hilos = stoi(valor);
+            } else if (arg == "--csv") {
+                archivoCSV = valor;
+            } else {
+                cout << "Opcion desconocida: " << arg << "\n";
+                return 1;
+            }
+        }
+    } catch (const exception&) {
+        cout << "Valor inválido en la grilla.\n";
+        return 1;
+    }
+    for (int q : grilla.quantums)
+        if (q < 1) { cout << "El quantum debe ser positivo.\n"; return 1; }
+    for (int n : grilla.nucleos)
+        if (n < 1) { cout << "La cantidad de nucleos debe ser positiva.\n"; return 1; }
+    if (grilla.energia.umbralCorta < 1) {
+        cout << "El umbral de rafaga corta debe ser positivo.\n";
+        return 1;
+    }
+    if (grilla.paso < 1) {
+        cout << "El paso debe ser positivo.\n";
+        return 1;
+    }
+
+    // Sin consola de traza: los hilos del barrido no deben escribir nada
+    traza::fijarConsola(traza::Consola::Nada);
+    auto inicio = chrono::steady_clock::now();
+    vector<ResultadoBarrido> resultados = barrer(grilla, hilos);
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    imprimirBarrido(cout, resultados);
+    double secuencial = 0;
+    for (const ResultadoBarrido& r : resultados) secuencial += r.segundos;
+    cout << resultados.size() << " simulaciones en " << fixed << setprecision(3) << segundos << " s (suma de "
+         << secuencial << " s, aceleracion x" << setprecision(2) << (segundos > 0 ? secuencial / segundos : 0.0)
+         << ")\n";
+    if (!archivoCSV.empty()) {
+        ofstream salida(archivoCSV);
+        if (!salida) {
+            cout << "No se pudo escribir " << archivoCSV << ".\n";
+            return 1;
+        }
+        volcarBarridoCSV(salida, resultados);
+        cout << "Resultados escritos en " << archivoCSV << ".\n";
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "sweep")
+        return barrido(argc - 2, argv + 2);
+
+    // La politica de planificacion se elige al arrancar: Kernel-Sim [fifo|sjf|srtf|prioridad|rr|o1|cfs|loteria|stride] [nucleos]
+    // (o Kernel-Sim sweep ... para un barrido de parametros sin consola interactiva)
+    Planificacion planificacion = Planificacion::RoundRobin;
+    if (argc > 1) {
+        auto elegida = planificacionDesdeNombre(argv[1]);
+        if (!elegida) {
+            cout << "Politica desconocida: " << argv[1] << ". Usa fifo, sjf, srtf, prioridad, rr, o1, cfs, loteria o stride.\n";
+            return 1;
+        }
+        planificacion = *elegida;
+    }
+    int nucleos = 1;
+    if (argc > 2) {
+        nucleos = atoi(argv[2]);
+        if (nucleos < 1) {
+            cout << "Cantidad de nucleos inválida: " << argv[2] << "\n";
+            return 1;
+        }
+    }
 
     Disk disk("C");
-    CPU cpu(5);
+    CPU cpu(5, planificacion, nucleos);
+    cout << "Planificacion: " << nombrePlanificacion(cpu.planificacion());
+    if (cpu.nucleos() > 1)
+        cout << " (" << cpu.nucleos() << " nucleos, una cola por nucleo con robo de trabajo)";
+    cout << "\n";
 
     string input;
     while (true) {
@@ -39,15 +198,45 @@ int main() {
             cout << "  new nombre          - Crear directorio\n";
             cout << "  ls                  - Listar contenido\n";
             cout << "  edit nombre.ext     - Editar archivo/programa\n";
-            cout << "  run nombre          - Ejecutar proceso\n";
+            cout << "  run nombre [b]      - Ejecutar proceso con b boletos (loteria y stride; por defecto 100)\n";
             cout << "  kill nombre.ext     - Eliminar archivo\n";
             cout << "  kill nombre         - Eliminar directorio\n";
             cout << "  cd nombre           - Cambiar a subdirectorio\n";
             cout << "  cd ..               - Subir un nivel\n";
             cout << "  cd /                - Ir a raíz\n";
             cout << "  pwd                 - Mostrar ruta actual\n";
-            cout << "  tick n              - Avanzar n ticks\n";
-            cout << "  ps                  - Mostrar procesos/programas en ejecucion\n";
+            cout << "  tick n              - Avanzar n ticks (salta directo entre eventos)\n";
+            cout << "  tick n -v           - Avanzar n ticks mostrando cada rebanada\n";
+            cout << "  trace on|off        - Grabar/detener la traza binaria de eventos\n";
+            cout << "  trace dump archivo  - Escribir la traza grabada en un archivo binario\n";
+            cout << "  stats               - Percentiles de retorno, espera y respuesta\n";
+            cout << "  stats json archivo  - Volcar las estadisticas en JSON\n";
+            cout << "  slab on|off         - Crear PCB, archivos y directorios en caches de slabs o en el heap\n";
+            cout << "  rt                  - Tareas de tiempo real: plazos perdidos por tarea\n";
+            cout << "  rt edf|rm           - Elegir EDF o rate monotonic para la clase de tiempo real\n";
+            cout << "  timers              - Procesos dormidos y temporizadores pendientes\n";
+            cout << "  quantum [n]         - Ver el quantum o fijarlo en n ticks\n";
+            cout << "  quantum auto [p]    - Quantum adaptativo: percentil p (por defecto 80) de las rafagas\n";
+            cout << "  switch [f c v w]    - Costo de cambio: f ticks fijos, c de cache fria (vida media v),\n";
+            cout << "                        despacho por afinidad entre w candidatos; switch 0 0 lo apaga\n";
+            cout << "  cfs                 - Rebanadas de CFS: latencia objetivo y granularidad minima\n";
+            cout << "  cfs gran n [lat m]  - Granularidad minima n y latencia objetivo m (ticks, n <= m)\n";
+            cout << "  cgroup              - Grupos de control: cuota, peso y consumo de cada grupo\n";
+            cout << "  cgroup new g [p]    - Crear el grupo g dentro de p (por defecto la raiz)\n";
+            cout << "  cgroup quota g c p  - Limitar g a c ticks de CPU cada p ticks (c = 0: sin limite)\n";
+            cout << "  cgroup weight g w   - Peso de g frente a sus hermanos (1024 = normal)\n";
+            cout << "  cgroup use g        - Los procesos que se ejecuten desde ahora van a g\n";
+            cout << "  energy              - Energia por nucleo: tipo, frecuencia y joules consumidos\n";
+            cout << "  energy cores t      - Tipo de cada nucleo: g grande, e eficiente (p. ej. ggee)\n";
+            cout << "  energy dvfs g       - Gobernador de frecuencia: rendimiento, ahorro o demanda\n";
+            cout << "  energy place p [u]  - Colocacion: rr, o energia (rafagas de hasta u ticks a eficientes)\n";
+            cout << "  vm                  - Memoria virtual: espacios, marcos y aciertos del TLB\n";
+            cout << "  vm map pid dir n    - Mapear n paginas desde la direccion virtual dir (p. ej. 0x400000)\n";
+            cout << "  vm unmap pid dir n  - Liberar n paginas desde dir\n";
+            cout << "  vm tr pid dir       - Traducir dir a direccion fisica (pid como lo muestra ps, p. ej. 3:0)\n";
+            cout << "  save archivo        - Guardar el estado completo en una instantanea binaria\n";
+            cout << "  load archivo        - Restaurar una instantanea (politica y nucleos incluidos)\n";
+            cout << "  ps                  - Mostrar procesos/programas en ejecucion (por nucleo)\n";
             cout << "  exit                - Salir\n";
             continue;
         }
@@ -63,6 +252,279 @@ int main() {
             continue;
         }
 
+        if (input == "trace" || input.rfind("trace ", 0) == 0) {
+            stringstream ss(input.substr(5));
+            string opcion, archivo;
+            ss >> opcion >> archivo;
+            if (opcion == "on") {
+                traza::iniciar();
+                cout << "Traza activada.\n";
+            } else if (opcion == "off") {
+                traza::detener();
+                cout << "Traza detenida (" << traza::registrados() << " eventos, "
+                     << traza::perdidos() << " perdidos).\n";
+            } else if (opcion == "dump" && !archivo.empty()) {
+                if (traza::volcar(archivo))
+                    cout << "Traza escrita en " << archivo << " (" << traza::registrados() << " eventos).\n";
+                else
+                    cout << "No hay traza grabada o no se pudo escribir " << archivo << ".\n";
+            } else {
+                cout << "Uso: trace on|off|dump archivo\n";
+            }
+            continue;
+        }
+
+        if (input == "slab on" || input == "slab off") {
+            slab::fijarActivo(input == "slab on");
+            cout << (slab::activo() ? "Objetos del nucleo en caches de slabs.\n" : "Objetos del nucleo en el heap.\n");
+            continue;
+        }
+
+        if (input == "stats" || input.rfind("stats ", 0) == 0) {
+            stringstream ss(input.substr(5));
+            string formato, archivo;
+            ss >> formato >> archivo;
+            Metricas metricas = cpu.estadisticas();
+            if (formato.empty()) {
+                metricas.imprimir(cout, cpu.reloj());
+                slab::imprimir(cout);
+            } else if (formato == "json" && !archivo.empty()) {
+                ofstream salida(archivo);
+                if (!salida) {
+                    cout << "No se pudo escribir " << archivo << ".\n";
+                    continue;
+                }
+                metricas.volcarJSON(salida, cpu.reloj());
+                cout << "Estadisticas escritas en " << archivo << ".\n";
+            } else {
+                cout << "Uso: stats [json archivo]\n";
+            }
+            continue;
+        }
+
+        if (input == "rt" || input.rfind("rt ", 0) == 0) {
+            stringstream ss(input.substr(2));
+            string nombre;
+            if (ss >> nombre) {
+                auto modo = modoTiempoRealDesdeNombre(nombre);
+                if (!modo) {
+                    cout << "Modo inválido. Usa: rt edf|rm\n";
+                    continue;
+                }
+                if (cpu.nucleos() > 1) {
+                    cout << "La clase de tiempo real solo existe con un nucleo.\n";
+                    continue;
+                }
+                if (!cpu.fijarModoTiempoReal(*modo)) {
+                    cout << "Las tareas admitidas superan la cota de utilizacion de " << nombre
+                         << ": el modo no cambia.\n";
+                    continue;
+                }
+            }
+            cpu.listarTiempoReal();
+            continue;
+        }
+
+        if (input == "quantum" || input.rfind("quantum ", 0) == 0) {
+            stringstream ss(input.substr(7));
+            string opcion;
+            if (ss >> opcion) {
+                try {
+                    if (opcion == "auto") {
+                        int percentil = 80;
+                        ss >> percentil;
+                        if (percentil < 1 || percentil > 99) {
+                            cout << "El percentil debe estar entre 1 y 99.\n";
+                            continue;
+                        }
+                        cpu.activarQuantumAdaptativo(percentil / 100.0, 1, 1000);
+                    } else {
+                        int q = stoi(opcion);
+                        if (q < 1) {
+                            cout << "El quantum debe ser positivo.\n";
+                            continue;
+                        }
+                        cpu.fijarQuantum(q);
+                    }
+                } catch (const exception&) {
+                    cout << "Uso: quantum [n | auto [percentil]]\n";
+                    continue;
+                }
+            }
+            cpu.listarQuantum();
+            continue;
+        }
+
+        if (input == "switch" || input.rfind("switch ", 0) == 0) {
+            stringstream ss(input.substr(6));
+            CostoCambio modelo;
+            if (ss >> modelo.fijo) {
+                if (!(ss >> modelo.cacheFria)) {
+                    cout << "Uso: switch [fijo cacheFria [vidaMedia [ventana]]]\n";
+                    continue;
+                }
+                ss >> modelo.vidaMedia >> modelo.ventana;
+                if (modelo.fijo < 0 || modelo.cacheFria < 0 || modelo.vidaMedia < 1 || modelo.ventana < 1) {
+                    cout << "Los costos no pueden ser negativos; vida media y ventana al menos 1.\n";
+                    continue;
+                }
+                cpu.fijarCostoCambio(modelo);
+            }
+            cpu.listarCostoCambio();
+            continue;
+        }
+
+        if (input == "cfs" || input.rfind("cfs ", 0) == 0) {
+            stringstream ss(input.substr(3));
+            string opcion;
+            if (ss >> opcion) {
+                int granularidad = 0, latencia = 0;
+                string etiqueta;
+                optional<int> nuevaLatencia;
+                if (opcion != "gran" || !(ss >> granularidad)) {
+                    cout << "Uso: cfs [gran n [lat m]]\n";
+                    continue;
+                }
+                if (ss >> etiqueta) {
+                    if (etiqueta != "lat" || !(ss >> latencia)) {
+                        cout << "Uso: cfs [gran n [lat m]]\n";
+                        continue;
+                    }
+                    nuevaLatencia = latencia;
+                }
+                if (!cpu.fijarRebanadasCFS(granularidad, nuevaLatencia)) {
+                    cout << "No se pudo: la politica no es CFS o no 1 <= n <= m.\n";
+                    continue;
+                }
+            }
+            cpu.listarCFS();
+            continue;
+        }
+
+        if (input == "cgroup" || input.rfind("cgroup ", 0) == 0) {
+            stringstream ss(input.substr(6));
+            string opcion, nombre;
+            ss >> opcion >> nombre;
+            bool hecho = true;
+            if (opcion == "new" && !nombre.empty()) {
+                string padre = "raiz";
+                ss >> padre;
+                hecho = cpu.crearGrupo(nombre, padre);
+            } else if (opcion == "quota" && !nombre.empty()) {
+                long long cuota = -1, periodo = 0;
+                ss >> cuota >> periodo;
+                hecho = cpu.fijarCuotaGrupo(nombre, cuota, periodo);
+            } else if (opcion == "weight" && !nombre.empty()) {
+                int peso = 0;
+                ss >> peso;
+                hecho = cpu.fijarPesoGrupo(nombre, peso);
+            } else if (opcion == "use" && !nombre.empty()) {
+                hecho = cpu.usarGrupo(nombre);
+            } else if (!opcion.empty()) {
+                cout << "Uso: cgroup [new g [padre] | quota g cuota periodo | weight g peso | use g]\n";
+                continue;
+            }
+            if (!hecho) {
+                cout << "No se pudo: el grupo no existe (o ya existe), los valores no valen"
+                        " (0 <= cuota <= periodo, peso >= 1) o la CPU tiene varios nucleos.\n";
+                continue;
+            }
+            cpu.listarGrupos();
+            continue;
+        }
+
+        if (input == "energy" || input.rfind("energy ", 0) == 0) {
+            stringstream ss(input.substr(6));
+            string opcion, valor;
+            ss >> opcion >> valor;
+            ConfigEnergia config = cpu.configEnergia();
+            bool hecho = true;
+            if (opcion == "cores" && !valor.empty()) {
+                auto tipos = tiposDesdeTexto(valor);
+                hecho = tipos && cpu.fijarTiposNucleo(*tipos);
+            } else if (opcion == "dvfs" && gobernadorDesdeNombre(valor)) {
+                config.gobernador = *gobernadorDesdeNombre(valor);
+                hecho = cpu.fijarEnergia(config);
+            } else if (opcion == "place" && colocacionDesdeNombre(valor)) {
+                config.colocacion = *colocacionDesdeNombre(valor);
+                ss >> config.umbralCorta;
+                hecho = config.umbralCorta >= 1 && cpu.fijarEnergia(config);
+            } else if (!opcion.empty()) {
+                cout << "Uso: energy [cores ggee | dvfs rendimiento|ahorro|demanda | place rr|energia [umbral]]\n";
+                continue;
+            }
+            if (!hecho) {
+                cout << "No se pudo: la CPU tiene un solo nucleo, la cantidad de tipos no coincide"
+                        " con la de nucleos o el umbral no es positivo.\n";
+                continue;
+            }
+            cpu.listarEnergia();
+            continue;
+        }
+
+        if (input == "vm" || input.rfind("vm ", 0) == 0) {
+            stringstream ss(input.substr(2));
+            string opcion, textoPid, textoDireccion;
+            uint64_t paginas = 0;
+            ss >> opcion >> textoPid >> textoDireccion >> paginas;
+            if (opcion.empty()) {
+                cpu.memoriaVirtual().imprimir(cout);
+                continue;
+            }
+            Pid pid;
+            char* fin = nullptr;
+            uint64_t direccion = strtoull(textoDireccion.c_str(), &fin, 0);
+            bool valido = sscanf(textoPid.c_str(), "%u:%u", &pid.indice, &pid.generacion) == 2
+                          && !textoDireccion.empty() && *fin == '\0';
+            if (valido && opcion == "map" && paginas > 0) {
+                if (cpu.mapear(pid, direccion, paginas))
+                    cout << paginas << " paginas mapeadas para " << pid << ".\n";
+                else
+                    cout << "No se pudo: el proceso no existe, alguna pagina ya esta mapeada o no hay marcos.\n";
+            } else if (valido && opcion == "unmap" && paginas > 0) {
+                cout << cpu.desmapear(pid, direccion, paginas) << " paginas liberadas.\n";
+            } else if (valido && opcion == "tr") {
+                uint64_t fisica = cpu.traducir(pid, direccion);
+                if (fisica == SIN_TRADUCCION)
+                    cout << "Fallo de pagina: " << textoDireccion << " no esta mapeada para " << pid << ".\n";
+                else
+                    cout << textoDireccion << " -> 0x" << hex << fisica << dec << "\n";
+            } else {
+                cout << "Uso: vm [map|unmap pid dir paginas | tr pid dir]\n";
+            }
+            continue;
+        }
+
+        if (input == "timers") {
+            cpu.listarTemporizadores();
+            continue;
+        }
+
+        if (input.rfind("save ", 0) == 0 || input.rfind("load ", 0) == 0) {
+            stringstream ss(input.substr(5));
+            string archivo, error;
+            ss >> archivo;
+            if (archivo.empty()) {
+                cout << "Uso: save|load archivo\n";
+                continue;
+            }
+            if (input[0] == 's') {
+                if (instantanea::guardar(archivo, cpu, disk, nullptr, error))
+                    cout << "Instantanea escrita en " << archivo << " (" << cpu.procesos().vivos()
+                         << " procesos, reloj " << cpu.reloj() << ").\n";
+                else
+                    cout << "No se pudo guardar: " << error << "\n";
+            } else {
+                if (instantanea::cargar(archivo, cpu, disk, nullptr, error))
+                    cout << "Instantanea cargada: " << nombrePlanificacion(cpu.planificacion()) << ", "
+                         << cpu.nucleos() << " nucleo(s), " << cpu.procesos().vivos()
+                         << " procesos, reloj " << cpu.reloj() << ".\n";
+                else
+                    cout << "No se pudo cargar: " << error << "\n";
+            }
+            continue;
+        }
+
         if (input == "ps") {
             cpu.listarProcesos();
             continue;
@@ -100,11 +562,52 @@ int main() {
                         file->edit_content(nuevoContenido);
                         cout << "Archivo editado correctamente.\n";
                     } else if (file->get_extension() == "exe") {
-                        cout << "Ingresa el nuevo tiempo de ejecución del proceso:\n";
-                        int tiempo;
-                        cin >> tiempo;
-                        cin.ignore(); // Limpiar el buffer
-                        PCB* nuevoPCB = new PCB(file->get_name(), tiempo);
+                        cout << "Ingresa el nuevo tiempo de ejecución del proceso [prioridad [nice]]:\n";
+                        cout << "(rafagas CPU,E/S,CPU,... separadas por comas, p. ej. 5,10,3; con prefijo\n"
+                                " c/e/s se elige CPU, E/S o sleep, p. ej. 5,s20,3;\n"
+                                " o 'rt periodo wcet [plazo]' para una tarea periodica de tiempo real)\n";
+                        string linea, tiempos;
+                        getline(cin, linea);
+                        stringstream ss(linea);
+                        int prioridad = 0, nice = 0;
+                        vector<Rafaga> rafagas;
+                        ss >> tiempos;
+                        if (tiempos == "rt") {
+                            int periodo = 0, wcet = 0, plazo = 0;
+                            ss >> periodo >> wcet >> plazo;
+                            if (periodo <= 0 || wcet <= 0 || plazo < 0) {
+                                cout << "Tarea periodica inválida.\n";
+                                break;
+                            }
+                            PCB* nuevoPCB = new PCB(file->get_name(), wcet);
+                            nuevoPCB->periodo = periodo;
+                            nuevoPCB->plazo = plazo;
+                            file->edit_content(nuevoPCB);
+                            cout << "Tarea periodica editada correctamente.\n";
+                            break;
+                        }
+                        try {
+                            for (string t : spltstring(tiempos, ",")) {
+                                // Sin prefijo se alternan CPU y E/S por posicion
+                                TipoRafaga tipo = rafagas.size() % 2 == 0 ? TipoRafaga::CPU : TipoRafaga::ES;
+                                if (!t.empty() && (t[0] == 'c' || t[0] == 'e' || t[0] == 's')) {
+                                    tipo = t[0] == 'c' ? TipoRafaga::CPU : t[0] == 'e' ? TipoRafaga::ES : TipoRafaga::Dormir;
+                                    t = t.substr(1);
+                                }
+                                rafagas.push_back({tipo, stoi(t)});
+                            }
+                        } catch (const exception&) {
+                            rafagas.clear();
+                        }
+                        if (rafagas.empty() || rafagas[0].duracion <= 0) {
+                            cout << "Tiempo inválido.\n";
+                            break;
+                        }
+                        ss >> prioridad >> nice;
+                        PCB* nuevoPCB = new PCB(file->get_name(), rafagas[0].duracion, prioridad);
+                        if (rafagas.size() > 1)
+                            nuevoPCB->fijarRafagas(rafagas);
+                        nuevoPCB->nice = nice;
                         file->edit_content(nuevoPCB);
                         cout << "Proceso editado correctamente.\n";
                     } else {
@@ -135,7 +638,7 @@ int main() {
 
         if (input.rfind("run ", 0) == 0) {
             string arg = input.substr(4);
-            cout << current->command("run " + arg, cpu) << "\n";
+            cout << current->command("run " + arg, &cpu) << "\n";
             continue;
         }
 
@@ -146,8 +649,15 @@ int main() {
         }
 
         if (input.rfind("tick ", 0) == 0) {
-            string arg = input.substr(5);
-            cpu.ejecutarRoundRobin(stoi(arg)); //Ahora se ejecutara dependiendo de cuantos ticks le ingrese el usuario
+            stringstream ss(input.substr(5));
+            long long ticks;
+            string opcion;
+            if (!(ss >> ticks) || ticks <= 0) {
+                cout << "Formato inválido. Usa: tick n [-v] (n > 0)\n";
+                continue;
+            }
+            ss >> opcion;
+            cpu.ejecutar(ticks, opcion == "-v"); //Ahora se ejecutara dependiendo de cuantos ticks le ingrese el usuario
             continue;
         }
 
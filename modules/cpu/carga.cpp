@@ -0,0 +1,67 @@
+#include "carga.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+    // Uniforme en (0, 1] a partir de los 53 bits altos
+    double uniforme(mt19937_64& generador) {
+        return ((generador() >> 11) + 1) * (1.0 / 9007199254740992.0);
+    }
+
+    double exponencial(mt19937_64& generador, double media) {
+        return -media * log(uniforme(generador));
+    }
+
+    // Pareto acotada en [minimo, maximo] por inversion de la CDF
+    double paretoAcotada(mt19937_64& generador, double alfa, double minimo, double maximo) {
+        double u = uniforme(generador);
+        double la = pow(minimo, alfa);
+        double ha = pow(maximo, alfa);
+        return pow(-(u * ha - u * la - ha) / (ha * la), -1.0 / alfa);
+    }
+}
+
+optional<Distribucion> distribucionDesdeNombre(const string& nombre) {
+    if (nombre == "exponencial") return Distribucion::Exponencial;
+    if (nombre == "bimodal") return Distribucion::Bimodal;
+    if (nombre == "colapesada") return Distribucion::ColaPesada;
+    return nullopt;
+}
+
+string nombreDistribucion(Distribucion distribucion) {
+    switch (distribucion) {
+        case Distribucion::Exponencial: return "exponencial";
+        case Distribucion::Bimodal: return "bimodal";
+        case Distribucion::ColaPesada: return "colapesada";
+    }
+    return "?";
+}
+
+vector<PCB> generarCarga(Distribucion distribucion, size_t n, uint64_t semilla, double media) {
+    mt19937_64 generador(semilla);
+    vector<PCB> carga;
+    carga.reserve(n);
+
+    // Pareto con alfa 1.5: la media es 3*minimo, asi que minimo = media/3
+    const double alfa = 1.5;
+    const double minimoPareto = max(1.0, media / 3.0);
+
+    for (size_t i = 0; i < n; ++i) {
+        double rafaga = 0;
+        switch (distribucion) {
+            case Distribucion::Exponencial:
+                rafaga = exponencial(generador, media);
+                break;
+            case Distribucion::Bimodal:
+                rafaga = uniforme(generador) < 0.8 ? exponencial(generador, media / 4)
+                                                  : exponencial(generador, media * 4);
+                break;
+            case Distribucion::ColaPesada:
+                rafaga = paretoAcotada(generador, alfa, minimoPareto, media * 100);
+                break;
+        }
+        carga.emplace_back("p" + to_string(i), max(1, (int) llround(rafaga)));
+    }
+    return carga;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "pcb.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Generadores de carga sinteticos y deterministas: la misma semilla produce la
+// misma carga en cualquier plataforma (mt19937_64 + transformadas propias, sin
+// depender de las distribuciones de la biblioteca estandar).
+enum class Distribucion { Exponencial, Bimodal, ColaPesada };
+
+optional<Distribucion> distribucionDesdeNombre(const string& nombre);
+string nombreDistribucion(Distribucion distribucion);
+
+// n programas con rafagas de CPU de media ~`media` ticks (minimo 1).
+//  - Exponencial: rafagas exponenciales.
+//  - Bimodal: 80% rafagas cortas (media/4) y 20% largas (4*media).
+//  - ColaPesada: Pareto acotada (alfa 1.5), tope de 100 veces la media.
+vector<PCB> generarCarga(Distribucion distribucion, size_t n, uint64_t semilla, double media = 50.0);
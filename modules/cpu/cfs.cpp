@@ -0,0 +1,307 @@
+#include "cfs.h"
+#include "../snapshot/instantanea.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace politicas {
+
+namespace {
+    // Misma tabla que el kernel de Linux: cada nivel de nice cambia el peso ~25%
+    const int PESOS[40] = {
+        88761, 71755, 56483, 46273, 36291,
+        29154, 23254, 18705, 14949, 11916,
+         9548,  7620,  6100,  4904,  3906,
+         3121,  2501,  1991,  1586,  1277,
+         1024,   820,   655,   526,   423,
+          335,   272,   215,   172,   137,
+          110,    87,    70,    56,    45,
+           36,    29,    23,    18,    15,
+    };
+
+    // vruntime se lleva en 1/2^20 de tick ponderado para no perder precision con pesos altos
+    constexpr long long ESCALA_VRUNTIME = 1024LL * 1024;
+}
+
+int pesoNice(int nice) {
+    return PESOS[clamp(nice, -20, 19) + 20];
+}
+
+void CFS::encolar(PCB* proceso) {
+    // Un proceso nuevo (o que estuvo fuera) no puede reclamar el tiempo que no estuvo presente
+    proceso->vruntime = max(proceso->vruntime, minVruntime);
+    insertar(proceso);
+    ++total;
+    pesoTotal += pesoNice(proceso->nice);
+}
+
+PCB* CFS::siguiente() {
+    PCB* proceso = izquierdo;
+    borrar(proceso);
+    --total;
+    pesoTotal -= pesoNice(proceso->nice);
+    return proceso;
+}
+
+int CFS::rebanada(const PCB& proceso, int) const {
+    // El proceso ya salio del arbol: su peso no esta en pesoTotal
+    long long peso = pesoNice(proceso.nice);
+    long long parte = latenciaObjetivo * peso / (pesoTotal + peso);
+    return (int) max<long long>(granularidadMinima, parte);
+}
+
+void CFS::contabilizar(PCB& proceso, int ticks) {
+    proceso.vruntime += ticks * ESCALA_VRUNTIME / pesoNice(proceso.nice);
+
+    long long candidato = proceso.vruntime;
+    if (izquierdo)
+        candidato = min(candidato, izquierdo->vruntime);
+    minVruntime = max(minVruntime, candidato);
+}
+
+bool CFS::fijarRebanadas(int granularidad, int latencia) {
+    if (granularidad < 1 || latencia < granularidad)
+        return false;
+    granularidadMinima = granularidad;
+    latenciaObjetivo = latencia;
+    return true;
+}
+
+void CFS::guardar(instantanea::Escritor& escritor) const {
+    vector<uint32_t> indices;
+    indices.reserve(total);
+    recorrer([&](PCB* p) { indices.push_back(TablaProcesos::indiceDe(p)); });
+    escritor.arreglo(indices);
+    escritor.valor(minVruntime);
+    escritor.valor(latenciaObjetivo);
+    escritor.valor(granularidadMinima);
+}
+
+void CFS::cargar(instantanea::Lector& lector, TablaProcesos& tabla) {
+    raiz = izquierdo = nullptr;
+    total = 0;
+    pesoTotal = 0;
+    // vruntime viene en cada PCB; insertar en orden conserva los empates
+    for (uint32_t indice : lector.vista<uint32_t>()) {
+        PCB* proceso = tabla.ranura(indice);
+        insertar(proceso);
+        ++total;
+        pesoTotal += pesoNice(proceso->nice);
+    }
+    minVruntime = lector.valor<long long>();
+    int latencia = lector.valor<int>();
+    if (!fijarRebanadas(lector.valor<int>(), latencia))
+        throw runtime_error("rebanadas de CFS invalidas");
+}
+
+// Arbol rojo-negro intrusivo
+
+PCB* CFS::sucesor(PCB* nodo) {
+    if (nodo->rbDer) {
+        nodo = nodo->rbDer;
+        while (nodo->rbIzq) nodo = nodo->rbIzq;
+        return nodo;
+    }
+    PCB* padre = nodo->rbPadre;
+    while (padre && nodo == padre->rbDer) {
+        nodo = padre;
+        padre = padre->rbPadre;
+    }
+    return padre;
+}
+
+void CFS::insertar(PCB* nodo) {
+    nodo->rbIzq = nodo->rbDer = nullptr;
+    nodo->rbRojo = true;
+
+    PCB* padre = nullptr;
+    PCB** enlace = &raiz;
+    bool masIzquierdo = true;
+    // Con vruntime igual se inserta a la derecha: a igualdad gana el que llego primero
+    while (*enlace) {
+        padre = *enlace;
+        if (nodo->vruntime < padre->vruntime) {
+            enlace = &padre->rbIzq;
+        } else {
+            enlace = &padre->rbDer;
+            masIzquierdo = false;
+        }
+    }
+    nodo->rbPadre = padre;
+    *enlace = nodo;
+    if (masIzquierdo)
+        izquierdo = nodo;
+
+    arreglarInsercion(nodo);
+}
+
+void CFS::arreglarInsercion(PCB* z) {
+    while (esRojo(z->rbPadre)) {
+        PCB* padre = z->rbPadre;
+        PCB* abuelo = padre->rbPadre; // el padre es rojo, asi que no es la raiz
+        if (padre == abuelo->rbIzq) {
+            PCB* tio = abuelo->rbDer;
+            if (esRojo(tio)) {
+                padre->rbRojo = tio->rbRojo = false;
+                abuelo->rbRojo = true;
+                z = abuelo;
+                continue;
+            }
+            if (z == padre->rbDer) {
+                z = padre;
+                rotarIzquierda(z);
+                padre = z->rbPadre;
+            }
+            padre->rbRojo = false;
+            abuelo->rbRojo = true;
+            rotarDerecha(abuelo);
+        } else {
+            PCB* tio = abuelo->rbIzq;
+            if (esRojo(tio)) {
+                padre->rbRojo = tio->rbRojo = false;
+                abuelo->rbRojo = true;
+                z = abuelo;
+                continue;
+            }
+            if (z == padre->rbIzq) {
+                z = padre;
+                rotarDerecha(z);
+                padre = z->rbPadre;
+            }
+            padre->rbRojo = false;
+            abuelo->rbRojo = true;
+            rotarIzquierda(abuelo);
+        }
+    }
+    raiz->rbRojo = false;
+}
+
+void CFS::borrar(PCB* z) {
+    if (z == izquierdo)
+        izquierdo = sucesor(z);
+
+    PCB* hijo;
+    PCB* padre;
+    bool eraRojo = z->rbRojo;
+
+    if (!z->rbIzq) {
+        hijo = z->rbDer;
+        padre = z->rbPadre;
+        trasplantar(z, z->rbDer);
+    } else if (!z->rbDer) {
+        hijo = z->rbIzq;
+        padre = z->rbPadre;
+        trasplantar(z, z->rbIzq);
+    } else {
+        PCB* y = z->rbDer;
+        while (y->rbIzq) y = y->rbIzq;
+        eraRojo = y->rbRojo;
+        hijo = y->rbDer;
+        if (y->rbPadre == z) {
+            padre = y;
+        } else {
+            padre = y->rbPadre;
+            trasplantar(y, y->rbDer);
+            y->rbDer = z->rbDer;
+            y->rbDer->rbPadre = y;
+        }
+        trasplantar(z, y);
+        y->rbIzq = z->rbIzq;
+        y->rbIzq->rbPadre = y;
+        y->rbRojo = z->rbRojo;
+    }
+
+    z->rbPadre = z->rbIzq = z->rbDer = nullptr;
+    if (!eraRojo)
+        arreglarBorrado(hijo, padre);
+}
+
+void CFS::arreglarBorrado(PCB* x, PCB* padre) {
+    while (x != raiz && !esRojo(x)) {
+        if (x == padre->rbIzq) {
+            PCB* hermano = padre->rbDer;
+            if (esRojo(hermano)) {
+                hermano->rbRojo = false;
+                padre->rbRojo = true;
+                rotarIzquierda(padre);
+                hermano = padre->rbDer;
+            }
+            if (!esRojo(hermano->rbIzq) && !esRojo(hermano->rbDer)) {
+                hermano->rbRojo = true;
+                x = padre;
+                padre = x->rbPadre;
+            } else {
+                if (!esRojo(hermano->rbDer)) {
+                    hermano->rbIzq->rbRojo = false;
+                    hermano->rbRojo = true;
+                    rotarDerecha(hermano);
+                    hermano = padre->rbDer;
+                }
+                hermano->rbRojo = padre->rbRojo;
+                padre->rbRojo = false;
+                hermano->rbDer->rbRojo = false;
+                rotarIzquierda(padre);
+                x = raiz;
+            }
+        } else {
+            PCB* hermano = padre->rbIzq;
+            if (esRojo(hermano)) {
+                hermano->rbRojo = false;
+                padre->rbRojo = true;
+                rotarDerecha(padre);
+                hermano = padre->rbIzq;
+            }
+            if (!esRojo(hermano->rbIzq) && !esRojo(hermano->rbDer)) {
+                hermano->rbRojo = true;
+                x = padre;
+                padre = x->rbPadre;
+            } else {
+                if (!esRojo(hermano->rbIzq)) {
+                    hermano->rbDer->rbRojo = false;
+                    hermano->rbRojo = true;
+                    rotarIzquierda(hermano);
+                    hermano = padre->rbIzq;
+                }
+                hermano->rbRojo = padre->rbRojo;
+                padre->rbRojo = false;
+                hermano->rbIzq->rbRojo = false;
+                rotarDerecha(padre);
+                x = raiz;
+            }
+        }
+    }
+    if (x)
+        x->rbRojo = false;
+}
+
+void CFS::trasplantar(PCB* viejo, PCB* nuevo) {
+    if (!viejo->rbPadre)
+        raiz = nuevo;
+    else if (viejo == viejo->rbPadre->rbIzq)
+        viejo->rbPadre->rbIzq = nuevo;
+    else
+        viejo->rbPadre->rbDer = nuevo;
+    if (nuevo)
+        nuevo->rbPadre = viejo->rbPadre;
+}
+
+void CFS::rotarIzquierda(PCB* x) {
+    PCB* y = x->rbDer;
+    x->rbDer = y->rbIzq;
+    if (y->rbIzq)
+        y->rbIzq->rbPadre = x;
+    trasplantar(x, y);
+    y->rbIzq = x;
+    x->rbPadre = y;
+}
+
+void CFS::rotarDerecha(PCB* x) {
+    PCB* y = x->rbIzq;
+    x->rbIzq = y->rbDer;
+    if (y->rbDer)
+        y->rbDer->rbPadre = x;
+    trasplantar(x, y);
+    y->rbDer = x;
+    x->rbPadre = y;
+}
+
+} // namespace politicas
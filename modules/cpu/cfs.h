@@ -0,0 +1,65 @@
+#pragma once
+#include "pcb.h"
+#include "tabla_procesos.h"
+#include <cstddef>
+
+using namespace std;
+
+namespace politicas {
+
+// Planificador completamente justo (estilo CFS): los procesos listos se ordenan por
+// tiempo virtual de ejecucion en un arbol rojo-negro intrusivo embebido en el PCB,
+// por lo que encolar no reserva memoria. El mas a la izquierda se mantiene en cache,
+// asi que elegir es O(1) y retirar/encolar O(log n).
+//
+// Cada proceso avanza su vruntime en proporcion inversa a su peso (derivado de nice),
+// y su rebanada es su parte de latenciaObjetivo, nunca menor que granularidadMinima.
+struct CFS {
+    static constexpr bool expropiativa = false;
+
+    void encolar(PCB* proceso);
+    PCB* siguiente();
+    bool vacia() const { return raiz == nullptr; }
+    size_t tamano() const { return total; }
+    int rebanada(const PCB& proceso, int quantum) const;
+    void contabilizar(PCB& proceso, int ticks);
+
+    template <typename F>
+    void recorrer(F f) const {
+        for (PCB* p = izquierdo; p; p = sucesor(p)) f(p);
+    }
+
+    // false (sin cambios) salvo 1 <= granularidad <= latencia
+    bool fijarRebanadas(int granularidad, int latencia);
+    int latencia() const { return latenciaObjetivo; }
+    int granularidad() const { return granularidadMinima; }
+
+    // Los procesos en orden de vruntime y las rebanadas; cargar reconstruye el arbol
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector, TablaProcesos& tabla);
+
+private:
+    static PCB* sucesor(PCB* nodo);
+    static bool esRojo(const PCB* nodo) { return nodo && nodo->rbRojo; }
+
+    void insertar(PCB* nodo);
+    void borrar(PCB* nodo);
+    void arreglarInsercion(PCB* nodo);
+    void arreglarBorrado(PCB* hijo, PCB* padre);
+    void trasplantar(PCB* viejo, PCB* nuevo);
+    void rotarIzquierda(PCB* x);
+    void rotarDerecha(PCB* x);
+
+    PCB* raiz = nullptr;
+    PCB* izquierdo = nullptr; // minimo vruntime en cache
+    size_t total = 0;
+    long long pesoTotal = 0;
+    long long minVruntime = 0;
+    int latenciaObjetivo = 24;
+    int granularidadMinima = 3;
+};
+
+// Peso de planificacion para un valor nice en [-20, 19] (nice 0 = 1024).
+int pesoNice(int nice);
+
+} // namespace politicas
@@ -0,0 +1,103 @@
+#include "cola_prioridad.h"
+#include "../snapshot/instantanea.h"
+#include <algorithm>
+#include <bit>
+
+namespace politicas {
+
+void PrioridadO1::encolar(PCB* proceso) {
+    agregarAlFinal(clamp(proceso->prioridadEfectiva(), 0, NIVELES - 1), proceso);
+}
+
+void PrioridadO1::agregarAlFinal(int nivel, PCB* proceso) {
+    Lista& lista = niveles[nivel];
+    proceso->sigCola = nullptr;
+    if (lista.cola)
+        lista.cola->sigCola = proceso;
+    else
+        lista.cabeza = proceso;
+    lista.cola = proceso;
+    marcar(nivel);
+    ++total;
+}
+
+PCB* PrioridadO1::siguiente() {
+    int palabra = mapa[0] ? 0 : 1;
+    int nivel = palabra * 64 + countr_zero(mapa[palabra]);
+
+    Lista& lista = niveles[nivel];
+    PCB* proceso = lista.cabeza;
+    lista.cabeza = proceso->sigCola;
+    if (!lista.cabeza) {
+        lista.cola = nullptr;
+        desmarcar(nivel);
+    }
+    proceso->sigCola = nullptr;
+    --total;
+    return proceso;
+}
+
+void PrioridadO1::transcurrir(long long ticks) {
+    if (intervaloEnvejecimiento <= 0)
+        return;
+    sinEnvejecer += ticks;
+    long long pasos = sinEnvejecer / intervaloEnvejecimiento;
+    sinEnvejecer %= intervaloEnvejecimiento;
+    // Despues de NIVELES pasos todo esta en el nivel 0; mas pasos no cambian nada
+    for (long long i = 0; i < min<long long>(pasos, NIVELES); ++i)
+        envejecer();
+}
+
+void PrioridadO1::envejecer() {
+    // Recorre solo los niveles ocupados (a partir del 1), de menor a mayor nivel
+    for (int palabra = 0; palabra < NIVELES / 64; ++palabra) {
+        uint64_t ocupados = mapa[palabra] & (palabra == 0 ? ~uint64_t(1) : ~uint64_t(0));
+        while (ocupados) {
+            int nivel = palabra * 64 + countr_zero(ocupados);
+            ocupados &= ocupados - 1;
+
+            Lista& origen = niveles[nivel];
+            Lista& destino = niveles[nivel - 1];
+            if (destino.cola)
+                destino.cola->sigCola = origen.cabeza;
+            else
+                destino.cabeza = origen.cabeza;
+            destino.cola = origen.cola;
+            origen = Lista{};
+            desmarcar(nivel);
+            marcar(nivel - 1);
+        }
+    }
+}
+
+void PrioridadO1::guardar(instantanea::Escritor& escritor) const {
+    vector<uint32_t> indices;
+    vector<uint8_t> nivelDe;
+    indices.reserve(total);
+    nivelDe.reserve(total);
+    for (int nivel = 0; nivel < NIVELES; ++nivel)
+        for (PCB* p = niveles[nivel].cabeza; p; p = p->sigCola) {
+            indices.push_back(TablaProcesos::indiceDe(p));
+            nivelDe.push_back((uint8_t) nivel);
+        }
+    escritor.arreglo(indices);
+    escritor.arreglo(nivelDe);
+    escritor.valor(intervaloEnvejecimiento);
+    escritor.valor(sinEnvejecer);
+}
+
+void PrioridadO1::cargar(instantanea::Lector& lector, TablaProcesos& tabla) {
+    niveles = {};
+    fill(begin(mapa), end(mapa), 0);
+    total = 0;
+    auto indices = lector.vista<uint32_t>();
+    auto nivelDe = lector.vista<uint8_t>();
+    if (indices.size() != nivelDe.size())
+        throw runtime_error("cola O(1) inconsistente");
+    for (size_t i = 0; i < indices.size(); ++i)
+        agregarAlFinal(min<int>(nivelDe[i], NIVELES - 1), tabla.ranura(indices[i]));
+    intervaloEnvejecimiento = lector.valor<long long>();
+    sinEnvejecer = lector.valor<long long>();
+}
+
+} // namespace politicas
@@ -0,0 +1,59 @@
+#pragma once
+#include "pcb.h"
+#include "tabla_procesos.h"
+#include <array>
+#include <cstdint>
+
+using namespace std;
+
+namespace politicas {
+
+// Cola de ejecucion O(1) por prioridades: una lista intrusiva por nivel y un
+// mapa de bits de ocupacion. El siguiente proceso se encuentra con
+// count-trailing-zeros sobre el mapa, sin recorrer la cola.
+//
+// Envejecimiento: cada `intervaloEnvejecimiento` ticks todos los niveles suben
+// uno (cada lista se empalma completa al final de la anterior), asi que un
+// proceso de baja prioridad llega al nivel 0 en a lo sumo NIVELES intervalos.
+// Al volver a encolarse, un proceso regresa a su prioridad efectiva de la tabla.
+struct PrioridadO1 {
+    static constexpr bool expropiativa = false;
+    static constexpr int NIVELES = 128;
+
+    void encolar(PCB* proceso);
+    PCB* siguiente();
+    bool vacia() const { return total == 0; }
+    size_t tamano() const { return total; }
+    int rebanada(const PCB&, int quantum) const { return quantum; } // RR dentro de cada nivel
+    void transcurrir(long long ticks);
+
+    template <typename F>
+    void recorrer(F f) const {
+        for (int nivel = 0; nivel < NIVELES; ++nivel)
+            for (PCB* p = niveles[nivel].cabeza; p; p = p->sigCola) f(p);
+    }
+
+    // Cada proceso con su nivel actual (ya envejecido), en orden de despacho
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector, TablaProcesos& tabla);
+
+    long long intervaloEnvejecimiento = 100;
+
+private:
+    struct Lista {
+        PCB* cabeza = nullptr;
+        PCB* cola = nullptr;
+    };
+
+    void envejecer();
+    void agregarAlFinal(int nivel, PCB* proceso);
+    void marcar(int nivel) { mapa[nivel >> 6] |= uint64_t(1) << (nivel & 63); }
+    void desmarcar(int nivel) { mapa[nivel >> 6] &= ~(uint64_t(1) << (nivel & 63)); }
+
+    array<Lista, NIVELES> niveles;
+    uint64_t mapa[NIVELES / 64] = {};
+    size_t total = 0;
+    long long sinEnvejecer = 0;
+};
+
+} // namespace politicas
@@ -0,0 +1,147 @@
+#include "control_quantum.h"
+#include "../snapshot/instantanea.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+// CuantilP2
+
+void CuantilP2::reiniciar(double nuevoP) {
+    p = nuevoP;
+    total = 0;
+}
+
+void CuantilP2::registrar(double x) {
+    // Las cinco primeras muestras son los marcadores iniciales
+    if (total < 5) {
+        altura[total++] = x;
+        if (total == 5) {
+            sort(altura.begin(), altura.end());
+            for (int i = 0; i < 5; ++i) posicion[i] = i;
+            deseada = {0, 2 * p, 4 * p, 2 + 2 * p, 4};
+        }
+        return;
+    }
+    ++total;
+
+    // Celda de la muestra; los extremos se corren si hace falta
+    int k;
+    if (x < altura[0]) {
+        altura[0] = x;
+        k = 0;
+    } else if (x >= altura[4]) {
+        altura[4] = max(altura[4], x);
+        k = 3;
+    } else {
+        k = 0;
+        while (x >= altura[k + 1]) ++k;
+    }
+    for (int i = k + 1; i < 5; ++i) ++posicion[i];
+    const double incremento[5] = {0, p / 2, p, (1 + p) / 2, 1};
+    for (int i = 0; i < 5; ++i) deseada[i] += incremento[i];
+
+    // Ajuste de los marcadores centrales hacia su posicion deseada
+    for (int i = 1; i <= 3; ++i) {
+        double d = deseada[i] - posicion[i];
+        if ((d >= 1 && posicion[i + 1] - posicion[i] > 1) || (d <= -1 && posicion[i - 1] - posicion[i] < -1)) {
+            int s = d > 0 ? 1 : -1;
+            double parabolica = altura[i] + s / (posicion[i + 1] - posicion[i - 1])
+                * ((posicion[i] - posicion[i - 1] + s) * (altura[i + 1] - altura[i]) / (posicion[i + 1] - posicion[i])
+                 + (posicion[i + 1] - posicion[i] - s) * (altura[i] - altura[i - 1]) / (posicion[i] - posicion[i - 1]));
+            if (altura[i - 1] < parabolica && parabolica < altura[i + 1])
+                altura[i] = parabolica;
+            else
+                altura[i] += s * (altura[i + s] - altura[i]) / (posicion[i + s] - posicion[i]);
+            posicion[i] += s;
+        }
+    }
+}
+
+double CuantilP2::estimacion() const {
+    if (total == 0)
+        return 0;
+    if (total < 5) {
+        // Cuantil exacto de las pocas muestras que hay
+        array<double, 5> copia = altura;
+        sort(copia.begin(), copia.begin() + total);
+        return copia[min<size_t>((size_t) (p * total), total - 1)];
+    }
+    return altura[2];
+}
+
+// ControlQuantum
+
+void ControlQuantum::activar(double nuevoPercentil, int nuevoMinimo, int nuevoMaximo, int inicial) {
+    habilitado = true;
+    percentil = nuevoPercentil;
+    minimo = nuevoMinimo;
+    maximo = max(nuevoMinimo, nuevoMaximo);
+    actual = clamp(inicial, minimo, maximo);
+    ventana.reiniciar(percentil);
+}
+
+void ControlQuantum::registrar(int duracion, long long reloj) {
+    auto inicio = chrono::steady_clock::now();
+    ventana.registrar(duracion);
+    ++observaciones;
+    if (ventana.cuenta() >= VENTANA) {
+        double estimacion = ventana.estimacion();
+        int nuevo = clamp((int) lround(estimacion), minimo, maximo);
+        cambios += nuevo != actual;
+        actual = nuevo;
+        historial[decisiones % HISTORIAL] = {reloj, actual, estimacion};
+        ++decisiones;
+        ventana.reiniciar(percentil);
+    }
+    nsSobrecosto += (uint64_t) chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - inicio).count();
+}
+
+ResumenQuantum ControlQuantum::resumen(int fijo) const {
+    return {habilitado, percentil, quantum(fijo), minimo, maximo, observaciones, decisiones, cambios, nsSobrecosto};
+}
+
+void ControlQuantum::listar(int fijo) const {
+    if (!habilitado) {
+        cout << "Quantum fijo: " << fijo << endl;
+        return;
+    }
+    cout << "=== Quantum adaptativo (p" << lround(percentil * 100) << " de las ultimas " << VENTANA
+         << " rafagas, entre " << minimo << " y " << maximo << ") ===" << endl;
+    cout << "  actual: " << actual << " | rafagas observadas: " << observaciones << " | decisiones: " << decisiones
+         << " (" << cambios << " cambios)" << endl;
+    uint64_t mostradas = min<uint64_t>(decisiones, HISTORIAL);
+    for (uint64_t i = 0; i < mostradas; ++i) {
+        const Decision& d = historial[(decisiones - mostradas + i) % HISTORIAL];
+        cout << "  tick " << d.reloj << ": quantum " << d.quantum << " (estimacion " << fixed << setprecision(1)
+             << d.estimacion << ")" << endl;
+    }
+}
+
+void ControlQuantum::guardar(instantanea::Escritor& escritor) const {
+    escritor.valor(habilitado);
+    escritor.valor(percentil);
+    escritor.valor(minimo);
+    escritor.valor(maximo);
+    escritor.valor(actual);
+    escritor.valor(ventana);
+    escritor.valor(observaciones);
+    escritor.valor(decisiones);
+    escritor.valor(cambios);
+    escritor.valor(nsSobrecosto);
+    escritor.valor(historial);
+}
+
+void ControlQuantum::cargar(instantanea::Lector& lector) {
+    habilitado = lector.valor<bool>();
+    percentil = lector.valor<double>();
+    minimo = lector.valor<int>();
+    maximo = lector.valor<int>();
+    actual = lector.valor<int>();
+    ventana = lector.valor<CuantilP2>();
+    observaciones = lector.valor<uint64_t>();
+    decisiones = lector.valor<uint64_t>();
+    cambios = lector.valor<uint64_t>();
+    nsSobrecosto = lector.valor<uint64_t>();
+    historial = lector.valor<decltype(historial)>();
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <iostream>
+
+using namespace std;
+
+namespace instantanea { class Escritor; class Lector; }
+
+// Estimador P2 de un cuantil (Jain y Chlamtac, 1985): cinco marcadores cuyas
+// alturas se ajustan con interpolacion parabolica a cada muestra. Memoria y costo
+// constantes, sin guardar las muestras.
+class CuantilP2 {
+public:
+    explicit CuantilP2(double p = 0.5) : p(p) {}
+
+    void registrar(double x);
+    double estimacion() const;
+    uint64_t cuenta() const { return total; }
+    void reiniciar(double nuevoP);
+
+private:
+    double p;
+    array<double, 5> altura{};   // q_i
+    array<double, 5> posicion{}; // n_i
+    array<double, 5> deseada{};  // n'_i
+    uint64_t total = 0;
+};
+
+// Resumen del controlador para `stats`
+struct ResumenQuantum {
+    bool activo = false;
+    double percentil = 0;
+    int actual = 0;
+    int minimo = 0;
+    int maximo = 0;
+    uint64_t observaciones = 0;  // rafagas de CPU completas vistas
+    uint64_t decisiones = 0;     // ventanas cerradas
+    uint64_t cambios = 0;        // decisiones que movieron el quantum
+    uint64_t nsSobrecosto = 0;   // tiempo real dentro del controlador
+};
+
+// Quantum adaptativo: observa la duracion de cada rafaga de CPU completa y, cada
+// VENTANA rafagas, fija el quantum en el percentil objetivo de esa ventana (una
+// rafaga tipica termina dentro de su primera rebanada, las largas rotan). La
+// ventana se reinicia en cada decision, asi que sigue a la distribucion reciente.
+class ControlQuantum {
+public:
+    static constexpr uint64_t VENTANA = 128;
+    static constexpr int HISTORIAL = 8;
+
+    struct Decision {
+        long long reloj;
+        int quantum;
+        double estimacion;
+    };
+
+    // Arranca en `inicial` hasta la primera decision
+    void activar(double percentil, int minimo, int maximo, int inicial);
+    void desactivar() { habilitado = false; }
+    bool activo() const { return habilitado; }
+
+    // Quantum vigente: el fijo si el controlador esta apagado
+    int quantum(int fijo) const { return habilitado ? actual : fijo; }
+
+    // Una rafaga de CPU de `duracion` ticks termino en `reloj`
+    void registrar(int duracion, long long reloj);
+
+    ResumenQuantum resumen(int fijo) const;
+    void listar(int fijo) const;
+
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector);
+
+private:
+    bool habilitado = false;
+    double percentil = 0.8;
+    int minimo = 1;
+    int maximo = 100;
+    int actual = 5;
+    CuantilP2 ventana{0.8};
+    uint64_t observaciones = 0;
+    uint64_t decisiones = 0;
+    uint64_t cambios = 0;
+    uint64_t nsSobrecosto = 0;
+    array<Decision, HISTORIAL> historial{}; // anillo con las ultimas decisiones
+};
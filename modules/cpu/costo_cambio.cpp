@@ -0,0 +1,30 @@
+#include "costo_cambio.h"
+#include <cmath>
+
+int CostoCambio::penalizacion(const PCB& proceso, int nucleo, long long reloj) const {
+    if (cacheFria <= 0)
+        return 0;
+    if (proceso.nucleoPrevio != nucleo)
+        return cacheFria;
+    // Calor restante 2^(-ausencia / vidaMedia): la penalizacion crece hacia cacheFria
+    double ausencia = (double) max(0LL, reloj - proceso.salidaCPU);
+    double calor = exp2(-ausencia / max(1, vidaMedia));
+    return (int) lround(cacheFria * (1.0 - calor));
+}
+
+void CostoCambio::listar() const {
+    if (!activo()) {
+        cout << "Cambios de contexto sin costo";
+        if (afinidad())
+            cout << " (despacho por afinidad: " << ventana << " candidatos)";
+        cout << endl;
+        return;
+    }
+    cout << "=== Costo de cambio de contexto ===" << endl;
+    cout << "  fijo: " << fijo << " ticks | cache fria: " << cacheFria << " ticks (vida media "
+         << vidaMedia << " ticks fuera del nucleo)" << endl;
+    if (afinidad())
+        cout << "  despacho por afinidad: el mas barato entre los primeros " << ventana << " listos" << endl;
+    else
+        cout << "  despacho en orden de la cola" << endl;
+}
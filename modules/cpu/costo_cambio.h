@@ -0,0 +1,30 @@
+#pragma once
+#include "pcb.h"
+
+using namespace std;
+
+// Costo de un cambio de contexto: un costo fijo por despacho (guardar y restaurar
+// registros, vaciar la TLB) mas una penalizacion de cache fria que decae con el
+// tiempo que el proceso paso fuera del nucleo. Un proceso que vuelve pronto al
+// mismo nucleo encuentra su cache tibia; uno nuevo o que viene de otro nucleo paga
+// la penalizacion completa. Todo en cero (por defecto): los cambios son gratis.
+struct CostoCambio {
+    int fijo = 0;       // ticks por cambio
+    int cacheFria = 0;  // ticks extra con la cache completamente fria
+    int vidaMedia = 50; // ticks fuera del nucleo en que la cache pierde la mitad de su calor
+    // Despacho por afinidad: candidatos al frente de la cola entre los que se elige el
+    // mas barato (1 = orden estricto de la cola). Con varios nucleos, ademas, un
+    // proceso que despierta vuelve a su nucleo anterior si esperar ahi sale mas barato.
+    int ventana = 1;
+
+    bool activo() const { return fijo > 0 || cacheFria > 0; }
+    bool afinidad() const { return ventana > 1; }
+
+    // Ticks de cache fria para despachar `proceso` en `nucleo` en el tick `reloj`
+    int penalizacion(const PCB& proceso, int nucleo, long long reloj) const;
+    int costo(const PCB& proceso, int nucleo, long long reloj) const {
+        return activo() ? fijo + penalizacion(proceso, nucleo, reloj) : 0;
+    }
+
+    void listar() const;
+};
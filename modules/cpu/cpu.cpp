@@ -1,22 +1,304 @@
 #include "cpu.h"
 #include "scheduler.h"
 #include "pcb.h"
+#include "traza.h"
+#include "../snapshot/instantanea.h"
+#include <climits>
+#include <iomanip>
 #include <iostream>
 
-CPU::CPU(int q) : quantum(q) {
-    scheduler = new Scheduler;
+static SchedulerVariante crearScheduler(Planificacion planificacion, TablaProcesos& tabla) {
+    switch (planificacion) {
+        case Planificacion::FIFO: return Scheduler<politicas::FIFO>(tabla);
+        case Planificacion::SJF: return Scheduler<politicas::SJF>(tabla);
+        case Planificacion::SRTF: return Scheduler<politicas::SRTF>(tabla);
+        case Planificacion::Prioridad: return Scheduler<politicas::Prioridad>(tabla);
+        case Planificacion::RoundRobin: break;
+        case Planificacion::PrioridadO1: return Scheduler<politicas::PrioridadO1>(tabla);
+        case Planificacion::CFS: return Scheduler<politicas::CFS>(tabla);
+        case Planificacion::Loteria: return Scheduler<politicas::Loteria>(tabla);
+        case Planificacion::Stride: return Scheduler<politicas::Stride>(tabla);
+    }
+    return Scheduler<politicas::RoundRobin>(tabla);
 }
 
-void CPU::add_process(PCB* pcb) {
-    scheduler->agregarProceso(pcb);
+CPU::CPU(int q, Planificacion planificacion, int nucleos)
+    : tabla(make_unique<TablaProcesos>()), scheduler(crearScheduler(planificacion, *tabla)), quantum(q) {
+    if (nucleos > 1)
+        smp = make_unique<SMP>(nucleos, q, planificacion, *tabla);
 }
 
-void CPU::ejecutarRoundRobin(int tick) { //Aqui cambie para que tome los ticks que le da el usuario
-    // std::cout << "=== Iniciando ejecución Round Robin ===" << std::endl; obsoletos
-    scheduler->ejecutar(quantum, tick);
-    // std::cout << "=== Ejecución finalizada ===" << std::endl;
+Pid CPU::add_process(const PCB& programa) {
+    PCB* proceso = tabla->crear(programa);
+    if (smp)
+        smp->agregarProceso(proceso);
+    else
+        visit([&](auto& s) { s.agregarProceso(proceso); }, scheduler);
+    return proceso->pid;
+}
+
+optional<Pid> CPU::agregarTareaPeriodica(const PCB& programa) {
+    if (smp)
+        return nullopt;
+    return visit([&](auto& s) { return s.tiempoReal().admitir(programa, s.relojActual()); }, scheduler);
+}
+
+bool CPU::fijarModoTiempoReal(ModoTiempoReal modo) {
+    if (smp)
+        return false;
+    return visit([&](auto& s) { return s.tiempoReal().fijarModo(modo); }, scheduler);
+}
+
+void CPU::listarTiempoReal() const {
+    if (smp) {
+        cout << "La clase de tiempo real solo existe con un nucleo." << endl;
+        return;
+    }
+    visit([](const auto& s) { s.tiempoReal().listar(); }, scheduler);
+}
+
+void CPU::listarTemporizadores() const {
+    const size_t maximo = 20;
+    if (smp) {
+        smp->temporizadoresPendientes().listar(maximo);
+        return;
+    }
+    visit([&](const auto& s) { s.temporizadoresPendientes().listar(maximo); }, scheduler);
+}
+
+void CPU::fijarQuantum(int q) {
+    quantum = q;
+    if (smp) {
+        smp->controlQuantum().desactivar();
+        smp->fijarQuantum(q);
+    } else {
+        visit([](auto& s) { s.controlQuantum().desactivar(); }, scheduler);
+    }
+}
+
+void CPU::activarQuantumAdaptativo(double percentil, int minimo, int maximo) {
+    if (smp)
+        smp->controlQuantum().activar(percentil, minimo, maximo, quantum);
+    else
+        visit([&](auto& s) { s.controlQuantum().activar(percentil, minimo, maximo, quantum); }, scheduler);
+}
+
+void CPU::listarQuantum() const {
+    if (smp)
+        smp->controlQuantum().listar(quantum);
+    else
+        visit([&](const auto& s) { s.controlQuantum().listar(quantum); }, scheduler);
+}
+
+void CPU::fijarCostoCambio(const CostoCambio& modelo) {
+    if (smp)
+        smp->costoCambio() = modelo;
+    else
+        visit([&](auto& s) { s.costoCambio() = modelo; }, scheduler);
+}
+
+void CPU::listarCostoCambio() const {
+    if (smp)
+        smp->costoCambio().listar();
+    else
+        visit([](const auto& s) { s.costoCambio().listar(); }, scheduler);
+}
+
+bool CPU::fijarRebanadasCFS(int granularidad, optional<int> latencia) {
+    if (smp)
+        return smp->fijarRebanadasCFS(granularidad, latencia);
+    auto* cfs = get_if<Scheduler<politicas::CFS>>(&scheduler);
+    if (!cfs)
+        return false;
+    int objetivo = latencia.value_or(cfs->politicaListos().latencia());
+    return cfs->ajustarColas([&](politicas::CFS& cola) { return cola.fijarRebanadas(granularidad, objetivo); });
+}
+
+void CPU::listarCFS() const {
+    auto* cfs = get_if<Scheduler<politicas::CFS>>(&scheduler);
+    const politicas::CFS* politica = smp ? smp->cfs() : cfs ? &cfs->politicaListos() : nullptr;
+    if (!politica) {
+        cout << "La politica no es CFS." << endl;
+        return;
+    }
+    cout << "CFS: latencia objetivo " << politica->latencia() << " ticks, granularidad minima "
+         << politica->granularidad() << " ticks";
+    if (smp)
+        cout << " (en cada uno de los " << smp->cantidadNucleos() << " nucleos)";
+    cout << endl;
+}
+
+Grupos* CPU::grupos() {
+    if (smp)
+        return nullptr;
+    return visit([](auto& s) { return &s.gruposControl(); }, scheduler);
+}
+
+const Grupos* CPU::grupos() const {
+    if (smp)
+        return nullptr;
+    return visit([](const auto& s) { return &s.gruposControl(); }, scheduler);
+}
+
+bool CPU::crearGrupo(const string& nombre, const string& padre) {
+    Grupos* g = grupos();
+    return g && g->crear(nombre, g->buscar(padre)).has_value();
+}
+
+bool CPU::fijarCuotaGrupo(const string& nombre, long long cuota, long long periodo) {
+    Grupos* g = grupos();
+    return g && g->fijarCuota(g->buscar(nombre), cuota, periodo, reloj());
+}
+
+bool CPU::fijarPesoGrupo(const string& nombre, int peso) {
+    Grupos* g = grupos();
+    return g && g->fijarPeso(g->buscar(nombre), peso);
+}
+
+bool CPU::usarGrupo(const string& nombre) {
+    Grupos* g = grupos();
+    return g && g->fijarPorDefecto(g->buscar(nombre));
+}
+
+optional<ConsumoGrupo> CPU::consumoGrupo(const string& nombre) const {
+    const Grupos* g = grupos();
+    if (!g || g->buscar(nombre) == Grupos::NINGUNO)
+        return nullopt;
+    return g->consumo(g->buscar(nombre));
+}
+
+void CPU::listarGrupos() const {
+    if (const Grupos* g = grupos())
+        g->listar();
+    else
+        cout << "Los grupos de control solo existen con un nucleo." << endl;
+}
+
+bool CPU::fijarTiposNucleo(const vector<TipoNucleo>& tipos) {
+    return smp && smp->fijarTipos(tipos);
+}
+
+bool CPU::fijarEnergia(const ConfigEnergia& config) {
+    if (!smp)
+        return false;
+    smp->fijarEnergia(config);
+    return true;
+}
+
+ConfigEnergia CPU::configEnergia() const {
+    return smp ? smp->configEnergia() : ConfigEnergia{};
+}
+
+void CPU::listarEnergia() const {
+    if (smp) {
+        smp->listarEnergia();
+        return;
+    }
+    const PerfilNucleo& perfil = perfilNucleo(TipoNucleo::Grande);
+    cout << "Un nucleo " << perfil.nombre << " a " << perfil.estados[0].mhz << " MHz fijos ("
+         << perfil.estados[0].potencia << " mW ocupado, " << perfil.reposo << " mW ocioso): "
+         << fixed << setprecision(3) << estadisticas().energia / 1e6 << " J" << endl;
+}
+
+void CPU::ejecutar(long long tick, bool traza) { //Aqui cambie para que tome los ticks que le da el usuario
+    // Un presupuesto nulo o negativo no avanza nada (el reloj nunca retrocede)
+    if (tick <= 0)
+        return;
+    // Con traza la consola muestra cada rebanada solo durante este comando
+    traza::Consola nivelPrevio = traza::consola();
+    if (traza)
+        traza::fijarConsola(traza::Consola::Todo);
+
+    if (smp) {
+        smp->ejecutar(tick);
+    } else {
+        // El visit ocurre una vez por comando; el ciclo de despacho ya esta especializado
+        visit([&](auto& s) { s.ejecutar(quantum, tick); }, scheduler);
+    }
+
+    traza::fijarConsola(nivelPrevio);
 }
 
 void CPU::listarProcesos() const {
-    scheduler->listarProcesos();
+    if (smp) {
+        smp->listarProcesos();
+        return;
+    }
+    visit([](const auto& s) { s.listarProcesos(); }, scheduler);
+}
+
+Planificacion CPU::planificacion() const {
+    return static_cast<Planificacion>(scheduler.index());
+}
+
+int CPU::nucleos() const {
+    return smp ? smp->cantidadNucleos() : 1;
+}
+
+Metricas CPU::estadisticas() const {
+    Metricas metricas;
+    if (smp) {
+        metricas = smp->estadisticas();
+        metricas.quantum = smp->controlQuantum().resumen(quantum);
+    } else {
+        visit([&](const auto& s) {
+            metricas = s.estadisticas();
+            metricas.quantum = s.controlQuantum().resumen(quantum);
+            metricas.energia = energiaNucleoFijo(metricas.ticksOcupado + metricas.ticksCambio, metricas.ticksEncendido);
+        }, scheduler);
+    }
+    return metricas;
+}
+
+long long CPU::reloj() const {
+    if (smp)
+        return smp->relojActual();
+    return visit([](const auto& s) { return s.relojActual(); }, scheduler);
+}
+
+bool CPU::mapear(Pid pid, uint64_t direccion, uint64_t paginas) {
+    return tabla->vivo(pid) && tabla->memoria.mapear(pid.indice, direccion, paginas);
+}
+
+uint64_t CPU::desmapear(Pid pid, uint64_t direccion, uint64_t paginas) {
+    return tabla->vivo(pid) ? tabla->memoria.desmapear(pid.indice, direccion, paginas) : 0;
+}
+
+uint64_t CPU::traducir(Pid pid, uint64_t direccion) {
+    return tabla->vivo(pid) ? tabla->memoria.traducir(pid.indice, direccion) : SIN_TRADUCCION;
+}
+
+void CPU::traducirLote(Pid pid, const uint64_t* direcciones, uint64_t* fisicas, size_t n) {
+    if (tabla->vivo(pid))
+        tabla->memoria.traducirLote(pid.indice, direcciones, fisicas, n);
+    else
+        fill(fisicas, fisicas + n, SIN_TRADUCCION);
+}
+
+void CPU::guardar(instantanea::Escritor& escritor) const {
+    escritor.valor(quantum);
+    escritor.valor<uint32_t>((uint32_t) scheduler.index());
+    escritor.valor<uint32_t>((uint32_t) nucleos());
+    tabla->guardar(escritor);
+    if (smp)
+        smp->guardar(escritor);
+    else
+        visit([&](const auto& s) { s.guardar(escritor); }, scheduler);
+}
+
+void CPU::cargar(instantanea::Lector& lector) {
+    int q = lector.valor<int>();
+    uint32_t politica = lector.valor<uint32_t>();
+    uint32_t cantidad = lector.valor<uint32_t>();
+    if (politica >= variant_size_v<SchedulerVariante> || cantidad < 1 || cantidad > INT_MAX || q < 1)
+        throw runtime_error("configuracion de CPU invalida");
+
+    // Todo va a una CPU nueva; esta solo se reemplaza si la seccion entera se leyo bien
+    CPU cargada(q, static_cast<Planificacion>(politica), (int) cantidad);
+    cargada.tabla->cargar(lector);
+    if (cargada.smp)
+        cargada.smp->cargar(lector);
+    else
+        visit([&](auto& s) { s.cargar(lector); }, cargada.scheduler);
+    *this = move(cargada);
 }
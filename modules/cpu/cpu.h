@@ -1,19 +1,91 @@
 #pragma once
 #include "scheduler.h"
 #include "pcb.h"
+#include "smp.h"
+#include "tabla_procesos.h"
+#include <memory>
+#include <variant>
 
 #ifndef CPU_H
 #define CPU_H
 
+// La politica se elige al arrancar; cada alternativa es un Scheduler especializado
+using SchedulerVariante = variant<Scheduler<politicas::FIFO>,
+                                  Scheduler<politicas::SJF>,
+                                  Scheduler<politicas::SRTF>,
+                                  Scheduler<politicas::Prioridad>,
+                                  Scheduler<politicas::RoundRobin>,
+                                  Scheduler<politicas::PrioridadO1>,
+                                  Scheduler<politicas::CFS>,
+                                  Scheduler<politicas::Loteria>,
+                                  Scheduler<politicas::Stride>>;
+
 class CPU {
 private:
-    Scheduler* scheduler; // cambio importante de hacer
+    // Dueña de todos los procesos de esta CPU. En el heap para que el scheduler y el SMP
+    // la sigan apuntando cuando la CPU se mueve (cargar arma una CPU nueva y la mueve)
+    unique_ptr<TablaProcesos> tabla;
+    SchedulerVariante scheduler;
     int quantum; //Se inicializa un quantum pre establecido
+    unique_ptr<SMP> smp; // con mas de un nucleo, reemplaza al scheduler (la politica en cada nucleo)
+
+    Grupos* grupos();
+    const Grupos* grupos() const;
 
 public:
-    CPU(int q);
-    void ejecutarRoundRobin(int tick);
-    void add_process(PCB * pcb);
+    CPU(int q, Planificacion planificacion = Planificacion::RoundRobin, int nucleos = 1);
+    void ejecutar(long long tick, bool traza = false);
+    // Crea un proceso nuevo a partir del programa; el programa no cambia
+    Pid add_process(const PCB& programa);
+    // Programa periodico (periodo > 0) a la clase de tiempo real; nullopt si no pasa
+    // el test de admision o si la CPU tiene varios nucleos
+    optional<Pid> agregarTareaPeriodica(const PCB& programa);
+    // false si la CPU tiene varios nucleos o las tareas admitidas no pasan la cota del modo
+    bool fijarModoTiempoReal(ModoTiempoReal modo);
+    void listarTiempoReal() const;
+    void listarTemporizadores() const;
+    // Quantum fijo (apaga el controlador) o adaptativo al percentil de las rafagas recientes
+    void fijarQuantum(int q);
+    void activarQuantumAdaptativo(double percentil, int minimo, int maximo);
+    void listarQuantum() const;
+    // Costo de los cambios de contexto y despacho por afinidad (todo en cero: gratis)
+    void fijarCostoCambio(const CostoCambio& modelo);
+    void listarCostoCambio() const;
+    // Rebanadas de CFS: granularidad minima y latencia objetivo (sin ella, la vigente),
+    // en ticks, para todos los nucleos. false si la politica no es CFS o no
+    // 1 <= granularidad <= latencia
+    bool fijarRebanadasCFS(int granularidad, optional<int> latencia = nullopt);
+    void listarCFS() const;
+    // Grupos de control de CPU (cuota por periodo, peso, anidados). Solo con un nucleo:
+    // false/nullopt con varios nucleos, si el grupo no existe o los parametros no valen
+    bool crearGrupo(const string& nombre, const string& padre = "raiz");
+    bool fijarCuotaGrupo(const string& nombre, long long cuota, long long periodo);
+    bool fijarPesoGrupo(const string& nombre, int peso);
+    bool usarGrupo(const string& nombre); // grupo de los procesos nuevos
+    optional<ConsumoGrupo> consumoGrupo(const string& nombre) const;
+    void listarGrupos() const;
+    // Energia: tipo de cada nucleo ("ggee"), gobernador de frecuencia y colocacion.
+    // Con un nucleo la CPU es un nucleo grande a frecuencia fija: false al configurarla
+    bool fijarTiposNucleo(const vector<TipoNucleo>& tipos);
+    bool fijarEnergia(const ConfigEnergia& config);
+    ConfigEnergia configEnergia() const;
+    void listarEnergia() const;
     void listarProcesos() const;
+    Planificacion planificacion() const;
+    int nucleos() const;
+    const TablaProcesos& procesos() const { return *tabla; }
+    // Memoria virtual por proceso: false/SIN_TRADUCCION si el pid no esta vivo
+    bool mapear(Pid pid, uint64_t direccion, uint64_t paginas);
+    uint64_t desmapear(Pid pid, uint64_t direccion, uint64_t paginas);
+    uint64_t traducir(Pid pid, uint64_t direccion);
+    void traducirLote(Pid pid, const uint64_t* direcciones, uint64_t* fisicas, size_t n);
+    const MemoriaVirtual& memoriaVirtual() const { return tabla->memoria; }
+    Metricas estadisticas() const;
+    long long reloj() const;
+
+    // Instantanea: quantum, politica, nucleos, tabla de procesos y planificador.
+    // cargar reemplaza todo el estado, o nada si la instantanea no vale (lanza runtime_error).
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector);
 };
-#endif
\ No newline at end of file
+#endif
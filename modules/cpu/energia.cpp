@@ -0,0 +1,79 @@
+#include "energia.h"
+#include <algorithm>
+
+// Valores del orden de un SoC movil big.LITTLE: el grande rinde ~2.2x mas que el
+// eficiente a maxima frecuencia, pero el eficiente hace ~3x mas trabajo por joule
+static const PerfilNucleo PERFILES[] = {
+    {"grande", 'g', {{{2000, 1000, 2000}, {1500, 750, 1000}, {1000, 500, 450}}}, 50},
+    {"eficiente", 'e', {{{1400, 450, 300}, {1000, 320, 160}, {600, 190, 80}}}, 10},
+};
+
+const PerfilNucleo& perfilNucleo(TipoNucleo tipo) {
+    return PERFILES[(int) tipo];
+}
+
+int ajustarFrecuencia(Gobernador gobernador, int estado, int ocupados) {
+    switch (gobernador) {
+        case Gobernador::Rendimiento: return 0;
+        case Gobernador::Ahorro: return 2;
+        case Gobernador::Demanda: break;
+    }
+    if (ocupados * 10 >= VENTANA_DVFS * 8)
+        return 0;
+    if (ocupados * 10 <= VENTANA_DVFS * 3)
+        return min(estado + 1, 2);
+    return estado;
+}
+
+uint64_t energiaNucleoFijo(uint64_t ticksActivo, uint64_t ticksEncendido) {
+    const PerfilNucleo& perfil = perfilNucleo(TipoNucleo::Grande);
+    uint64_t ocioso = ticksEncendido > ticksActivo ? ticksEncendido - ticksActivo : 0;
+    return (ticksActivo * perfil.estados[0].potencia + ocioso * perfil.reposo) * MS_POR_TICK;
+}
+
+optional<vector<TipoNucleo>> tiposDesdeTexto(const string& texto) {
+    if (texto.empty())
+        return nullopt;
+    vector<TipoNucleo> tipos;
+    for (char letra : texto) {
+        if (letra == perfilNucleo(TipoNucleo::Grande).letra)
+            tipos.push_back(TipoNucleo::Grande);
+        else if (letra == perfilNucleo(TipoNucleo::Eficiente).letra)
+            tipos.push_back(TipoNucleo::Eficiente);
+        else
+            return nullopt;
+    }
+    return tipos;
+}
+
+string textoTipos(const vector<TipoNucleo>& tipos) {
+    string texto;
+    for (TipoNucleo tipo : tipos) texto += perfilNucleo(tipo).letra;
+    return texto;
+}
+
+optional<Gobernador> gobernadorDesdeNombre(const string& nombre) {
+    if (nombre == "rendimiento") return Gobernador::Rendimiento;
+    if (nombre == "ahorro") return Gobernador::Ahorro;
+    if (nombre == "demanda") return Gobernador::Demanda;
+    return nullopt;
+}
+
+string nombreGobernador(Gobernador gobernador) {
+    switch (gobernador) {
+        case Gobernador::Rendimiento: return "rendimiento";
+        case Gobernador::Ahorro: return "ahorro";
+        case Gobernador::Demanda: return "demanda";
+    }
+    return "?";
+}
+
+optional<Colocacion> colocacionDesdeNombre(const string& nombre) {
+    if (nombre == "rr" || nombre == "reparto") return Colocacion::Reparto;
+    if (nombre == "energia") return Colocacion::Energia;
+    return nullopt;
+}
+
+string nombreColocacion(Colocacion colocacion) {
+    return colocacion == Colocacion::Energia ? "energia" : "reparto";
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Modelo de energia de los nucleos. Un tick simulado dura MS_POR_TICK ms, asi que
+// una potencia en mW sostenida un tick consume mW * MS_POR_TICK microjoules.
+//
+// Cada tipo de nucleo tiene una tabla de estados de frecuencia (P-states, del mas
+// rapido al mas lento) con su velocidad relativa al nucleo de referencia y su
+// potencia activa, mas una potencia de reposo. La potencia dinamica crece mas o
+// menos con el cubo de la frecuencia (f * V^2, con V casi proporcional a f): bajar
+// la frecuencia ahorra mas energia de la que cuesta en velocidad.
+constexpr int MS_POR_TICK = 1;
+constexpr int VELOCIDAD_BASE = 1000; // una unidad de trabajo por tick
+
+struct EstadoFrecuencia {
+    int mhz;
+    int velocidad; // trabajo por tick en milesimas de VELOCIDAD_BASE
+    int potencia;  // mW con el nucleo ocupado
+};
+
+enum class TipoNucleo : uint8_t { Grande, Eficiente };
+
+struct PerfilNucleo {
+    const char* nombre;
+    char letra;
+    array<EstadoFrecuencia, 3> estados;
+    int reposo; // mW con el nucleo ocioso
+};
+
+const PerfilNucleo& perfilNucleo(TipoNucleo tipo);
+
+// Gobernador de frecuencia (DVFS), por nucleo:
+//   Rendimiento - siempre el estado mas rapido
+//   Ahorro      - siempre el mas lento
+//   Demanda     - cada VENTANA_DVFS ticks sube al mas rapido si el nucleo estuvo
+//                 ocupado al menos el 80% y baja un estado si estuvo ocupado el 30% o menos
+enum class Gobernador : uint8_t { Rendimiento, Ahorro, Demanda };
+constexpr int VENTANA_DVFS = 10;
+
+// Donde va un proceso que empieza una rafaga de CPU:
+//   Reparto - round robin entre los nucleos
+//   Energia - rafagas cortas al nucleo eficiente menos cargado, el resto al grande
+//             menos cargado (si no hay de ese tipo, cualquiera)
+enum class Colocacion : uint8_t { Reparto, Energia };
+
+// Configuracion comun a todos los nucleos; por defecto todo grande a maxima frecuencia
+struct ConfigEnergia {
+    Gobernador gobernador = Gobernador::Rendimiento;
+    Colocacion colocacion = Colocacion::Reparto;
+    int umbralCorta = 10; // ticks de trabajo; rafagas hasta este largo cuentan como cortas
+
+    // Estado en que arranca (y, salvo con Demanda, se queda) un nucleo
+    int estadoInicial() const { return gobernador == Gobernador::Ahorro ? 2 : 0; }
+};
+
+// Estado de frecuencia tras una ventana con `ocupados` ticks de trabajo
+int ajustarFrecuencia(Gobernador gobernador, int estado, int ocupados);
+
+// Energia (microjoules) de un nucleo grande a frecuencia fija: la CPU de un solo nucleo
+uint64_t energiaNucleoFijo(uint64_t ticksActivo, uint64_t ticksEncendido);
+
+// "ggee": dos grandes y dos eficientes; nullopt si hay otra letra o esta vacio
+optional<vector<TipoNucleo>> tiposDesdeTexto(const string& texto);
+string textoTipos(const vector<TipoNucleo>& tipos);
+optional<Gobernador> gobernadorDesdeNombre(const string& nombre);
+string nombreGobernador(Gobernador gobernador);
+optional<Colocacion> colocacionDesdeNombre(const string& nombre);
+string nombreColocacion(Colocacion colocacion);
@@ -0,0 +1,324 @@
+#include "grupos.h"
+#include "../snapshot/instantanea.h"
+#include <cmath>
+#include <iomanip>
+
+Grupos::Grupos() {
+    grupos.push_back(Grupo{});
+    grupos[RAIZ].nombre = "raiz";
+}
+
+optional<uint32_t> Grupos::crear(const string& nombre, uint32_t padre) {
+    if (nombre.empty() || padre >= grupos.size() || buscar(nombre) != NINGUNO)
+        return nullopt;
+    Grupo nuevo;
+    nuevo.nombre = nombre;
+    nuevo.padre = padre;
+    grupos.push_back(nuevo);
+    uint32_t id = (uint32_t) (grupos.size() - 1);
+    grupos[padre].hijos.push_back(id);
+    recalcular();
+    return id;
+}
+
+uint32_t Grupos::buscar(const string& nombre) const {
+    for (uint32_t id = 0; id < grupos.size(); ++id)
+        if (grupos[id].nombre == nombre)
+            return id;
+    return NINGUNO;
+}
+
+bool Grupos::fijarCuota(uint32_t id, long long cuota, long long periodo, long long reloj) {
+    if (id >= grupos.size() || cuota < 0 || periodo < 1 || cuota > periodo)
+        return false;
+    Grupo& grupo = grupos[id];
+    // Sin cuota no se lleva la cuenta por periodo
+    if (grupo.cuota == 0)
+        grupo.consumoPeriodo = 0;
+    grupo.cuota = cuota;
+    grupo.periodo = periodo;
+    if (grupo.estrangulado) {
+        // Se recarga en el proximo evento con la cuota nueva
+        grupo.finPeriodo = reloj;
+        recargas.cambiarClave(id, reloj);
+        return true;
+    }
+    grupo.finPeriodo = (reloj / periodo + 1) * periodo;
+    if (cuota > 0 && grupo.consumoPeriodo >= cuota)
+        estrangular(id, reloj);
+    return true;
+}
+
+bool Grupos::fijarPeso(uint32_t id, int peso) {
+    if (id >= grupos.size() || peso < 1 || peso > PESO_MAXIMO)
+        return false;
+    // Solo cambia lo que se cobra de aqui en adelante
+    grupos[id].peso = peso;
+    return true;
+}
+
+bool Grupos::fijarPorDefecto(uint32_t id) {
+    if (id >= grupos.size())
+        return false;
+    grupoPorDefecto = id;
+    return true;
+}
+
+void Grupos::asignar(PCB& proceso) const {
+    if (proceso.grupo == RAIZ || proceso.grupo >= grupos.size())
+        proceso.grupo = grupoPorDefecto;
+}
+
+// Sube por la ruta hasta la raiz o hasta el primer grupo estrangulado, que no
+// cuenta para su padre
+void Grupos::encolado(uint32_t id) {
+    ++encolados;
+    Grupo& propio = grupos[id];
+    if (propio.listos++ == 0)
+        propio.vpropio = max(propio.vpropio, propio.vminimo);
+    for (;;) {
+        Grupo& grupo = grupos[id];
+        bool despierta = grupo.pendientes++ == 0;
+        if (grupo.estrangulado || grupo.padre == NINGUNO)
+            break;
+        if (despierta)
+            grupo.vruntime = max(grupo.vruntime, grupos[grupo.padre].vminimo);
+        id = grupo.padre;
+    }
+}
+
+void Grupos::retirado(uint32_t id) {
+    --encolados;
+    --grupos[id].listos;
+    for (;;) {
+        Grupo& grupo = grupos[id];
+        --grupo.pendientes;
+        if (grupo.estrangulado || grupo.padre == NINGUNO)
+            break;
+        id = grupo.padre;
+    }
+}
+
+// Baja desde la raiz por la entidad de menor tiempo virtual; a igual tiempo, los
+// procesos propios y despues el hijo creado primero
+uint32_t Grupos::elegir() {
+    if (!hayElegibles())
+        return NINGUNO;
+    uint32_t id = RAIZ;
+    for (;;) {
+        Grupo& grupo = grupos[id];
+        uint32_t mejor = grupo.listos > 0 ? id : NINGUNO;
+        long long menor = grupo.vpropio;
+        for (uint32_t hijo : grupo.hijos) {
+            const Grupo& candidato = grupos[hijo];
+            if (candidato.estrangulado || candidato.pendientes == 0)
+                continue;
+            if (mejor == NINGUNO || candidato.vruntime < menor) {
+                mejor = hijo;
+                menor = candidato.vruntime;
+            }
+        }
+        // pendientes > 0 sin estrangular garantiza un candidato
+        grupo.vminimo = max(grupo.vminimo, menor);
+        if (mejor == id)
+            return id;
+        id = mejor;
+    }
+}
+
+void Grupos::interrumpir(PCB* proceso, int rebanada) {
+    Grupo& grupo = grupos[proceso->grupo];
+    grupo.interrumpido = proceso;
+    grupo.rebanadaInterrumpida = rebanada;
+    encolado(proceso->grupo);
+}
+
+PCB* Grupos::reanudar(uint32_t id, int& rebanada) {
+    PCB* proceso = grupos[id].interrumpido;
+    if (!proceso)
+        return nullptr;
+    grupos[id].interrumpido = nullptr;
+    rebanada = grupos[id].rebanadaInterrumpida;
+    retirado(id);
+    return proceso;
+}
+
+void Grupos::renovar(Grupo& grupo, long long reloj) {
+    if (reloj < grupo.finPeriodo)
+        return;
+    grupo.consumoPeriodo = 0;
+    grupo.finPeriodo = (reloj / grupo.periodo + 1) * grupo.periodo;
+}
+
+long long Grupos::margen(const PCB& proceso, long long reloj) {
+    long long margen = LLONG_MAX;
+    for (uint32_t id = proceso.grupo; id != NINGUNO; id = grupos[id].padre) {
+        Grupo& grupo = grupos[id];
+        if (grupo.cuota == 0)
+            continue;
+        renovar(grupo, reloj);
+        margen = min({margen, grupo.cuota - grupo.consumoPeriodo, grupo.finPeriodo - reloj});
+    }
+    return margen;
+}
+
+void Grupos::cobrar(const PCB& proceso, long long ticks, long long reloj) {
+    grupos[proceso.grupo].vpropio += ticks * ESCALA / PESO_BASE;
+    for (uint32_t id = proceso.grupo; id != RAIZ; id = grupos[id].padre)
+        grupos[id].vruntime += ticks * ESCALA / grupos[id].peso;
+    for (uint32_t id = proceso.grupo; id != NINGUNO; id = grupos[id].padre) {
+        Grupo& grupo = grupos[id];
+        grupo.consumo += (uint64_t) ticks;
+        if (grupo.cuota == 0)
+            continue;
+        grupo.consumoPeriodo += ticks;
+        if (grupo.consumoPeriodo >= grupo.cuota && !grupo.estrangulado)
+            estrangular(id, reloj);
+    }
+}
+
+void Grupos::estrangular(uint32_t id, long long reloj) {
+    Grupo& grupo = grupos[id];
+    grupo.estrangulado = true;
+    grupo.desde = reloj;
+    ++grupo.estrangulamientos;
+    recargas.insertar(id, grupo.finPeriodo);
+    recalcular();
+}
+
+void Grupos::recargar(long long reloj) {
+    if (recargas.vacio() || grupos[recargas.tope()].finPeriodo > reloj)
+        return;
+    while (!recargas.vacio() && grupos[recargas.tope()].finPeriodo <= reloj) {
+        Grupo& grupo = grupos[recargas.extraer()];
+        grupo.estrangulado = false;
+        grupo.ticksEstrangulado += (uint64_t) max(0LL, grupo.finPeriodo - grupo.desde);
+        grupo.consumoPeriodo = 0;
+        grupo.finPeriodo = (reloj / grupo.periodo + 1) * grupo.periodo;
+        if (grupo.padre != NINGUNO)
+            grupo.vruntime = max(grupo.vruntime, grupos[grupo.padre].vminimo);
+    }
+    recalcular();
+}
+
+// Los padres van antes que sus hijos: una pasada hacia adelante para los
+// bloqueadores y otra hacia atras para los pendientes de cada subarbol
+void Grupos::recalcular() {
+    for (Grupo& grupo : grupos) {
+        const Grupo* padre = grupo.padre == NINGUNO ? nullptr : &grupos[grupo.padre];
+        uint32_t propio = (uint32_t) (&grupo - grupos.data());
+        grupo.bloqueador = grupo.estrangulado ? propio : padre ? padre->bloqueador : NINGUNO;
+        grupo.pendientes = grupo.listos;
+    }
+    for (size_t id = grupos.size() - 1; id > RAIZ; --id) {
+        const Grupo& grupo = grupos[id];
+        if (!grupo.estrangulado)
+            grupos[grupo.padre].pendientes += grupo.pendientes;
+    }
+}
+
+ConsumoGrupo Grupos::consumo(uint32_t id) const {
+    const Grupo& grupo = grupos[id];
+    ConsumoGrupo c;
+    c.nombre = grupo.nombre;
+    c.cuota = grupo.cuota;
+    c.periodo = grupo.periodo;
+    c.peso = grupo.peso;
+    c.consumo = grupo.consumo;
+    c.consumoPeriodo = grupo.consumoPeriodo;
+    c.estrangulamientos = grupo.estrangulamientos;
+    c.ticksEstrangulado = grupo.ticksEstrangulado;
+    c.estrangulado = grupo.estrangulado;
+    c.retenidos = grupo.estrangulado ? grupo.pendientes : 0;
+    return c;
+}
+
+void Grupos::listar() const {
+    cout << "=== Grupos (procesos nuevos en: " << grupos[grupoPorDefecto].nombre << ") ===" << endl;
+    for (uint32_t id = 0; id < grupos.size(); ++id) {
+        int profundidad = 0;
+        for (uint32_t p = grupos[id].padre; p != NINGUNO; p = grupos[p].padre) ++profundidad;
+        ConsumoGrupo c = consumo(id);
+        cout << string(2 + 2 * profundidad, ' ') << left << setw(12) << c.nombre << right << " cuota: ";
+        if (c.cuota > 0)
+            cout << c.cuota << "/" << c.periodo << " (usado " << c.consumoPeriodo << ")";
+        else
+            cout << "sin limite";
+        cout << " | peso " << c.peso << " | consumo " << c.consumo << " ticks | estrangulado "
+             << c.estrangulamientos << " veces, " << c.ticksEstrangulado << " ticks";
+        if (c.estrangulado)
+            cout << " [ESTRANGULADO, " << c.retenidos << " retenidos]";
+        cout << endl;
+    }
+}
+
+void Grupos::guardar(instantanea::Escritor& escritor) const {
+    escritor.valor<uint64_t>(grupos.size());
+    for (const Grupo& grupo : grupos) {
+        escritor.texto(grupo.nombre);
+        escritor.valor(grupo.padre);
+        escritor.valor(grupo.cuota);
+        escritor.valor(grupo.periodo);
+        escritor.valor(grupo.peso);
+        escritor.valor(grupo.finPeriodo);
+        escritor.valor(grupo.consumoPeriodo);
+        escritor.valor(grupo.estrangulado);
+        escritor.valor(grupo.desde);
+        escritor.valor(grupo.consumo);
+        escritor.valor(grupo.estrangulamientos);
+        escritor.valor(grupo.ticksEstrangulado);
+        escritor.valor(grupo.vruntime);
+        escritor.valor(grupo.vpropio);
+        escritor.valor(grupo.vminimo);
+        escritor.valor<uint64_t>(grupo.listos);
+        escritor.valor(TablaProcesos::indiceDe(grupo.interrumpido));
+        escritor.valor(grupo.rebanadaInterrumpida);
+    }
+    escritor.valor(grupoPorDefecto);
+}
+
+void Grupos::cargar(instantanea::Lector& lector, TablaProcesos& tabla) {
+    uint64_t cantidad = lector.valor<uint64_t>();
+    if (cantidad < 1 || cantidad > UINT32_MAX)
+        throw runtime_error("grupos inconsistentes");
+    grupos.clear();
+    recargas = MonticuloDario<4>();
+    encolados = 0;
+    for (uint64_t id = 0; id < cantidad; ++id) {
+        Grupo grupo;
+        grupo.nombre = lector.texto();
+        grupo.padre = lector.valor<uint32_t>();
+        grupo.cuota = lector.valor<long long>();
+        grupo.periodo = lector.valor<long long>();
+        grupo.peso = lector.valor<int>();
+        grupo.finPeriodo = lector.valor<long long>();
+        grupo.consumoPeriodo = lector.valor<long long>();
+        grupo.estrangulado = lector.valor<bool>();
+        grupo.desde = lector.valor<long long>();
+        grupo.consumo = lector.valor<uint64_t>();
+        grupo.estrangulamientos = lector.valor<uint64_t>();
+        grupo.ticksEstrangulado = lector.valor<uint64_t>();
+        grupo.vruntime = lector.valor<long long>();
+        grupo.vpropio = lector.valor<long long>();
+        grupo.vminimo = lector.valor<long long>();
+        grupo.listos = (size_t) lector.valor<uint64_t>();
+        grupo.interrumpido = tabla.ranura(lector.valor<uint32_t>());
+        grupo.rebanadaInterrumpida = lector.valor<int>();
+        if ((id == RAIZ) != (grupo.padre == NINGUNO) || (id > 0 && grupo.padre >= id) || grupo.periodo < 1
+            || grupo.peso < 1 || grupo.peso > PESO_MAXIMO || grupo.listos > tabla.ranuras()
+            || (grupo.interrumpido && (grupo.interrumpido->grupo != id || grupo.listos == 0
+                                       || grupo.interrumpido->estado() != EstadoProceso::Listo
+                                       || grupo.rebanadaInterrumpida < 1)))
+            throw runtime_error("grupos inconsistentes");
+        if (id > 0)
+            grupos[grupo.padre].hijos.push_back((uint32_t) id);
+        encolados += grupo.listos;
+        if (grupo.estrangulado)
+            recargas.insertar((uint32_t) id, grupo.finPeriodo);
+        grupos.push_back(move(grupo));
+    }
+    grupoPorDefecto = lector.valor<uint32_t>();
+    if (grupoPorDefecto >= grupos.size())
+        throw runtime_error("grupos inconsistentes");
+    recalcular();
+}
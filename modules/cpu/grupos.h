@@ -0,0 +1,138 @@
+#pragma once
+#include "pcb.h"
+#include "tabla_procesos.h"
+#include "monticulo.h"
+#include <climits>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Contadores de un grupo para consultas (`cgroup`)
+struct ConsumoGrupo {
+    string nombre;
+    long long cuota = 0;           // 0 = sin limite
+    long long periodo = 0;
+    int peso = 0;
+    uint64_t consumo = 0;          // ticks de CPU de todo el subarbol desde su creacion
+    long long consumoPeriodo = 0;  // en el periodo en curso
+    uint64_t estrangulamientos = 0;
+    uint64_t ticksEstrangulado = 0;
+    bool estrangulado = false;
+    size_t retenidos = 0;          // procesos listos esperando la recarga
+};
+
+// Grupos de control de CPU (al estilo de los cgroups): cada proceso pertenece a un
+// grupo y los grupos forman un arbol bajo la raiz. Un grupo con cuota puede usar a
+// lo sumo `cuota` ticks por `periodo` (ventanas alineadas a multiplos del periodo),
+// contando lo que consume todo su subarbol; al agotarla queda estrangulado hasta el
+// fin del periodo.
+//
+// Cada grupo tiene su propia cola de listos (en el planificador, con la politica
+// activa) y el reparto se decide antes que la politica: bajando desde la raiz, en
+// cada nivel corre la entidad de menor tiempo virtual entre los hijos elegibles y
+// los procesos propios del grupo, que compiten como una entidad mas de peso
+// PESO_BASE. Correr `t` ticks avanza el tiempo virtual de cada grupo de la ruta en
+// t * ESCALA / peso, asi que los hermanos reciben CPU en proporcion a su peso sin
+// importar cuantos procesos tengan ni si la politica es de rebanada (round robin,
+// CFS) o corre hasta el final (FIFO, SJF, prioridad). Una entidad que vuelve a
+// tener trabajo entra en el minimo de su nivel: no acumula credito estando vacia.
+//
+// Un grupo estrangulado no es elegible y se salta en O(1): cada grupo lleva los
+// listos de su subarbol alcanzables sin cruzar un grupo estrangulado (al encolar y
+// retirar se actualiza la ruta; al estrangular o recargar se recalcula todo).
+class Grupos {
+public:
+    static constexpr uint32_t RAIZ = 0;
+    static constexpr uint32_t NINGUNO = UINT32_MAX;
+    static constexpr int PESO_BASE = 1024;
+    static constexpr int PESO_MAXIMO = 262144;  // como las cpu.shares de Linux
+    static constexpr long long ESCALA = 1LL << 20;
+
+    Grupos();
+
+    optional<uint32_t> crear(const string& nombre, uint32_t padre);
+    uint32_t buscar(const string& nombre) const; // NINGUNO si no existe
+    // cuota 0 quita el limite; si lo ya consumido en el periodo la agota, estrangula ahora
+    bool fijarCuota(uint32_t id, long long cuota, long long periodo, long long reloj);
+    bool fijarPeso(uint32_t id, int peso);  // 1 <= peso <= PESO_MAXIMO
+    // Grupo de los procesos nuevos cuyo programa no trae uno
+    bool fijarPorDefecto(uint32_t id);
+    uint32_t porDefecto() const { return grupoPorDefecto; }
+
+    // Con solo la raiz, el planificador no hace ningun trabajo extra
+    bool activos() const { return grupos.size() > 1; }
+    void asignar(PCB& proceso) const;
+
+    // Ciclo de despacho. El planificador avisa cada proceso que entra o sale de la
+    // cola de un grupo (tambien sin grupos activos: con solo la raiz es O(1))
+    void encolado(uint32_t id);
+    void retirado(uint32_t id);
+    // Grupo cuya cola corre ahora; NINGUNO si todo lo encolado esta estrangulado
+    uint32_t elegir();
+    // Proceso que dejo la CPU al terminar el turno de su grupo: vuelve antes que la
+    // cola, con lo que le quedaba de rebanada. reanudar da nulo si no hay ninguno
+    void interrumpir(PCB* proceso, int rebanada);
+    PCB* reanudar(uint32_t id, int& rebanada);
+    PCB* interrumpido(uint32_t id) const { return grupos[id].interrumpido; }
+    // true si el grupo o un ancestro esta estrangulado
+    bool bloqueado(uint32_t id) const { return grupos[id].bloqueador != NINGUNO; }
+    bool bloqueado(const PCB& proceso) const { return bloqueado(proceso.grupo); }
+    // Ticks que el proceso puede correr sin pasar una cuota ni un fin de periodo
+    long long margen(const PCB& proceso, long long reloj);
+    void cobrar(const PCB& proceso, long long ticks, long long reloj);
+    bool hayEncolados() const { return encolados > 0; }
+    bool hayElegibles() const { return !grupos[RAIZ].estrangulado && grupos[RAIZ].pendientes > 0; }
+    bool hayRetenidos() const { return encolados > (hayElegibles() ? grupos[RAIZ].pendientes : 0); }
+    long long proximaRecarga() const { return recargas.vacio() ? LLONG_MAX : grupos[recargas.tope()].finPeriodo; }
+    // Recarga los grupos cuyo periodo termino hasta `reloj`; sus colas vuelven a ser elegibles
+    void recargar(long long reloj);
+
+    size_t listos(uint32_t id) const { return grupos[id].listos; }
+    size_t cantidad() const { return grupos.size(); }
+    ConsumoGrupo consumo(uint32_t id) const;
+    void listar() const;
+
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector, TablaProcesos& tabla);
+
+private:
+    struct Grupo {
+        string nombre;
+        uint32_t padre = NINGUNO;
+        long long cuota = 0;
+        long long periodo = 100;
+        int peso = PESO_BASE;
+
+        vector<uint32_t> hijos;
+        uint32_t bloqueador = NINGUNO; // grupo estrangulado mas cercano en la ruta
+
+        long long vruntime = 0;        // del grupo frente a sus hermanos
+        long long vpropio = 0;         // de sus propios procesos frente a sus hijos
+        long long vminimo = 0;         // lo ultimo elegido en este nivel; nadie entra por debajo
+        size_t listos = 0;             // en la cola propia, con el interrumpido
+        size_t pendientes = 0;         // listos del subarbol sin cruzar un estrangulado
+        PCB* interrumpido = nullptr;
+        int rebanadaInterrumpida = 0;
+
+        long long finPeriodo = 0;
+        long long consumoPeriodo = 0;
+        bool estrangulado = false;
+        long long desde = 0;           // tick en que quedo estrangulado
+
+        uint64_t consumo = 0;
+        uint64_t estrangulamientos = 0;
+        uint64_t ticksEstrangulado = 0;
+    };
+
+    void renovar(Grupo& grupo, long long reloj);
+    void estrangular(uint32_t id, long long reloj);
+    void recalcular();
+
+    vector<Grupo> grupos;          // un padre siempre va antes que sus hijos
+    MonticuloDario<4> recargas;    // grupos estrangulados, por fin de periodo
+    size_t encolados = 0;          // en todas las colas, elegibles o no
+    uint32_t grupoPorDefecto = RAIZ;
+};
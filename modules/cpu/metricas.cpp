@@ -0,0 +1,218 @@
+#include "metricas.h"
+#include "energia.h"
+#include "../snapshot/instantanea.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iomanip>
+
+// Histograma
+
+int Histograma::cubeta(uint64_t valor) {
+    int corrimiento = max(0, (int) bit_width(valor) - BITS_SUB);
+    return corrimiento * MEDIO + (int) (valor >> corrimiento);
+}
+
+uint64_t Histograma::techo(int indice) {
+    int corrimiento = indice < SUB ? 0 : indice / MEDIO - 1;
+    uint64_t base = (uint64_t) (indice - corrimiento * MEDIO);
+    return ((base + 1) << corrimiento) - 1;
+}
+
+void Histograma::registrar(uint64_t valor) {
+    ++conteos[cubeta(valor)];
+    ++total;
+    suma += valor;
+    mayor = std::max(mayor, valor);
+}
+
+void Histograma::combinar(const Histograma& otro) {
+    for (int i = 0; i < CUBETAS; ++i)
+        conteos[i] += otro.conteos[i];
+    total += otro.total;
+    suma += otro.suma;
+    mayor = std::max(mayor, otro.mayor);
+}
+
+uint64_t Histograma::percentil(double p) const {
+    if (total == 0)
+        return 0;
+    uint64_t objetivo = (uint64_t) (p * total + 0.5);
+    objetivo = clamp<uint64_t>(objetivo, 1, total);
+    uint64_t acumulado = 0;
+    for (int i = 0; i < CUBETAS; ++i) {
+        acumulado += conteos[i];
+        if (acumulado >= objetivo)
+            return std::min(techo(i), mayor);
+    }
+    return mayor;
+}
+
+void Histograma::guardar(instantanea::Escritor& escritor) const {
+    escritor.arreglo(conteos);
+    escritor.valor(total);
+    escritor.valor(suma);
+    escritor.valor(mayor);
+}
+
+void Histograma::cargar(instantanea::Lector& lector) {
+    lector.arreglo(conteos);
+    if (conteos.size() != CUBETAS)
+        throw runtime_error("histograma con otra cantidad de cubetas");
+    total = lector.valor<uint64_t>();
+    suma = lector.valor<uint64_t>();
+    mayor = lector.valor<uint64_t>();
+}
+
+// Metricas
+
+void Metricas::registrarPrimeraEjecucion(PCB& proceso, long long reloj) {
+    if (proceso.primeraEjecucion >= 0)
+        return;
+    proceso.primeraEjecucion = reloj;
+    respuesta.registrar((uint64_t) (reloj - proceso.llegada));
+}
+
+void Metricas::registrarTerminacion(const PCB& proceso, long long reloj) {
+    long long vuelta = reloj - proceso.llegada;
+    retorno.registrar((uint64_t) vuelta);
+    espera.registrar((uint64_t) max(0LL, vuelta - proceso.tiempoEjecucion - proceso.tiempoES() - proceso.tiempoDormido()));
+    ++terminados;
+    ultimaTerminacion = max(ultimaTerminacion, reloj);
+}
+
+void Metricas::combinar(const Metricas& otras) {
+    retorno.combinar(otras.retorno);
+    espera.combinar(otras.espera);
+    respuesta.combinar(otras.respuesta);
+    if (cambiosContexto.size() < otras.cambiosContexto.size())
+        cambiosContexto.resize(otras.cambiosContexto.size(), 0);
+    for (size_t i = 0; i < otras.cambiosContexto.size(); ++i)
+        cambiosContexto[i] += otras.cambiosContexto[i];
+    terminados += otras.terminados;
+    ticksOcupado += otras.ticksOcupado;
+    ticksCambio += otras.ticksCambio;
+    ticksOcupadoES += otras.ticksOcupadoES;
+    ticksSolapados += otras.ticksSolapados;
+    solicitudesES += otras.solicitudesES;
+    ticksEncendido += otras.ticksEncendido;
+    energia += otras.energia;
+    ultimaTerminacion = max(ultimaTerminacion, otras.ultimaTerminacion);
+}
+
+void Metricas::imprimir(ostream& os, long long reloj) const {
+    auto fila = [&](const char* nombre, const Histograma& h) {
+        os << "  " << left << setw(10) << nombre << right
+           << " p50=" << setw(8) << h.percentil(0.50)
+           << " p95=" << setw(8) << h.percentil(0.95)
+           << " p99=" << setw(8) << h.percentil(0.99)
+           << " max=" << setw(8) << h.maximo()
+           << " media=" << fixed << setprecision(1) << h.media() << "\n";
+    };
+
+    uint64_t capacidad = (uint64_t) max(1LL, reloj) * cambiosContexto.size();
+    os << "=== Estadisticas (reloj: " << reloj << " ticks) ===\n";
+    os << "  terminados: " << terminados
+       << " | utilizacion: " << fixed << setprecision(1) << 100.0 * ticksOcupado / capacidad << "%"
+       << " | rendimiento: " << setprecision(2) << 1000.0 * terminados / max(1LL, reloj) << " por 1000 ticks\n";
+    if (solicitudesES > 0)
+        os << "  E/S: " << solicitudesES << " solicitudes | utilizacion: " << setprecision(1)
+           << 100.0 * ticksOcupadoES / max(1LL, reloj) << "% | solapada con CPU: "
+           << 100.0 * ticksSolapados / max<uint64_t>(1, ticksOcupadoES) << "%\n";
+    fila("retorno", retorno);
+    fila("espera", espera);
+    fila("respuesta", respuesta);
+    os << "  cambios de contexto:";
+    for (size_t i = 0; i < cambiosContexto.size(); ++i)
+        os << " [nucleo " << i << "] " << cambiosContexto[i];
+    os << "\n";
+    if (ticksCambio > 0)
+        os << "  sobrecosto de cambios: " << ticksCambio << " ticks | " << setprecision(1)
+           << 100.0 * ticksCambio / capacidad << "% del tiempo total, "
+           << 100.0 * ticksCambio / (ticksCambio + ticksOcupado) << "% del tiempo de CPU\n";
+    if (energia > 0) {
+        // Potencia media sobre el tiempo encendido de la maquina (no de cada nucleo)
+        double julios = energia / 1e6;
+        double segundos = (double) ticksEncendido / cambiosContexto.size() * MS_POR_TICK / 1000.0;
+        os << "  energia: " << setprecision(3) << julios << " J | potencia media: " << setprecision(2)
+           << (segundos > 0 ? julios / segundos : 0.0) << " W | " << setprecision(1)
+           << (julios > 0 ? terminados / julios : 0.0) << " procesos por joule\n";
+    }
+    if (quantum.activo) {
+        os << "  quantum adaptativo: p" << lround(quantum.percentil * 100) << " -> " << quantum.actual
+           << " (entre " << quantum.minimo << " y " << quantum.maximo << ") | " << quantum.decisiones
+           << " decisiones, " << quantum.cambios << " cambios | sobrecosto: " << setprecision(1)
+           << (double) quantum.nsSobrecosto / max<uint64_t>(1, quantum.observaciones) << " ns por rafaga ("
+           << quantum.observaciones << " rafagas)\n";
+    } else if (quantum.actual > 0) {
+        os << "  quantum: " << quantum.actual << " (fijo)\n";
+    }
+}
+
+void Metricas::volcarJSON(ostream& os, long long reloj) const {
+    auto histograma = [&](const char* nombre, const Histograma& h) {
+        os << "  \"" << nombre << "\": {\"cuenta\": " << h.cuenta()
+           << ", \"p50\": " << h.percentil(0.50)
+           << ", \"p95\": " << h.percentil(0.95)
+           << ", \"p99\": " << h.percentil(0.99)
+           << ", \"max\": " << h.maximo()
+           << ", \"media\": " << h.media() << "},\n";
+    };
+
+    os << "{\n";
+    os << "  \"reloj\": " << reloj << ",\n";
+    os << "  \"terminados\": " << terminados << ",\n";
+    os << "  \"ticks_ocupado\": " << ticksOcupado << ",\n";
+    os << "  \"ticks_cambio\": " << ticksCambio << ",\n";
+    os << "  \"ticks_ocupado_es\": " << ticksOcupadoES << ",\n";
+    os << "  \"ticks_solapados\": " << ticksSolapados << ",\n";
+    os << "  \"solicitudes_es\": " << solicitudesES << ",\n";
+    os << "  \"ticks_encendido\": " << ticksEncendido << ",\n";
+    os << "  \"energia_uj\": " << energia << ",\n";
+    histograma("retorno", retorno);
+    histograma("espera", espera);
+    histograma("respuesta", respuesta);
+    os << "  \"cambios_contexto\": [";
+    for (size_t i = 0; i < cambiosContexto.size(); ++i)
+        os << (i ? ", " : "") << cambiosContexto[i];
+    os << "],\n";
+    os << "  \"quantum\": {\"adaptativo\": " << (quantum.activo ? "true" : "false")
+       << ", \"actual\": " << quantum.actual
+       << ", \"percentil\": " << quantum.percentil
+       << ", \"observaciones\": " << quantum.observaciones
+       << ", \"decisiones\": " << quantum.decisiones
+       << ", \"cambios\": " << quantum.cambios
+       << ", \"ns_sobrecosto\": " << quantum.nsSobrecosto << "}\n}\n";
+}
+
+void Metricas::guardar(instantanea::Escritor& escritor) const {
+    retorno.guardar(escritor);
+    espera.guardar(escritor);
+    respuesta.guardar(escritor);
+    escritor.arreglo(cambiosContexto);
+    escritor.valor(terminados);
+    escritor.valor(ticksOcupado);
+    escritor.valor(ticksCambio);
+    escritor.valor(ticksOcupadoES);
+    escritor.valor(ticksSolapados);
+    escritor.valor(solicitudesES);
+    escritor.valor(ticksEncendido);
+    escritor.valor(energia);
+    escritor.valor(ultimaTerminacion);
+}
+
+void Metricas::cargar(instantanea::Lector& lector) {
+    retorno.cargar(lector);
+    espera.cargar(lector);
+    respuesta.cargar(lector);
+    lector.arreglo(cambiosContexto);
+    terminados = lector.valor<uint64_t>();
+    ticksOcupado = lector.valor<uint64_t>();
+    ticksCambio = lector.valor<uint64_t>();
+    ticksOcupadoES = lector.valor<uint64_t>();
+    ticksSolapados = lector.valor<uint64_t>();
+    solicitudesES = lector.valor<uint64_t>();
+    ticksEncendido = lector.valor<uint64_t>();
+    energia = lector.valor<uint64_t>();
+    ultimaTerminacion = lector.valor<long long>();
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "pcb.h"
+#include "control_quantum.h"
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+using namespace std;
+
+namespace instantanea { class Escritor; class Lector; }
+
+// Histograma log-lineal al estilo HDR: valores exactos por debajo de 32 y, por encima,
+// 16 sub-cubetas por potencia de dos (error relativo < 6.25%). Registrar es O(1)
+// y sin reservas de memoria; los percentiles recorren ~1000 cubetas.
+class Histograma {
+public:
+    void registrar(uint64_t valor);
+    void combinar(const Histograma& otro);
+
+    // Valor (cota superior de su cubeta) bajo el cual cae la fraccion p de las muestras
+    uint64_t percentil(double p) const;
+    uint64_t cuenta() const { return total; }
+    uint64_t maximo() const { return mayor; }
+    double media() const { return total ? (double) suma / total : 0.0; }
+
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector);
+
+private:
+    static constexpr int BITS_SUB = 5;
+    static constexpr int SUB = 1 << BITS_SUB;     // 32
+    static constexpr int MEDIO = SUB / 2;         // 16
+    static constexpr int CUBETAS = (64 - BITS_SUB + 1) * MEDIO + MEDIO;
+
+    static int cubeta(uint64_t valor);
+    static uint64_t techo(int indice);
+
+    vector<uint64_t> conteos = vector<uint64_t>(CUBETAS, 0);
+    uint64_t total = 0;
+    uint64_t suma = 0;
+    uint64_t mayor = 0;
+};
+
+// Metricas del planificador, en ticks simulados:
+//   retorno   = terminacion - llegada          (turnaround)
+//   espera    = retorno - rafagas pedidas      (waiting)
+//   respuesta = primera ejecucion - llegada    (response)
+struct Metricas {
+    Histograma retorno;
+    Histograma espera;
+    Histograma respuesta;
+    vector<uint64_t> cambiosContexto = vector<uint64_t>(1, 0); // por nucleo
+    uint64_t terminados = 0;
+    uint64_t ticksOcupado = 0;
+    uint64_t ticksCambio = 0;     // CPU ocupada en cambios de contexto (costo fijo y cache fria)
+    uint64_t ticksOcupadoES = 0;  // el dispositivo de E/S atendiendo una solicitud
+    uint64_t ticksSolapados = 0;  // CPU y E/S ocupadas a la vez
+    uint64_t solicitudesES = 0;
+    uint64_t ticksEncendido = 0;  // ticks simulados con trabajo en el sistema, sumados por nucleo
+    uint64_t energia = 0;         // microjoules (ver energia.h)
+    long long ultimaTerminacion = 0; // tick de la ultima terminacion (makespan)
+    ResumenQuantum quantum;          // lo completa la CPU; no se combina ni se guarda
+
+    void registrarPrimeraEjecucion(PCB& proceso, long long reloj);
+    void registrarTerminacion(const PCB& proceso, long long reloj);
+    void combinar(const Metricas& otras);
+
+    void imprimir(ostream& os, long long reloj) const;
+    void volcarJSON(ostream& os, long long reloj) const;
+
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector);
+};
@@ -0,0 +1,105 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Monticulo d-ario indexado sobre identificadores enteros pequeños [0, n).
+// Con D = 4 el arbol tiene la mitad de niveles que uno binario y los D hijos de un
+// nodo quedan contiguos en memoria. Cada id guarda su posicion, asi que borrar o
+// cambiar la clave de cualquier id es O(log_D n). Menor clave = mas urgente;
+// los empates se resuelven por id.
+template <int D>
+class MonticuloDario {
+public:
+    bool vacio() const { return datos.empty(); }
+    size_t tamano() const { return datos.size(); }
+    uint32_t tope() const { return datos.front(); }
+    bool contiene(uint32_t id) const { return id < posicion.size() && posicion[id] != AUSENTE; }
+
+    void insertar(uint32_t id, long long clave) {
+        if (id >= posicion.size()) {
+            posicion.resize(id + 1, AUSENTE);
+            claves.resize(id + 1);
+        }
+        claves[id] = clave;
+        posicion[id] = datos.size();
+        datos.push_back(id);
+        subir(datos.size() - 1);
+    }
+
+    uint32_t extraer() {
+        uint32_t id = datos.front();
+        borrar(id);
+        return id;
+    }
+
+    void borrar(uint32_t id) {
+        size_t i = posicion[id];
+        posicion[id] = AUSENTE;
+        uint32_t ultimo = datos.back();
+        datos.pop_back();
+        if (i == datos.size())
+            return;
+        datos[i] = ultimo;
+        posicion[ultimo] = i;
+        subir(i);
+        bajar(posicion[ultimo]);
+    }
+
+    void cambiarClave(uint32_t id, long long clave) {
+        claves[id] = clave;
+        subir(posicion[id]);
+        bajar(posicion[id]);
+    }
+
+    template <typename F>
+    void recorrer(F f) const {
+        for (uint32_t id : datos) f(id);
+    }
+
+private:
+    static constexpr size_t AUSENTE = SIZE_MAX;
+
+    bool menor(uint32_t a, uint32_t b) const {
+        return claves[a] != claves[b] ? claves[a] < claves[b] : a < b;
+    }
+
+    void subir(size_t i) {
+        uint32_t id = datos[i];
+        while (i > 0) {
+            size_t padre = (i - 1) / D;
+            if (!menor(id, datos[padre]))
+                break;
+            datos[i] = datos[padre];
+            posicion[datos[i]] = i;
+            i = padre;
+        }
+        datos[i] = id;
+        posicion[id] = i;
+    }
+
+    void bajar(size_t i) {
+        uint32_t id = datos[i];
+        for (;;) {
+            size_t primero = i * D + 1;
+            if (primero >= datos.size())
+                break;
+            size_t fin = std::min(primero + D, datos.size());
+            size_t mejor = primero;
+            for (size_t hijo = primero + 1; hijo < fin; ++hijo)
+                if (menor(datos[hijo], datos[mejor]))
+                    mejor = hijo;
+            if (!menor(datos[mejor], id))
+                break;
+            datos[i] = datos[mejor];
+            posicion[datos[i]] = i;
+            i = mejor;
+        }
+        datos[i] = id;
+        posicion[id] = i;
+    }
+
+    std::vector<uint32_t> datos;     // el monticulo, por posicion
+    std::vector<size_t> posicion;    // por id
+    std::vector<long long> claves;   // por id
+};
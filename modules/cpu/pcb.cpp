@@ -1,19 +1,154 @@
 #include <iostream>
 #include <algorithm> // Para std::min
 #include "pcb.h"
+#include "tabla_procesos.h"
+#include "../snapshot/instantanea.h"
+#include "../mem/slab.h"
 
-PCB::PCB(const string &name, int tiempoEjecucion)
-    : name(name), tiempoEjecucion(tiempoEjecucion) {}
+ostream& operator<<(ostream& os, const Pid& pid) {
+    if (pid.indice >= BASE_PID_TIEMPO_REAL)
+        return os << "rt" << pid.indice - BASE_PID_TIEMPO_REAL;
+    return os << pid.indice << ":" << pid.generacion;
+}
+
+PCB::PCB(const string &name, int tiempoEjecucion, int prioridad)
+    : name(name), tiempoEjecucion(tiempoEjecucion), prioridad(prioridad) {}
+
+void* PCB::operator new(size_t tamano) {
+    return slab::asignar<PCB>("pcb", tamano);
+}
+
+void PCB::operator delete(void* p) {
+    slab::liberar<PCB>("pcb", p);
+}
+
+int& PCB::restante() {
+    return tabla ? tabla->restante[pid.indice] : tiempoEjecucion;
+}
+
+int PCB::restante() const {
+    return tabla ? tabla->restante[pid.indice] : tiempoEjecucion;
+}
 
+int PCB::prioridadEfectiva() const {
+    return tabla ? tabla->prioridad[pid.indice] : prioridad;
+}
+
+EstadoProceso PCB::estado() const {
+    return tabla ? tabla->estado[pid.indice] : EstadoProceso::Libre;
+}
+
+void PCB::fijarEstado(EstadoProceso estado) {
+    if (tabla)
+        tabla->estado[pid.indice] = estado;
+}
+
+// La salida por consola la hace el sumidero de traza del planificador
 void PCB::ejecutar(int tick) { //Cambio parametro quantum -> tick
-    if (tiempoEjecucion > 0) {
-        int ejecutarAhora = min(tick, tiempoEjecucion);
-        tiempoEjecucion -= ejecutarAhora;
-        cout << "Proceso " << name << " ejecuta " << ejecutarAhora
-             << " unidades. Restante: " << tiempoEjecucion << endl;
+    int& tiempo = restante();
+    if (tiempo > 0) {
+        int ejecutarAhora = min(tick, tiempo);
+        tiempo -= ejecutarAhora;
     }
 }
 
+void PCB::fijarRafagas(const vector<Rafaga>& lista) {
+    rafagas.clear();
+    tiempoEjecucion = 0;
+    for (Rafaga rafaga : lista) {
+        rafaga.duracion = max(1, rafaga.duracion);
+        if (rafagas.empty() && rafaga.tipo != TipoRafaga::CPU)
+            rafagas.push_back({TipoRafaga::CPU, 1}); // siempre se empieza en CPU
+        // Dos rafagas seguidas de CPU son una sola
+        if (rafaga.tipo == TipoRafaga::CPU && !rafagas.empty() && rafagas.back().tipo == TipoRafaga::CPU)
+            rafagas.back().duracion += rafaga.duracion;
+        else
+            rafagas.push_back(rafaga);
+    }
+    // Una lista que termina fuera de la CPU se completa con una rafaga de CPU minima
+    if (!rafagas.empty() && rafagas.back().tipo != TipoRafaga::CPU)
+        rafagas.push_back({TipoRafaga::CPU, 1});
+    for (const Rafaga& rafaga : rafagas)
+        if (rafaga.tipo == TipoRafaga::CPU)
+            tiempoEjecucion += rafaga.duracion;
+}
+
+void PCB::fijarRafagas(const vector<int>& alternadas) {
+    vector<Rafaga> lista;
+    for (size_t i = 0; i < alternadas.size(); ++i)
+        lista.push_back({i % 2 == 0 ? TipoRafaga::CPU : TipoRafaga::ES, alternadas[i]});
+    fijarRafagas(lista);
+}
+
+static int sumarRafagas(const vector<Rafaga>& rafagas, TipoRafaga tipo) {
+    int total = 0;
+    for (const Rafaga& rafaga : rafagas)
+        if (rafaga.tipo == tipo)
+            total += rafaga.duracion;
+    return total;
+}
+
+int PCB::tiempoES() const {
+    return sumarRafagas(rafagas, TipoRafaga::ES);
+}
+
+int PCB::tiempoDormido() const {
+    return sumarRafagas(rafagas, TipoRafaga::Dormir);
+}
+
+bool PCB::avanzarRafaga() {
+    if (rafagaActual + 1 >= rafagas.size())
+        return false;
+    restante() = rafagas[++rafagaActual].duracion;
+    return true;
+}
+
 bool PCB::terminado() const {
-    return tiempoEjecucion <= 0;
+    return restante() <= 0 && rafagaActual + 1 >= rafagas.size();
+}
+
+RegistroPCB PCB::registro() const {
+    return {pid, tiempoEjecucion, prioridad, nice, periodo, plazo, (uint32_t) rafagaActual,
+            nucleoPrevio, tickets, despertar, vruntime, llegada, primeraEjecucion, salidaCPU, grupo, 0};
+}
+
+void PCB::restaurar(const RegistroPCB& r) {
+    pid = r.pid;
+    tiempoEjecucion = r.tiempoEjecucion;
+    prioridad = r.prioridad;
+    nice = r.nice;
+    periodo = r.periodo;
+    plazo = r.plazo;
+    rafagaActual = r.rafagaActual;
+    despertar = r.despertar;
+    vruntime = r.vruntime;
+    llegada = r.llegada;
+    primeraEjecucion = r.primeraEjecucion;
+    nucleoPrevio = r.nucleoPrevio;
+    tickets = r.tickets;
+    grupo = r.grupo;
+    salidaCPU = r.salidaCPU;
+}
+
+Rafaga RafagaGuardada::rafaga() const {
+    if (tipo > (uint8_t) TipoRafaga::Dormir)
+        throw runtime_error("rafaga de tipo desconocido");
+    return {(TipoRafaga) tipo, duracion};
+}
+
+void PCB::guardar(instantanea::Escritor& escritor) const {
+    escritor.valor(registro());
+    escritor.texto(name);
+    vector<RafagaGuardada> guardadas;
+    for (const Rafaga& rafaga : rafagas) guardadas.push_back(RafagaGuardada::de(rafaga));
+    escritor.arreglo(guardadas);
+}
+
+PCB PCB::cargar(instantanea::Lector& lector) {
+    RegistroPCB r = lector.valor<RegistroPCB>();
+    PCB programa(lector.texto(), 0);
+    programa.restaurar(r);
+    for (const RafagaGuardada& guardada : lector.vista<RafagaGuardada>())
+        programa.rafagas.push_back(guardada.rafaga());
+    return programa;
 }
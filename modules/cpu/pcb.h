@@ -1,17 +1,148 @@
 #pragma once
+#include <cstdint>
 #include <iostream>
 #include <string>
+#include <vector>
 
 using namespace std;
 
+class TablaProcesos;
+namespace instantanea { class Escritor; class Lector; }
+
+enum class EstadoProceso : uint8_t { Libre, Listo, Ejecutando, Bloqueado, Terminado };
+
+enum class TipoRafaga : uint8_t { CPU, ES, Dormir };
+
+struct Rafaga {
+    TipoRafaga tipo;
+    int duracion;
+};
+
+// Identificador generacional: el indice ubica la ranura en la tabla de procesos y la
+// generacion invalida los identificadores viejos cuando la ranura se reutiliza.
+struct Pid {
+    uint32_t indice = 0;
+    uint32_t generacion = 0;
+
+    bool operator==(const Pid&) const = default;
+};
+
+// Los pids de las tareas periodicas de tiempo real no son ranuras de la tabla de procesos
+constexpr uint32_t BASE_PID_TIEMPO_REAL = 0x80000000u;
+
+ostream& operator<<(ostream& os, const Pid& pid);
+
+// Campos frios de un PCB en una instantanea, de tamaño fijo para copiarlos en bloque.
+// El nombre y las rafagas van en arreglos aparte.
+struct RegistroPCB {
+    Pid pid;
+    int32_t tiempoEjecucion;
+    int32_t prioridad;
+    int32_t nice;
+    int32_t periodo;
+    int32_t plazo;
+    uint32_t rafagaActual;
+    int32_t nucleoPrevio;
+    int32_t tickets;
+    int64_t despertar;
+    int64_t vruntime;
+    int64_t llegada;
+    int64_t primeraEjecucion;
+    int64_t salidaCPU;
+    uint32_t grupo;
+    uint32_t reservado;
+};
+
+// Una rafaga en una instantanea. Rafaga tiene bytes de relleno sin inicializar entre
+// el tipo y la duracion; este registro los deja explicitos y en cero.
+struct RafagaGuardada {
+    uint8_t tipo;
+    uint8_t reservado[3];
+    int32_t duracion;
+
+    static RafagaGuardada de(const Rafaga& rafaga) { return {(uint8_t) rafaga.tipo, {}, rafaga.duracion}; }
+    // Lanza runtime_error si el tipo no es uno conocido
+    Rafaga rafaga() const;
+};
+
+// Un PCB suelto describe un programa (lo que guarda un archivo .exe).
+// Los procesos en ejecucion son PCB que viven en una TablaProcesos: ahi sus campos
+// calientes (tiempo restante, estado, prioridad efectiva) se guardan en arreglos
+// contiguos y tiempoEjecucion/prioridad quedan como los valores solicitados.
 class PCB {
 public:
+    Pid pid;
     string name;
-    int tiempoEjecucion;
+    int tiempoEjecucion; // total de CPU solicitado (suma de las rafagas de CPU)
+    int prioridad; // 0 = mas alta
+
+    // Rafagas de CPU, E/S o espera (sleep); empieza y termina en CPU.
+    // Vacia: una sola rafaga de CPU de tiempoEjecucion.
+    vector<Rafaga> rafagas;
+    size_t rafagaActual = 0; // mientras el proceso espera E/S, restante() es su E/S pendiente
+    long long despertar = 0; // tick en que vence su rafaga de espera
 
-    PCB(const string &name, int tiempoEjecucion);
+    int nice = 0;           // peso para CFS, en [-20, 19]
+    int tickets = 100;      // boletos para loteria y stride (reparto proporcional)
+    uint32_t grupo = 0;     // grupo de control de CPU (0: el grupo por defecto de la CPU)
+
+    // Tarea periodica de tiempo real si periodo > 0: cada periodo libera un trabajo de
+    // tiempoEjecucion ticks (WCET) con plazo relativo `plazo` (0 = igual al periodo)
+    int periodo = 0;
+    int plazo = 0;
+    long long vruntime = 0; // tiempo virtual de ejecucion (CFS; el pase en stride)
+
+    // Marcas de tiempo para metricas (ticks simulados)
+    long long llegada = 0;
+    long long primeraEjecucion = -1;
+
+    // Nucleo y tick en que termino su ultima rebanada, para el modelo de cache
+    int nucleoPrevio = -1;
+    long long salidaCPU = 0;
+
+    TablaProcesos* tabla = nullptr; // nulo para programas sueltos
+
+    PCB* sigCola = nullptr; // enlace intrusivo para las colas por prioridad
+
+    // Nodo intrusivo del arbol rojo-negro de CFS
+    PCB* rbPadre = nullptr;
+    PCB* rbIzq = nullptr;
+    PCB* rbDer = nullptr;
+    bool rbRojo = false;
+
+    PCB(const string &name, int tiempoEjecucion, int prioridad = 0);
+
+    // Los PCB sueltos creados con new salen del cache de slabs "pcb" (ver slab::fijarActivo)
+    static void* operator new(size_t tamano);
+    static void operator delete(void* p);
+
+    // Campos calientes: en la tabla si el proceso vive en una, si no en el propio PCB
+    int& restante();
+    int restante() const;
+    int prioridadEfectiva() const;
+    EstadoProceso estado() const;
+    void fijarEstado(EstadoProceso estado);
 
     void ejecutar(int quantum);
 
+    // Define el programa como una lista de rafagas; recalcula tiempoEjecucion
+    void fijarRafagas(const vector<Rafaga>& lista);
+    // Rafagas alternadas CPU, E/S, CPU, ...
+    void fijarRafagas(const vector<int>& alternadas);
+    int tiempoES() const;      // suma de las rafagas de E/S
+    int tiempoDormido() const; // suma de las rafagas de espera
+    // Duracion pedida de la rafaga actual
+    int duracionRafaga() const { return rafagas.empty() ? tiempoEjecucion : rafagas[rafagaActual].duracion; }
+    TipoRafaga tipoRafaga() const { return rafagas.empty() ? TipoRafaga::CPU : rafagas[rafagaActual].tipo; }
+    // Pasa a la rafaga siguiente y deja su duracion en restante(); false si no quedan
+    bool avanzarRafaga();
+
+    // Sin tiempo restante y sin rafagas pendientes
     bool terminado() const;
-};
\ No newline at end of file
+
+    RegistroPCB registro() const;
+    void restaurar(const RegistroPCB& r);
+    // Programa suelto completo (registro, nombre y rafagas)
+    void guardar(instantanea::Escritor& escritor) const;
+    static PCB cargar(instantanea::Lector& lector);
+};
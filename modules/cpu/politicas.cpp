@@ -0,0 +1,69 @@
+#include "politicas.h"
+
+namespace politicas {
+
+PCB* FIFO::siguiente() {
+    PCB* proceso = cola.front();
+    cola.pop_front();
+    return proceso;
+}
+
+void FIFO::guardar(instantanea::Escritor& escritor) const {
+    vector<uint32_t> indices;
+    indices.reserve(cola.size());
+    for (PCB* proceso : cola) indices.push_back(TablaProcesos::indiceDe(proceso));
+    escritor.arreglo(indices);
+}
+
+void FIFO::cargar(instantanea::Lector& lector, TablaProcesos& tabla) {
+    cola.clear();
+    for (uint32_t indice : lector.vista<uint32_t>()) cola.push_back(tabla.ranura(indice));
+}
+
+long long RoundRobin::saltarRondas(TablaProcesos& tabla, int quantum, long long presupuesto) {
+    if (cola.empty())
+        return 0;
+
+    int minRestante = tabla.minRestante(EstadoProceso::Listo);
+    if (minRestante <= 0)
+        return 0;
+
+    // Un proceso con r unidades sobrevive k rondas completas mientras k*quantum < r
+    long long costoRonda = (long long) cola.size() * quantum;
+    long long rondas = min<long long>((minRestante - 1) / quantum, presupuesto / costoRonda);
+    if (rondas <= 0)
+        return 0;
+
+    tabla.avanzar(EstadoProceso::Listo, (int) (rondas * quantum));
+    return rondas * costoRonda;
+}
+
+} // namespace politicas
+
+optional<Planificacion> planificacionDesdeNombre(const string& nombre) {
+    if (nombre == "fifo") return Planificacion::FIFO;
+    if (nombre == "sjf") return Planificacion::SJF;
+    if (nombre == "srtf") return Planificacion::SRTF;
+    if (nombre == "prioridad") return Planificacion::Prioridad;
+    if (nombre == "rr") return Planificacion::RoundRobin;
+    if (nombre == "o1") return Planificacion::PrioridadO1;
+    if (nombre == "cfs") return Planificacion::CFS;
+    if (nombre == "loteria") return Planificacion::Loteria;
+    if (nombre == "stride") return Planificacion::Stride;
+    return nullopt;
+}
+
+string nombrePlanificacion(Planificacion planificacion) {
+    switch (planificacion) {
+        case Planificacion::FIFO: return "fifo";
+        case Planificacion::SJF: return "sjf";
+        case Planificacion::SRTF: return "srtf";
+        case Planificacion::Prioridad: return "prioridad";
+        case Planificacion::RoundRobin: return "rr";
+        case Planificacion::PrioridadO1: return "o1";
+        case Planificacion::CFS: return "cfs";
+        case Planificacion::Loteria: return "loteria";
+        case Planificacion::Stride: return "stride";
+    }
+    return "?";
+}
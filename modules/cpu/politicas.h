@@ -0,0 +1,168 @@
+#pragma once
+#include "pcb.h"
+#include "tabla_procesos.h"
+#include "../snapshot/instantanea.h"
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Politicas de planificacion para Scheduler<Politica>.
+// Cada politica expone la misma interfaz (sin funciones virtuales):
+//   encolar(PCB*)       - agrega un proceso listo
+//   siguiente()         - retira y devuelve el proximo proceso a ejecutar
+//   vacia(), tamano()
+//   rebanada(pcb, q)    - cuanto puede correr el proceso antes de volver a decidir
+//   recorrer(f)         - visita los procesos listos en orden de despacho
+//   siguienteAfin(v, c) - opcional: siguiente() mirando el costo de cambio de v candidatos
+//   expropiativa        - si una llegada nueva obliga a replanificar al proceso actual
+//   guardar(e), cargar(l, tabla) - la cola en una instantanea, por indice de ranura
+namespace politicas {
+
+// Primero en llegar, primero en ser atendido. No expropiativa.
+struct FIFO {
+    static constexpr bool expropiativa = false;
+
+    void encolar(PCB* proceso) { cola.push_back(proceso); }
+    PCB* siguiente();
+    bool vacia() const { return cola.empty(); }
+    size_t tamano() const { return cola.size(); }
+    int rebanada(const PCB& proceso, int) const { return proceso.restante(); }
+
+    // Despacho por afinidad: el de menor costo entre los primeros `ventana`; los
+    // empates (y la cache igual de fria para todos) respetan el orden de la cola
+    template <typename Costo>
+    PCB* siguienteAfin(size_t ventana, Costo costo) {
+        size_t mejor = 0;
+        int menor = costo(*cola.front());
+        size_t limite = min(ventana, cola.size());
+        for (size_t i = 1; i < limite && menor > 0; ++i) {
+            int c = costo(*cola[i]);
+            if (c < menor) {
+                menor = c;
+                mejor = i;
+            }
+        }
+        PCB* proceso = cola[mejor];
+        cola.erase(cola.begin() + (ptrdiff_t) mejor);
+        return proceso;
+    }
+
+    template <typename F>
+    void recorrer(F f) const {
+        for (PCB* proceso : cola) f(proceso);
+    }
+
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector, TablaProcesos& tabla);
+
+    deque<PCB*> cola;
+};
+
+// Round robin clasico con quantum fijo.
+struct RoundRobin : FIFO {
+    int rebanada(const PCB&, int quantum) const { return quantum; }
+
+    // Salta en forma cerrada las rondas completas en las que ningun proceso termina.
+    // Recorre los arreglos calientes de la tabla: todos los procesos Listos de la
+    // tabla estan en esta cola cuando no hay proceso en CPU. Devuelve los ticks consumidos.
+    long long saltarRondas(TablaProcesos& tabla, int quantum, long long presupuesto);
+};
+
+// Cola ordenada por una clave; empates se resuelven por orden de llegada.
+// Clave debe ser un functor int(const PCB&), menor valor = mas urgente.
+template <typename Clave>
+struct ColaOrdenada {
+    void encolar(PCB* proceso) {
+        heap.push_back({Clave{}(*proceso), llegada++, proceso});
+        push_heap(heap.begin(), heap.end(), mayor);
+    }
+
+    PCB* siguiente() {
+        pop_heap(heap.begin(), heap.end(), mayor);
+        PCB* proceso = heap.back().proceso;
+        heap.pop_back();
+        return proceso;
+    }
+
+    bool vacia() const { return heap.empty(); }
+    size_t tamano() const { return heap.size(); }
+    int rebanada(const PCB& proceso, int) const { return proceso.restante(); }
+
+    template <typename F>
+    void recorrer(F f) const {
+        auto copia = heap;
+        sort(copia.begin(), copia.end(), [](const Entrada& a, const Entrada& b) { return mayor(b, a); });
+        for (const Entrada& e : copia) f(e.proceso);
+    }
+
+    struct Entrada {
+        int clave;
+        uint64_t orden;
+        PCB* proceso;
+    };
+
+    // El monticulo se guarda tal cual, con el proceso como indice de ranura
+    struct EntradaGuardada {
+        int32_t clave;
+        uint32_t indice;
+        uint64_t orden;
+    };
+
+    void guardar(instantanea::Escritor& escritor) const {
+        vector<EntradaGuardada> entradas;
+        entradas.reserve(heap.size());
+        for (const Entrada& e : heap)
+            entradas.push_back({e.clave, TablaProcesos::indiceDe(e.proceso), e.orden});
+        escritor.arreglo(entradas);
+        escritor.valor(llegada);
+    }
+
+    void cargar(instantanea::Lector& lector, TablaProcesos& tabla) {
+        heap.clear();
+        for (const EntradaGuardada& e : lector.vista<EntradaGuardada>())
+            heap.push_back({e.clave, e.orden, tabla.ranura(e.indice)});
+        llegada = lector.valor<uint64_t>();
+    }
+
+    static bool mayor(const Entrada& a, const Entrada& b) {
+        return a.clave != b.clave ? a.clave > b.clave : a.orden > b.orden;
+    }
+
+    vector<Entrada> heap;
+    uint64_t llegada = 0;
+};
+
+struct PorTiempoRestante {
+    int operator()(const PCB& proceso) const { return proceso.restante(); }
+};
+
+struct PorPrioridad {
+    int operator()(const PCB& proceso) const { return proceso.prioridadEfectiva(); }
+};
+
+// Trabajo mas corto primero, no expropiativo.
+struct SJF : ColaOrdenada<PorTiempoRestante> {
+    static constexpr bool expropiativa = false;
+};
+
+// Menor tiempo restante primero: una llegada nueva replanifica al proceso actual.
+struct SRTF : ColaOrdenada<PorTiempoRestante> {
+    static constexpr bool expropiativa = true;
+};
+
+// Prioridad estatica (0 = mas alta), no expropiativa.
+struct Prioridad : ColaOrdenada<PorPrioridad> {
+    static constexpr bool expropiativa = false;
+};
+
+} // namespace politicas
+
+enum class Planificacion { FIFO, SJF, SRTF, Prioridad, RoundRobin, PrioridadO1, CFS, Loteria, Stride };
+
+optional<Planificacion> planificacionDesdeNombre(const string& nombre);
+string nombrePlanificacion(Planificacion planificacion);
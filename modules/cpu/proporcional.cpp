@@ -0,0 +1,136 @@
+#include "proporcional.h"
+#include "../snapshot/instantanea.h"
+#include <bit>
+
+namespace politicas {
+
+uint32_t boletosDe(const PCB& proceso) {
+    return (uint32_t) clamp<long long>(proceso.tickets, 1, Stride::PASO_BASE);
+}
+
+// Loteria
+
+uint64_t Loteria::aleatorio() {
+    // splitmix64
+    uint64_t z = (semilla += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Agranda el arbol a la potencia de dos que cubre `indice` y lo reconstruye en O(n)
+void Loteria::crecer(size_t indice) {
+    size_t capacidad = max<size_t>(64, bit_ceil(indice + 1));
+    procesos.resize(capacidad, nullptr);
+    boletos.resize(capacidad, 0);
+    arbol.assign(capacidad + 1, 0);
+    for (size_t i = 1; i <= capacidad; ++i) {
+        arbol[i] += boletos[i - 1];
+        size_t padre = i + (i & -i);
+        if (padre <= capacidad)
+            arbol[padre] += arbol[i];
+    }
+}
+
+void Loteria::sumar(size_t indice, long long delta) {
+    for (size_t i = indice + 1; i < arbol.size(); i += i & -i)
+        arbol[i] += (uint64_t) delta;
+}
+
+// Ranura cuyo intervalo acumulado de boletos contiene a `boleto` (descenso binario)
+size_t Loteria::buscar(uint64_t boleto) const {
+    size_t pos = 0;
+    for (size_t paso = arbol.size() - 1; paso > 0; paso >>= 1) {
+        if (arbol[pos + paso] <= boleto) {
+            pos += paso;
+            boleto -= arbol[pos];
+        }
+    }
+    return pos;
+}
+
+void Loteria::encolar(PCB* proceso) {
+    size_t indice = TablaProcesos::indiceDe(proceso);
+    if (indice >= procesos.size())
+        crecer(indice);
+    uint32_t cantidad = boletosDe(*proceso);
+    procesos[indice] = proceso;
+    boletos[indice] = cantidad;
+    sumar(indice, cantidad);
+    boletosTotales += cantidad;
+    ++total;
+}
+
+PCB* Loteria::siguiente() {
+    // Boleto uniforme en [0, boletosTotales) por multiplicacion, sin el sesgo del modulo
+    uint64_t boleto = (uint64_t) (((unsigned __int128) aleatorio() * boletosTotales) >> 64);
+    size_t indice = buscar(boleto);
+    PCB* proceso = procesos[indice];
+    sumar(indice, -(long long) boletos[indice]);
+    boletosTotales -= boletos[indice];
+    procesos[indice] = nullptr;
+    boletos[indice] = 0;
+    --total;
+    return proceso;
+}
+
+void Loteria::guardar(instantanea::Escritor& escritor) const {
+    vector<uint32_t> indices;
+    indices.reserve(total);
+    recorrer([&](PCB* proceso) { indices.push_back(TablaProcesos::indiceDe(proceso)); });
+    escritor.arreglo(indices);
+    escritor.valor(semilla);
+}
+
+void Loteria::cargar(instantanea::Lector& lector, TablaProcesos& tabla) {
+    arbol.assign(1, 0);
+    procesos.clear();
+    boletos.clear();
+    boletosTotales = 0;
+    total = 0;
+    for (uint32_t indice : lector.vista<uint32_t>())
+        encolar(tabla.ranura(indice));
+    semilla = lector.valor<uint64_t>();
+}
+
+// Stride
+
+void Stride::encolar(PCB* proceso) {
+    // Quien vuelve de E/S o llega tarde entra en el pase actual: no acumula credito
+    proceso->vruntime = max(proceso->vruntime, paseMinimo);
+    uint32_t indice = TablaProcesos::indiceDe(proceso);
+    if (indice >= procesos.size())
+        procesos.resize(indice + 1, nullptr);
+    procesos[indice] = proceso;
+    monticulo.insertar(indice, proceso->vruntime);
+}
+
+PCB* Stride::siguiente() {
+    PCB* proceso = procesos[monticulo.extraer()];
+    paseMinimo = max(paseMinimo, proceso->vruntime);
+    return proceso;
+}
+
+void Stride::contabilizar(PCB& proceso, int ticks) {
+    proceso.vruntime += ticks * (PASO_BASE / boletosDe(proceso));
+}
+
+void Stride::guardar(instantanea::Escritor& escritor) const {
+    vector<uint32_t> indices;
+    indices.reserve(monticulo.tamano());
+    monticulo.recorrer([&](uint32_t indice) { indices.push_back(indice); });
+    escritor.arreglo(indices);
+    escritor.valor(paseMinimo);
+}
+
+void Stride::cargar(instantanea::Lector& lector, TablaProcesos& tabla) {
+    monticulo = MonticuloDario<4>();
+    procesos.clear();
+    paseMinimo = 0;
+    // El pase viene en cada PCB; paseMinimo se restaura despues para no moverlo
+    for (uint32_t indice : lector.vista<uint32_t>())
+        encolar(tabla.ranura(indice));
+    paseMinimo = lector.valor<long long>();
+}
+
+} // namespace politicas
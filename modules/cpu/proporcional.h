@@ -0,0 +1,92 @@
+#pragma once
+#include "pcb.h"
+#include "tabla_procesos.h"
+#include "monticulo.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+namespace politicas {
+
+// Planificacion por loteria: cada quantum se sortea un boleto entre todos los de
+// los procesos listos, asi que a la larga cada proceso recibe CPU en proporcion a
+// sus boletos. Los boletos viven en un arbol de Fenwick indexado por la ranura del
+// proceso en la tabla: encolar, retirar y sortear son O(log n), sin recorrer la
+// cola. El generador tiene semilla fija: la misma carga da el mismo sorteo.
+struct Loteria {
+    static constexpr bool expropiativa = false;
+
+    void encolar(PCB* proceso);
+    PCB* siguiente();
+    bool vacia() const { return total == 0; }
+    size_t tamano() const { return total; }
+    int rebanada(const PCB&, int quantum) const { return quantum; }
+
+    // En orden de ranura: la loteria no tiene orden de despacho
+    template <typename F>
+    void recorrer(F f) const {
+        for (PCB* proceso : procesos)
+            if (proceso) f(proceso);
+    }
+
+    // Los procesos por ranura y el estado del generador; cargar reconstruye el arbol
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector, TablaProcesos& tabla);
+
+    uint64_t semilla = 0x9E3779B97F4A7C15ull;
+
+private:
+    uint64_t aleatorio();
+    void sumar(size_t indice, long long delta);
+    size_t buscar(uint64_t boleto) const;
+    void crecer(size_t indice);
+
+    vector<uint64_t> arbol = vector<uint64_t>(1, 0); // Fenwick base 1, capacidad potencia de dos
+    vector<PCB*> procesos;                           // por ranura; nulo si no esta en la cola
+    vector<uint32_t> boletos;                        // boletos con que se encolo cada ranura
+    uint64_t boletosTotales = 0;
+    size_t total = 0;
+};
+
+// Planificacion stride: cada proceso avanza su pase en PASO_BASE / boletos por tick
+// ejecutado y siempre corre el de menor pase. Es el reparto proporcional de la
+// loteria sin azar: el error respecto de la proporcion ideal queda acotado por un
+// quantum en lugar de crecer con la raiz del tiempo. El pase se guarda en el
+// vruntime del PCB y los listos van en un monticulo 4-ario por ranura (O(log n)).
+struct Stride {
+    static constexpr bool expropiativa = false;
+    static constexpr long long PASO_BASE = 1LL << 20;
+
+    void encolar(PCB* proceso);
+    PCB* siguiente();
+    bool vacia() const { return monticulo.vacio(); }
+    size_t tamano() const { return monticulo.tamano(); }
+    int rebanada(const PCB&, int quantum) const { return quantum; }
+    void contabilizar(PCB& proceso, int ticks);
+
+    template <typename F>
+    void recorrer(F f) const {
+        vector<PCB*> orden;
+        monticulo.recorrer([&](uint32_t indice) { orden.push_back(procesos[indice]); });
+        sort(orden.begin(), orden.end(), [](const PCB* a, const PCB* b) {
+            return a->vruntime != b->vruntime ? a->vruntime < b->vruntime
+                                              : TablaProcesos::indiceDe(a) < TablaProcesos::indiceDe(b);
+        });
+        for (PCB* proceso : orden) f(proceso);
+    }
+
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector, TablaProcesos& tabla);
+
+private:
+    MonticuloDario<4> monticulo; // clave: pase
+    vector<PCB*> procesos;       // por ranura
+    long long paseMinimo = 0;    // pase del ultimo despachado; nadie entra por debajo
+};
+
+// Boletos efectivos de un proceso (al menos 1)
+uint32_t boletosDe(const PCB& proceso);
+
+} // namespace politicas
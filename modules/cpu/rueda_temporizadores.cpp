@@ -0,0 +1,174 @@
+#include "rueda_temporizadores.h"
+#include "../snapshot/instantanea.h"
+#include <algorithm>
+#include <iostream>
+
+array<array<RuedaTemporizadores::Id, RuedaTemporizadores::RANURAS>, RuedaTemporizadores::NIVELES>
+RuedaTemporizadores::vacias() {
+    array<array<Id, RANURAS>, NIVELES> cabezas;
+    for (auto& nivel : cabezas)
+        nivel.fill(NULO);
+    return cabezas;
+}
+
+RuedaTemporizadores::Id RuedaTemporizadores::programar(long long vence, PCB* proceso) {
+    Id id;
+    if (!libres.empty()) {
+        id = libres.back();
+        libres.pop_back();
+    } else {
+        id = (Id) nodos.size();
+        nodos.emplace_back();
+    }
+    Nodo& nodo = nodos[id];
+    nodo.vence = max(vence, actual + 1);
+    nodo.proceso = proceso;
+    nodo.activo = true;
+    ++pendientes;
+    colocar(id);
+    return id;
+}
+
+void RuedaTemporizadores::cancelar(Id id) {
+    if (id >= nodos.size() || !nodos[id].activo)
+        return;
+    desenlazar(id);
+    liberar(id);
+}
+
+// Nivel = grupo de 6 bits mas alto en que difieren el vencimiento y el reloj
+void RuedaTemporizadores::colocar(Id id) {
+    Nodo& nodo = nodos[id];
+    uint64_t diferencia = (uint64_t) (nodo.vence ^ actual);
+    int nivel = diferencia ? (63 - countl_zero(diferencia)) / BITS : 0;
+    int ranura = (int) ((nodo.vence >> (nivel * BITS)) & MASCARA);
+    nodo.nivel = (uint8_t) nivel;
+    nodo.ranura = (uint8_t) ranura;
+    nodo.ant = NULO;
+    nodo.sig = cabezas[nivel][ranura];
+    if (nodo.sig != NULO)
+        nodos[nodo.sig].ant = id;
+    cabezas[nivel][ranura] = id;
+    ocupadas[nivel] |= uint64_t(1) << ranura;
+}
+
+void RuedaTemporizadores::desenlazar(Id id) {
+    Nodo& nodo = nodos[id];
+    if (nodo.ant != NULO)
+        nodos[nodo.ant].sig = nodo.sig;
+    else
+        cabezas[nodo.nivel][nodo.ranura] = nodo.sig;
+    if (nodo.sig != NULO)
+        nodos[nodo.sig].ant = nodo.ant;
+    if (cabezas[nodo.nivel][nodo.ranura] == NULO)
+        ocupadas[nodo.nivel] &= ~(uint64_t(1) << nodo.ranura);
+}
+
+void RuedaTemporizadores::liberar(Id id) {
+    nodos[id].activo = false;
+    nodos[id].proceso = nullptr;
+    libres.push_back(id);
+    --pendientes;
+}
+
+// Todas las ranuras ocupadas de un nivel estan por delante del reloj y los niveles
+// bajos cubren tramos anteriores a los altos: el primer nivel no vacio manda
+long long RuedaTemporizadores::proximoVencimiento() const {
+    if (pendientes == 0)
+        return LLONG_MAX;
+    for (int nivel = 0; nivel < NIVELES; ++nivel) {
+        if (!ocupadas[nivel])
+            continue;
+        int ranura = countr_zero(ocupadas[nivel]);
+        int desplazamiento = nivel * BITS;
+        // Prefijo del reloj por encima del nivel, con la ranura encontrada y ceros debajo
+        uint64_t prefijo = desplazamiento + BITS >= 64 ? 0 : ((uint64_t) actual >> (desplazamiento + BITS)) << (desplazamiento + BITS);
+        return (long long) (prefijo | ((uint64_t) ranura << desplazamiento));
+    }
+    return LLONG_MAX;
+}
+
+// El reloj acaba de entrar en una ranura de nivel alto: sus temporizadores bajan de nivel
+void RuedaTemporizadores::cascada() {
+    for (int nivel = NIVELES - 1; nivel > 0; --nivel) {
+        int ranura = (int) (((uint64_t) actual >> (nivel * BITS)) & MASCARA);
+        Id id = cabezas[nivel][ranura];
+        if (id == NULO)
+            continue;
+        cabezas[nivel][ranura] = NULO;
+        ocupadas[nivel] &= ~(uint64_t(1) << ranura);
+        while (id != NULO) {
+            Id sig = nodos[id].sig;
+            colocar(id);
+            id = sig;
+        }
+    }
+}
+
+void RuedaTemporizadores::listar(size_t maximo) const {
+    array<size_t, NIVELES> porNivel{};
+    vector<pair<long long, PCB*>> proximos;
+    proximos.reserve(pendientes);
+    for (const Nodo& nodo : nodos) {
+        if (!nodo.activo)
+            continue;
+        ++porNivel[nodo.nivel];
+        proximos.emplace_back(nodo.vence, nodo.proceso);
+    }
+    size_t mostrados = min(maximo, proximos.size());
+    partial_sort(proximos.begin(), proximos.begin() + mostrados, proximos.end(),
+                 [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    cout << "=== Temporizadores (pendientes: " << pendientes << ", reloj: " << actual << ") ===" << endl;
+    cout << "  por nivel:";
+    for (int nivel = 0; nivel < NIVELES; ++nivel)
+        if (porNivel[nivel])
+            cout << " [" << nivel << "] " << porNivel[nivel];
+    cout << endl;
+    for (size_t i = 0; i < mostrados; ++i)
+        cout << "Proceso: " << proximos[i].second->name << " (pid " << proximos[i].second->pid << ")"
+             << " | despierta en el tick " << proximos[i].first << endl;
+    if (proximos.size() > mostrados)
+        cout << "... y " << proximos.size() - mostrados << " mas" << endl;
+}
+
+namespace {
+    struct NodoGuardado {
+        int64_t vence;
+        uint32_t indice;
+        uint32_t sig;
+        uint32_t ant;
+        uint8_t nivel;
+        uint8_t ranura;
+        uint8_t activo;
+        uint8_t reservado;
+    };
+}
+
+void RuedaTemporizadores::guardar(instantanea::Escritor& escritor) const {
+    vector<NodoGuardado> guardados;
+    guardados.reserve(nodos.size());
+    for (const Nodo& nodo : nodos)
+        guardados.push_back({nodo.vence, nodo.activo ? TablaProcesos::indiceDe(nodo.proceso) : instantanea::NULO,
+                             nodo.sig, nodo.ant, nodo.nivel, nodo.ranura, nodo.activo, 0});
+    escritor.arreglo(guardados);
+    escritor.arreglo(libres);
+    escritor.valor(cabezas);
+    escritor.valor(ocupadas);
+    escritor.valor(actual);
+    escritor.valor<uint64_t>(pendientes);
+}
+
+void RuedaTemporizadores::cargar(instantanea::Lector& lector, TablaProcesos& tabla) {
+    auto guardados = lector.vista<NodoGuardado>();
+    nodos.resize(guardados.size());
+    for (size_t i = 0; i < guardados.size(); ++i) {
+        const NodoGuardado& g = guardados[i];
+        nodos[i] = {g.vence, g.activo ? tabla.ranura(g.indice) : nullptr, g.sig, g.ant, g.nivel, g.ranura, g.activo != 0};
+    }
+    lector.arreglo(libres);
+    cabezas = lector.valor<decltype(cabezas)>();
+    ocupadas = lector.valor<decltype(ocupadas)>();
+    actual = lector.valor<long long>();
+    pendientes = (size_t) lector.valor<uint64_t>();
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include "pcb.h"
+#include "tabla_procesos.h"
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Rueda jerarquica de temporizadores (Varghese y Lauck).
+// NIVELES ruedas de 64 ranuras; el nivel k cubre 64^k ticks por ranura. Un
+// temporizador va al nivel del grupo de 6 bits mas alto en que su vencimiento
+// difiere del instante actual, asi que programar y cancelar son O(1) (listas
+// doblemente enlazadas por indices). Al avanzar, la ranura que alcanza el reloj
+// en un nivel alto se reparte hacia abajo: cada temporizador baja a lo sumo
+// NIVELES veces, lo que da vencimiento en tiempo constante amortizado. Un mapa
+// de bits por nivel ubica la proxima ranura ocupada sin recorrer la rueda.
+class RuedaTemporizadores {
+public:
+    using Id = uint32_t;
+    static constexpr Id NULO = UINT32_MAX;
+
+    // El proceso despierta en el tick absoluto `vence` (> ahora)
+    Id programar(long long vence, PCB* proceso);
+    void cancelar(Id id);
+
+    bool vacia() const { return pendientes == 0; }
+    size_t tamano() const { return pendientes; }
+    long long ahora() const { return actual; }
+
+    // Cota inferior del proximo vencimiento (exacta si esta en el nivel 0); LLONG_MAX si no hay
+    long long proximoVencimiento() const;
+
+    // Avanza el reloj de la rueda hasta `hasta` y llama alVencer(proceso) por cada
+    // temporizador vencido, en orden de vencimiento
+    template <typename F>
+    void avanzar(long long hasta, F alVencer) {
+        while (pendientes > 0) {
+            long long proximo = proximoVencimiento();
+            if (proximo > hasta)
+                break;
+            actual = proximo;
+            cascada();
+            // Lo que queda en la ranura del nivel 0 vence ahora
+            int ranura = (int) (actual & MASCARA);
+            while (cabezas[0][ranura] != NULO) {
+                Id id = cabezas[0][ranura];
+                PCB* proceso = nodos[id].proceso;
+                desenlazar(id);
+                liberar(id);
+                alVencer(proceso);
+            }
+        }
+        if (hasta > actual)
+            actual = hasta;
+    }
+
+    // Visita (vencimiento, proceso) de todos los temporizadores, sin orden
+    template <typename F>
+    void recorrer(F f) const {
+        for (const Nodo& nodo : nodos)
+            if (nodo.activo) f(nodo.vence, nodo.proceso);
+    }
+
+    // Vista `timers`: cuenta por nivel y los `maximo` vencimientos mas cercanos
+    void listar(size_t maximo) const;
+
+    // La rueda se guarda tal cual (nodos, listas y mapas), con el proceso como
+    // indice de ranura, asi que el orden de vencimiento se conserva exacto
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector, TablaProcesos& tabla);
+
+    static constexpr int BITS = 6;
+    static constexpr int RANURAS = 1 << BITS;
+    static constexpr int NIVELES = 11; // 66 bits: cubre cualquier tick de 63 bits
+
+private:
+    static constexpr long long MASCARA = RANURAS - 1;
+
+    struct Nodo {
+        long long vence = 0;
+        PCB* proceso = nullptr;
+        Id sig = NULO;
+        Id ant = NULO;
+        uint8_t nivel = 0;
+        uint8_t ranura = 0;
+        bool activo = false;
+    };
+
+    void colocar(Id id);
+    void desenlazar(Id id);
+    void liberar(Id id);
+    void cascada();
+
+    vector<Nodo> nodos;
+    vector<Id> libres;
+    array<array<Id, RANURAS>, NIVELES> cabezas = vacias();
+    array<uint64_t, NIVELES> ocupadas{};   // bit r: la ranura r del nivel tiene temporizadores
+    long long actual = 0;
+    size_t pendientes = 0;
+
+    static array<array<Id, RANURAS>, NIVELES> vacias();
+};
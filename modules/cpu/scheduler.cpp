@@ -1,50 +1,474 @@
 #include "scheduler.h"
 #include "pcb.h"
+#include "traza.h"
+#include "../snapshot/instantanea.h"
 #include <iostream>
 
 using namespace std;
 
-void Scheduler::agregarProceso(PCB* proceso) {
-    cola.push_back(proceso);
+template <typename Politica>
+Scheduler<Politica>::Scheduler(TablaProcesos& tabla) : tabla(&tabla) {}
+
+template <typename Politica>
+void Scheduler<Politica>::agregarProceso(PCB* proceso) {
+    proceso->fijarEstado(EstadoProceso::Listo);
+    proceso->llegada = reloj;
+    grupos.asignar(*proceso);
+    ++sinPrimeraEjecucion;
+    traza::emitir(reloj, proceso, traza::Evento::Llegada, proceso->restante());
+    encolarListo(proceso);
 }
 
-void Scheduler::ejecutar(int quantum, int tick) { // Varios cambios a la funcion con logica reciclada del pcb
-    int tiempoRestante = tick;
+// Llegadas nuevas y procesos que vuelven de E/S
+template <typename Politica>
+void Scheduler<Politica>::encolarListo(PCB* proceso) {
+    devolver(proceso);
 
-    while (tiempoRestante > 0 && !cola.empty()) {
+    // En politicas expropiativas la llegada obliga a replanificar al proceso actual
+    if constexpr (Politica::expropiativa) {
+        if (actual) {
+            actual->fijarEstado(EstadoProceso::Listo);
+            devolver(actual);
+            actual = nullptr;
+            curQuantum = 0;
+        }
+    }
+}
 
-        if (curQuantum <= 0)
-            curQuantum = quantum;
+// A la cola de su grupo, sin replanificar
+template <typename Politica>
+void Scheduler<Politica>::devolver(PCB* proceso) {
+    colaDe(proceso->grupo).encolar(proceso);
+    grupos.encolado(proceso->grupo);
+}
 
-        PCB* proceso = cola.front();
+template <typename Politica>
+Politica& Scheduler<Politica>::colaDe(uint32_t grupo) {
+    if (grupo == Grupos::RAIZ)
+        return politica;
+    while (colasGrupo.size() < grupo) colasGrupo.push_back(colaNueva());
+    return colasGrupo[grupo - 1];
+}
 
-        int ejecutarAhora = min(min(quantum, tiempoRestante), curQuantum); // para la persistencia de los ticks
-        proceso->ejecutar(ejecutarAhora);
-        tiempoRestante -= ejecutarAhora;
-        curQuantum -= ejecutarAhora;
+// Nulo si el grupo nunca tuvo procesos encolados
+template <typename Politica>
+const Politica* Scheduler<Politica>::colaSiExiste(uint32_t grupo) const {
+    if (grupo == Grupos::RAIZ)
+        return &politica;
+    return grupo <= colasGrupo.size() ? &colasGrupo[grupo - 1] : nullptr;
+}
 
-        if (curQuantum > 0)
-            return;
+// Cola vacia con la configuracion de la de la raiz
+template <typename Politica>
+Politica Scheduler<Politica>::colaNueva() const {
+    Politica cola;
+    if constexpr (requires { cola.fijarRebanadas(1, 1); })
+        cola.fijarRebanadas(politica.granularidad(), politica.latencia());
+    return cola;
+}
 
-        cola.pop_front();
+// El envejecimiento de prioridad O(1) corre en todas las colas a la vez
+template <typename Politica>
+void Scheduler<Politica>::envejecer(long long ticks) {
+    if constexpr (requires { politica.transcurrir(0LL); }) {
+        politica.transcurrir(ticks);
+        for (Politica& cola : colasGrupo) cola.transcurrir(ticks);
+    }
+}
 
-        if (!proceso->terminado()) {
-            cola.push_back(proceso);
-        } else {
-            cout << "Proceso " << proceso->name << " terminado." << endl;
-            delete proceso;
-            curQuantum = 0;
+// Un proceso acaba de empezar una rafaga: va a la politica, al dispositivo o a dormir
+template <typename Politica>
+void Scheduler<Politica>::encaminar(PCB* proceso) {
+    switch (proceso->tipoRafaga()) {
+        case TipoRafaga::CPU:
+            proceso->fijarEstado(EstadoProceso::Listo);
+            traza::emitir(reloj, proceso, traza::Evento::Despierta, 0);
+            encolarListo(proceso);
+            break;
+        case TipoRafaga::ES:
+            traza::emitir(reloj, proceso, traza::Evento::Bloquea, proceso->restante());
+            dispositivo.solicitar(proceso);
+            break;
+        case TipoRafaga::Dormir:
+            proceso->fijarEstado(EstadoProceso::Bloqueado);
+            proceso->despertar = reloj + proceso->restante();
+            traza::emitir(reloj, proceso, traza::Evento::Duerme, proceso->restante());
+            temporizadores.programar(proceso->despertar, proceso);
+            break;
+    }
+}
+
+// El dispositivo avanza en paralelo a la CPU; los procesos que terminan su E/S
+// pasan a su rafaga siguiente
+template <typename Politica>
+void Scheduler<Politica>::avanzarES(long long ticks, bool cpuOcupada) {
+    if (dispositivo.ocioso())
+        return;
+    long long ocupado = dispositivo.transcurrir(ticks, [&](PCB* proceso) {
+        ++metricas.solicitudesES;
+        proceso->avanzarRafaga();
+        encaminar(proceso);
+    });
+    metricas.ticksOcupadoES += ocupado;
+    if (cpuOcupada)
+        metricas.ticksSolapados += ocupado;
+}
+
+// Ejecuta una rebanada del proceso actual y lo devuelve a la politica o lo retira.
+// Devuelve los ticks consumidos.
+template <typename Politica>
+long long Scheduler<Politica>::ejecutarRebanada(int quantum, long long tiempoRestante) {
+    // Termino el turno del grupo, o el grupo quedo estrangulado entre dos rebanadas
+    // (otro proceso del grupo corrio antes, o se le bajo la cuota): se vuelve a elegir grupo
+    if (actual && grupos.activos() && (tramoGrupo <= 0 || grupos.bloqueado(*actual)))
+        apartar();
+    if (!actual && !elegirListo(quantum))
+        return 0; // todos los listos estan en grupos estrangulados hasta una recarga
+    // Tambien cuenta el regreso de un proceso que quedo en pausa por la clase de tiempo real
+    despachar(*actual);
+    // El cambio de contexto se paga antes de que el proceso avance
+    if (deudaCambio > 0)
+        return pagarCambio(tiempoRestante);
+    if (actual->primeraEjecucion < 0) {
+        metricas.registrarPrimeraEjecucion(*actual, reloj);
+        --sinPrimeraEjecucion;
+    }
+
+    // Un proceso que termina antes de agotar su rebanada libera la CPU de inmediato
+    long long tope = min<long long>(min(curQuantum, actual->restante()), tiempoRestante);
+    if (grupos.activos())
+        tope = min({tope, (long long) tramoGrupo, grupos.margen(*actual, reloj)});
+    int ejecutarAhora = (int) tope;
+    actual->ejecutar(ejecutarAhora);
+    curQuantum -= ejecutarAhora;
+    tramoGrupo -= ejecutarAhora;
+    reloj += ejecutarAhora;
+    metricas.ticksOcupado += ejecutarAhora;
+    actual->nucleoPrevio = 0;
+    actual->salidaCPU = reloj;
+    if (grupos.activos())
+        grupos.cobrar(*actual, ejecutarAhora, reloj);
+    traza::emitir(reloj, actual, traza::Evento::Ejecuta, ejecutarAhora);
+    if constexpr (requires { politica.contabilizar(*actual, 0); })
+        colaDe(actual->grupo).contabilizar(*actual, ejecutarAhora);
+    envejecer(ejecutarAhora);
+
+    PCB* bloqueado = nullptr;
+    if (control.activo() && actual->restante() <= 0)
+        control.registrar(actual->duracionRafaga(), reloj);
+    if (actual->terminado()) {
+        traza::emitir(reloj, actual, traza::Evento::Termina, 0);
+        metricas.registrarTerminacion(*actual, reloj);
+        tabla->liberar(actual);
+        actual = nullptr;
+        curQuantum = 0;
+    } else if (actual->restante() <= 0) {
+        // Fin de una rafaga de CPU: la siguiente es de E/S o de espera
+        actual->avanzarRafaga();
+        bloqueado = actual;
+        actual = nullptr;
+        curQuantum = 0;
+    } else if (curQuantum <= 0) {
+        actual->fijarEstado(EstadoProceso::Listo);
+        devolver(actual);
+        actual = nullptr;
+    }
+
+    // La E/S en curso avanzo durante la rebanada; la espera del proceso recien bloqueado empieza ahora
+    avanzarES(ejecutarAhora, true);
+    if (bloqueado)
+        encaminar(bloqueado);
+    return ejecutarAhora;
+}
+
+// Corre el trabajo de tiempo real mas urgente. El proceso normal en CPU, si lo hay,
+// queda en pausa con su rebanada intacta hasta que no quede trabajo de tiempo real.
+template <typename Politica>
+long long Scheduler<Politica>::ejecutarTiempoReal(long long tiempoRestante) {
+    PCB& tarea = tareasPeriodicas.proximo();
+    despachar(tarea);
+    if (deudaCambio > 0)
+        return pagarCambio(tiempoRestante);
+
+    int corrido = tareasPeriodicas.ejecutar(reloj, tiempoRestante);
+    reloj += corrido;
+    metricas.ticksOcupado += corrido;
+    tarea.nucleoPrevio = 0;
+    tarea.salidaCPU = reloj;
+    traza::emitir(reloj, &tarea, traza::Evento::Ejecuta, corrido);
+    envejecer(corrido);
+    avanzarES(corrido, true);
+    return corrido;
+}
+
+// Toma el proximo proceso y fija su rebanada. Con grupos, primero el grupo de menor
+// tiempo virtual y despues la politica dentro de su cola; el turno del grupo dura un
+// quantum. Con despacho por afinidad, el mas barato de la ventana de esa cola.
+// false si no queda ninguno que pueda correr.
+template <typename Politica>
+bool Scheduler<Politica>::elegirListo(int quantum) {
+    uint32_t grupo = Grupos::RAIZ;
+    if (grupos.activos()) {
+        grupo = grupos.elegir();
+        if (grupo == Grupos::NINGUNO)
+            return false;
+        tramoGrupo = quantum;
+        if ((actual = grupos.reanudar(grupo, curQuantum))) {
+            actual->fijarEstado(EstadoProceso::Ejecutando);
+            return true;
         }
     }
+    Politica& cola = colaDe(grupo);
+    if (cola.vacia())
+        return false;
+    PCB* proceso = nullptr;
+    if constexpr (requires { cola.siguienteAfin(size_t(1), [](const PCB&) { return 0; }); }) {
+        if (modeloCambio.activo() && modeloCambio.afinidad())
+            proceso = cola.siguienteAfin((size_t) modeloCambio.ventana, [&](const PCB& candidato) {
+                return huboDespacho && candidato.pid == ultimoPid ? 0 : modeloCambio.costo(candidato, 0, reloj);
+            });
+    }
+    if (!proceso)
+        proceso = cola.siguiente();
+    grupos.retirado(grupo);
+    actual = proceso;
+    actual->fijarEstado(EstadoProceso::Ejecutando);
+    curQuantum = cola.rebanada(*actual, quantum);
+    return true;
+}
+
+// El proceso deja la CPU sin perder su lugar en su grupo. Una politica expropiativa
+// lo reordena al encolarlo; las demas lo retoman antes que al resto de la cola.
+template <typename Politica>
+void Scheduler<Politica>::apartar() {
+    actual->fijarEstado(EstadoProceso::Listo);
+    if constexpr (Politica::expropiativa)
+        devolver(actual);
+    else
+        grupos.interrumpir(actual, curQuantum);
+    actual = nullptr;
+    curQuantum = 0;
+}
+
+// Cuenta el cambio de contexto; con el modelo de costo el despacho queda debiendo sus ticks
+template <typename Politica>
+void Scheduler<Politica>::despachar(PCB& proceso) {
+    if (huboDespacho && proceso.pid == ultimoPid)
+        return;
+    ++metricas.cambiosContexto[0];
+    deudaCambio = modeloCambio.costo(proceso, 0, reloj);
+    ultimoPid = proceso.pid;
+    huboDespacho = true;
+}
+
+// Ticks de CPU del cambio de contexto: ningun proceso avanza, la E/S sigue.
+// Si una expropiacion interrumpe el cambio, el proximo despacho fija la deuda de nuevo.
+template <typename Politica>
+long long Scheduler<Politica>::pagarCambio(long long tiempoRestante) {
+    long long pago = min<long long>(deudaCambio, tiempoRestante);
+    deudaCambio -= (int) pago;
+    reloj += pago;
+    metricas.ticksCambio += pago;
+    envejecer(pago);
+    avanzarES(pago, true);
+    return pago;
+}
+
+template <typename Politica>
+void Scheduler<Politica>::ejecutar(int quantumFijo, long long tick) {
+    // El reloj solo avanza: un presupuesto negativo lo haria retroceder
+    if (tick <= 0)
+        return;
+    long long tiempoRestante = tick;
+    long long inicio = reloj;
+    long long relojFinal = reloj + tick;
+    size_t rebanadasSinSalto = 0;
+    // Si la consola muestra cada rebanada no se puede saltar rondas
+    bool porRebanada = traza::consola() == traza::Consola::Todo;
+
+    // Cada iteracion es un evento: vencimiento de rebanada, terminacion, fin de rafaga,
+    // fin de una E/S, evento de tiempo real o fin del presupuesto
+    while (tiempoRestante > 0 && (actual || grupos.hayEncolados() || !dispositivo.ocioso() ||
+                                  !tareasPeriodicas.vacia() || !temporizadores.vacia())) {
+        // El controlador solo cambia el quantum al terminar una rafaga, nunca dentro de un salto
+        int quantum = control.quantum(quantumFijo);
+
+        // Los procesos cuyo sleep vence ahora vuelven a la cola
+        temporizadores.avanzar(reloj, [&](PCB* proceso) {
+            proceso->avanzarRafaga();
+            encaminar(proceso);
+        });
+        // Los grupos cuyo periodo termino vuelven a ser elegibles
+        grupos.recargar(reloj);
+
+        // Ningun avance pasa del proximo evento externo (fin de E/S, temporizador,
+        // liberacion o plazo): ahi cambia el conjunto de listos
+        long long limite = min(tiempoRestante, dispositivo.proximaFinalizacion());
+        if (!temporizadores.vacia())
+            limite = min(limite, temporizadores.proximoVencimiento() - reloj);
+        if (grupos.hayRetenidos())
+            limite = min(limite, grupos.proximaRecarga() - reloj);
+
+        // La clase de tiempo real va primero
+        if (!tareasPeriodicas.vacia()) {
+            tareasPeriodicas.actualizar(reloj);
+            limite = min(limite, tareasPeriodicas.proximoEvento(reloj));
+            if (tareasPeriodicas.hayListo()) {
+                tiempoRestante -= ejecutarTiempoReal(limite);
+                continue;
+            }
+        }
+        if (!actual && !grupos.hayElegibles()) {
+            // CPU ociosa esperando a la E/S, a un temporizador o a la proxima liberacion
+            reloj += limite;
+            tiempoRestante -= limite;
+            avanzarES(limite, false);
+            continue;
+        }
+
+        // Round robin: saltar en forma cerrada las rondas sin terminaciones
+        if constexpr (requires { politica.saltarRondas(*tabla, quantum, tiempoRestante); }) {
+            // Un proceso que nunca corrio necesita su marca de primera ejecucion: esa ronda va paso a paso.
+            // Con costo de cambio cada despacho depende de la cache de cada proceso, y con
+            // grupos cada turno elige grupo y cobra cuota: sin saltos
+            if (!porRebanada && !actual && rebanadasSinSalto == 0 && sinPrimeraEjecucion == 0
+                && !modeloCambio.activo() && !grupos.activos()) {
+                long long salto = politica.saltarRondas(*tabla, quantum, limite);
+                if (salto > 0) {
+                    tiempoRestante -= salto;
+                    reloj += salto;
+                    metricas.ticksOcupado += salto;
+                    // Cada ronda saltada despacha a todos los procesos de la cola; el primer
+                    // despacho no cambia de contexto si repite al ultimo proceso que corrio
+                    long long despachos = politica.tamano() > 1 ? salto / quantum : 1;
+                    if (huboDespacho && politica.cola.front()->pid == ultimoPid)
+                        --despachos;
+                    metricas.cambiosContexto[0] += despachos;
+                    ultimoPid = politica.cola.back()->pid;
+                    huboDespacho = true;
+                    traza::emitir(reloj, nullptr, traza::Evento::Salto, salto);
+                    avanzarES(salto, true);
+                }
+                // La ronda siguiente contiene una terminacion o agota el presupuesto
+                rebanadasSinSalto = politica.tamano();
+                continue;
+            }
+            if (!actual && rebanadasSinSalto > 0)
+                --rebanadasSinSalto;
+            else if (!actual && sinPrimeraEjecucion > 0)
+                rebanadasSinSalto = politica.tamano();
+        }
+        tiempoRestante -= ejecutarRebanada(quantum, limite);
+    }
+    // Lo que sobra del presupuesto es tiempo ocioso, sin trabajo en el sistema: no cuenta como encendido
+    metricas.ticksEncendido += (uint64_t) (reloj - inicio);
+    reloj = relojFinal;
 }
 
 
-void Scheduler::listarProcesos() const {
+template <typename Politica>
+void Scheduler<Politica>::listarProcesos() const {
     std::cout << "=== Procesos en cola ===" << std::endl;
-    for (PCB* proceso : cola) {
-        std::cout << "Proceso: " << proceso->name
-                  << " | Tiempo restante: " << proceso->tiempoEjecucion << std::endl;
+    auto mostrar = [](PCB* proceso) {
+        std::cout << "Proceso: " << proceso->name << " (pid " << proceso->pid << ")"
+                  << " | Tiempo restante: " << proceso->restante() << std::endl;
+    };
+    // Cada grupo con su interrumpido primero, como se despacharian
+    auto mostrarGrupos = [&](bool bloqueados) {
+        for (uint32_t grupo = 0; grupo < grupos.cantidad(); ++grupo) {
+            if (grupos.bloqueado(grupo) != bloqueados)
+                continue;
+            if (PCB* proceso = grupos.interrumpido(grupo))
+                mostrar(proceso);
+            if (const Politica* cola = colaSiExiste(grupo))
+                cola->recorrer(mostrar);
+        }
+    };
+    if (actual)
+        mostrar(actual);
+    mostrarGrupos(false);
+
+    if (grupos.hayRetenidos()) {
+        std::cout << "=== Procesos retenidos por cuota de grupo ===" << std::endl;
+        mostrarGrupos(true);
     }
+
+    if (!dispositivo.ocioso()) {
+        std::cout << "=== Procesos bloqueados (E/S) ===" << std::endl;
+        dispositivo.recorrer([](PCB* proceso) {
+            std::cout << "Proceso: " << proceso->name << " (pid " << proceso->pid << ")"
+                      << " | E/S restante: " << proceso->restante() << std::endl;
+        });
+    }
+}
+
+template <typename Politica>
+void Scheduler<Politica>::guardar(instantanea::Escritor& escritor) const {
+    escritor.valor(reloj);
+    escritor.valor(curQuantum);
+    escritor.valor(tramoGrupo);
+    escritor.valor(TablaProcesos::indiceDe(actual));
+    escritor.valor(ultimoPid);
+    escritor.valor(huboDespacho);
+    escritor.valor<uint64_t>(sinPrimeraEjecucion);
+    politica.guardar(escritor);
+    escritor.valor<uint64_t>(colasGrupo.size());
+    for (const Politica& cola : colasGrupo) cola.guardar(escritor);
+    dispositivo.guardar(escritor);
+    temporizadores.guardar(escritor);
+    tareasPeriodicas.guardar(escritor);
+    control.guardar(escritor);
+    escritor.valor(modeloCambio);
+    escritor.valor(deudaCambio);
+    grupos.guardar(escritor);
+    metricas.guardar(escritor);
 }
 
+template <typename Politica>
+void Scheduler<Politica>::cargar(instantanea::Lector& lector) {
+    reloj = lector.valor<long long>();
+    curQuantum = lector.valor<int>();
+    tramoGrupo = lector.valor<int>();
+    actual = tabla->ranura(lector.valor<uint32_t>());
+    ultimoPid = lector.valor<Pid>();
+    huboDespacho = lector.valor<bool>();
+    sinPrimeraEjecucion = (size_t) lector.valor<uint64_t>();
+    politica.cargar(lector, *tabla);
+    uint64_t colas = lector.valor<uint64_t>();
+    if (colas >= UINT32_MAX)
+        throw runtime_error("grupos inconsistentes");
+    colasGrupo.resize((size_t) colas);
+    for (Politica& cola : colasGrupo) cola.cargar(lector, *tabla);
+    dispositivo.cargar(lector, *tabla);
+    temporizadores.cargar(lector, *tabla);
+    tareasPeriodicas.cargar(lector);
+    control.cargar(lector);
+    modeloCambio = lector.valor<CostoCambio>();
+    deudaCambio = lector.valor<int>();
+    grupos.cargar(lector, *tabla);
+    // Cada cola debe tener exactamente los listos que su grupo cree tener
+    if (colasGrupo.size() >= grupos.cantidad())
+        throw runtime_error("grupos inconsistentes");
+    for (uint32_t grupo = 0; grupo < grupos.cantidad(); ++grupo) {
+        const Politica* cola = colaSiExiste(grupo);
+        size_t encolados = (cola ? cola->tamano() : 0) + (grupos.interrumpido(grupo) ? 1 : 0);
+        if (encolados != grupos.listos(grupo))
+            throw runtime_error("grupos inconsistentes");
+        if (cola)
+            cola->recorrer([&](PCB* proceso) {
+                if (proceso->grupo != grupo)
+                    throw runtime_error("grupos inconsistentes");
+            });
+    }
+    metricas.cargar(lector);
+}
 
+template class Scheduler<politicas::FIFO>;
+template class Scheduler<politicas::SJF>;
+template class Scheduler<politicas::SRTF>;
+template class Scheduler<politicas::Prioridad>;
+template class Scheduler<politicas::RoundRobin>;
+template class Scheduler<politicas::PrioridadO1>;
+template class Scheduler<politicas::CFS>;
+template class Scheduler<politicas::Loteria>;
+template class Scheduler<politicas::Stride>;
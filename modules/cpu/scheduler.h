@@ -1,16 +1,93 @@
 #pragma once
 #include "pcb.h"
-#include <deque>
+#include "politicas.h"
+#include "cola_prioridad.h"
+#include "cfs.h"
+#include "proporcional.h"
+#include "tabla_procesos.h"
+#include "metricas.h"
+#include "control_quantum.h"
+#include "costo_cambio.h"
+#include "grupos.h"
+#include "tiempo_real.h"
+#include "rueda_temporizadores.h"
+#include "../io/dispositivo.h"
 
 using namespace std;
 
+// Planificador generico: el ciclo de despacho se especializa en compilacion
+// para cada politica, sin llamadas virtuales.
+template <typename Politica>
 class Scheduler {
 public:
+    explicit Scheduler(TablaProcesos& tabla);
+
+    // proceso debe vivir en `tabla`; el scheduler lo libera al terminar
     void agregarProceso(PCB* proceso);
-    void ejecutar(int quantum, int tick);
+    void ejecutar(int quantum, long long tick);
     void listarProcesos()const;
+    const Metricas& estadisticas() const { return metricas; }
+    long long relojActual() const { return reloj; }
+    // Clase de tiempo real, por encima de la politica
+    TiempoReal& tiempoReal() { return tareasPeriodicas; }
+    const TiempoReal& tiempoReal() const { return tareasPeriodicas; }
+    const RuedaTemporizadores& temporizadoresPendientes() const { return temporizadores; }
+    ControlQuantum& controlQuantum() { return control; }
+    const ControlQuantum& controlQuantum() const { return control; }
+    CostoCambio& costoCambio() { return modeloCambio; }
+    const CostoCambio& costoCambio() const { return modeloCambio; }
+    // La politica de la raiz, para leer sus parametros (p. ej. las rebanadas de CFS)
+    const Politica& politicaListos() const { return politica; }
+    // Ajusta la cola de la raiz y la de cada grupo: todas tienen la misma configuracion,
+    // asi que si una la acepta, todas
+    template <typename F>
+    bool ajustarColas(F ajustar) {
+        if (!ajustar(politica))
+            return false;
+        for (Politica& cola : colasGrupo) ajustar(cola);
+        return true;
+    }
+    // Grupos de control con cuota y peso: eligen la cola antes que la politica
+    Grupos& gruposControl() { return grupos; }
+    const Grupos& gruposControl() const { return grupos; }
+
+    // Estado entre comandos; cargar espera un scheduler recien creado sobre la tabla ya cargada
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector);
 
 private:
-    deque<PCB*> cola;
+    long long ejecutarRebanada(int quantum, long long tiempoRestante);
+    long long ejecutarTiempoReal(long long tiempoRestante);
+    bool elegirListo(int quantum);
+    void apartar();
+    Politica& colaDe(uint32_t grupo);
+    const Politica* colaSiExiste(uint32_t grupo) const;
+    Politica colaNueva() const;
+    void devolver(PCB* proceso);
+    void envejecer(long long ticks);
+    void despachar(PCB& proceso);
+    long long pagarCambio(long long tiempoRestante);
+    void avanzarES(long long ticks, bool cpuOcupada);
+    void encaminar(PCB* proceso);
+    void encolarListo(PCB* proceso);
+
+    TablaProcesos* tabla;
+    Politica politica;              // cola de los procesos de la raiz (sin grupos, de todos)
+    vector<Politica> colasGrupo;    // la del grupo i en i - 1, creadas al usarlas
+    PCB* actual = nullptr; // proceso con la CPU entre llamadas
     int curQuantum = 0;
-};
\ No newline at end of file
+    int tramoGrupo = 0;    // ticks que le quedan al turno del grupo de `actual`
+    long long reloj = 0;   // ticks simulados desde el arranque
+    DispositivoES dispositivo; // atiende a los procesos bloqueados mientras la CPU sigue
+    TiempoReal tareasPeriodicas;
+    RuedaTemporizadores temporizadores; // procesos dormidos (rafagas de espera)
+    ControlQuantum control;              // quantum adaptativo, apagado por defecto
+    CostoCambio modeloCambio;            // cambios de contexto gratis por defecto
+    int deudaCambio = 0;                 // ticks del cambio en curso aun sin pagar
+    Grupos grupos;                       // solo la raiz por defecto
+
+    Metricas metricas;
+    Pid ultimoPid;                  // ultimo proceso despachado, para contar cambios de contexto
+    bool huboDespacho = false;
+    size_t sinPrimeraEjecucion = 0; // procesos en cola que nunca han corrido
+};
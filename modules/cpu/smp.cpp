@@ -0,0 +1,479 @@
+#include "smp.h"
+#include "traza.h"
+#include "../snapshot/instantanea.h"
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+static ColaNucleo crearCola(Planificacion planificacion) {
+    switch (planificacion) {
+        case Planificacion::FIFO: return politicas::FIFO{};
+        case Planificacion::SJF: return politicas::SJF{};
+        case Planificacion::SRTF: return politicas::SRTF{};
+        case Planificacion::Prioridad: return politicas::Prioridad{};
+        case Planificacion::RoundRobin: break;
+        case Planificacion::PrioridadO1: return politicas::PrioridadO1{};
+        case Planificacion::CFS: return politicas::CFS{};
+        case Planificacion::Loteria: return politicas::Loteria{};
+        case Planificacion::Stride: return politicas::Stride{};
+    }
+    return politicas::RoundRobin{};
+}
+
+static size_t tamanoCola(const ColaNucleo& cola) {
+    return visit([](const auto& c) { return c.tamano(); }, cola);
+}
+
+SMP::SMP(int cantidad, int quantum, Planificacion planificacion, TablaProcesos& tabla)
+    : tabla(tabla), planificacion(planificacion), quantum(quantum), quantumFijo(quantum) {
+    for (int i = 0; i < cantidad; ++i) {
+        nucleos.push_back(make_unique<Nucleo>());
+        nucleos.back()->cola = crearCola(planificacion);
+    }
+}
+
+// Los procesos pertenecen a la tabla de la CPU
+SMP::~SMP() = default;
+
+// Solo se llama entre comandos, con los hilos de los nucleos detenidos
+void SMP::agregarProceso(PCB* proceso) {
+    proceso->fijarEstado(EstadoProceso::Listo);
+    proceso->llegada = reloj;
+    size_t destino = elegirNucleo(*proceso, (uint64_t) reloj);
+    traza::emitir(reloj, proceso, traza::Evento::Llegada, proceso->restante(), (int) destino);
+    encolar(destino, proceso);
+    ++vivos;
+}
+
+// Una llegada a la cola de un nucleo. En politicas expropiativas obliga a replanificar
+// al proceso de ese nucleo, que vuelve a la cola y compite con la llegada al despachar.
+// Solo con los hilos detenidos: entre comandos o al cerrar un tick.
+void SMP::encolar(size_t destino, PCB* proceso) {
+    Nucleo& nucleo = *nucleos[destino];
+    visit([&](auto& cola) {
+        cola.encolar(proceso);
+        if constexpr (remove_reference_t<decltype(cola)>::expropiativa) {
+            if (nucleo.actual) {
+                nucleo.actual->fijarEstado(EstadoProceso::Listo);
+                cola.encolar(nucleo.actual);
+                nucleo.actual = nullptr;
+                nucleo.curQuantum = 0;
+            }
+        }
+    }, nucleo.cola);
+}
+
+// Proximo proceso de la cola propia; si esta vacia, el proximo del primer nucleo con
+// trabajo a partir del vecino (la victima entrega el que ella misma despacharia)
+PCB* SMP::tomarTrabajo(int id, uint64_t tickActual) {
+    auto siguiente = [](Nucleo& nucleo) {
+        return visit([](auto& cola) { return cola.vacia() ? nullptr : cola.siguiente(); }, nucleo.cola);
+    };
+    Nucleo& propio = *nucleos[id];
+    if (PCB* proceso = siguiente(propio))
+        return proceso;
+
+    for (size_t k = 1; k < nucleos.size(); ++k) {
+        if (PCB* proceso = siguiente(*nucleos[(id + k) % nucleos.size()])) {
+            ++propio.robos;
+            traza::emitir(tickActual, proceso, traza::Evento::Robo, 0, id);
+            return proceso;
+        }
+    }
+    return nullptr;
+}
+
+// Los nucleos libres eligen su proceso para `tickActual`, en orden de nucleo: el
+// reparto y los robos no dependen del orden en que los hilos llegan a la barrera.
+// Corre con los hilos detenidos (antes de lanzarlos o al cerrar el tick anterior).
+void SMP::despachar(uint64_t tickActual) {
+    for (int id = 0; id < (int) nucleos.size(); ++id) {
+        Nucleo& nucleo = *nucleos[id];
+        if (nucleo.actual)
+            continue;
+        PCB* elegido = tomarTrabajo(id, tickActual);
+        nucleo.actual = elegido;
+        if (!elegido)
+            continue;
+        nucleo.curQuantum = visit([&](const auto& cola) { return cola.rebanada(*elegido, quantum); }, nucleo.cola);
+        elegido->fijarEstado(EstadoProceso::Ejecutando);
+        if (!nucleo.huboDespacho || elegido->pid != nucleo.ultimoPid) {
+            ++nucleo.metricas.cambiosContexto[0];
+            nucleo.deudaCambio = modeloCambio.costo(*elegido, id, (long long) tickActual - 1);
+        }
+        nucleo.ultimoPid = elegido->pid;
+        nucleo.huboDespacho = true;
+    }
+}
+
+// Reparto round robin, o por energia. Con despacho por afinidad, el proceso vuelve
+// a su nucleo anterior si la espera ahi mas su cache tibia cuesta menos que la del
+// nucleo elegido con la cache fria.
+size_t SMP::elegirNucleo(const PCB& proceso, uint64_t tickActual) {
+    bool porEnergia = energia.colocacion == Colocacion::Energia;
+    size_t destino = porEnergia ? nucleoPorEnergia(proceso) : siguienteNucleo;
+    int previo = proceso.nucleoPrevio;
+    if (modeloCambio.activo() && modeloCambio.afinidad() && previo >= 0
+        && (size_t) previo < nucleos.size() && (size_t) previo != destino) {
+        auto espera = [&](size_t id) {
+            const Nucleo& nucleo = *nucleos[id];
+            return ((int) tamanoCola(nucleo.cola) + (nucleo.actual ? 1 : 0)) * quantum
+                 + modeloCambio.costo(proceso, (int) id, (long long) tickActual);
+        };
+        if (espera((size_t) previo) <= espera(destino))
+            return (size_t) previo;
+    }
+    if (!porEnergia)
+        siguienteNucleo = (siguienteNucleo + 1) % nucleos.size();
+    return destino;
+}
+
+// Las rafagas cortas van al nucleo eficiente menos cargado y las largas al grande
+// menos cargado; la busqueda arranca en un nucleo distinto cada vez para repartir
+// los empates. Sin nucleos del tipo buscado, vale cualquiera.
+size_t SMP::nucleoPorEnergia(const PCB& proceso) {
+    TipoNucleo buscado = proceso.restante() <= energia.umbralCorta ? TipoNucleo::Eficiente : TipoNucleo::Grande;
+    auto menosCargado = [&](bool filtrar) {
+        size_t mejor = nucleos.size();
+        int64_t menor = INT64_MAX;
+        for (size_t k = 0; k < nucleos.size(); ++k) {
+            size_t id = (siguienteNucleo + k) % nucleos.size();
+            const Nucleo& nucleo = *nucleos[id];
+            if (filtrar && nucleo.tipo != buscado)
+                continue;
+            int64_t carga = (int64_t) tamanoCola(nucleo.cola) + (nucleo.actual ? 1 : 0);
+            if (carga < menor) {
+                menor = carga;
+                mejor = id;
+            }
+        }
+        return mejor;
+    };
+    size_t destino = menosCargado(true);
+    if (destino == nucleos.size())
+        destino = menosCargado(false);
+    siguienteNucleo = (siguienteNucleo + 1) % nucleos.size();
+    return destino;
+}
+
+// Un proceso acaba de empezar una rafaga: va a un nucleo, al dispositivo o a dormir
+void SMP::encaminar(PCB* proceso, uint64_t tickActual) {
+    switch (proceso->tipoRafaga()) {
+        case TipoRafaga::CPU: {
+            proceso->fijarEstado(EstadoProceso::Listo);
+            size_t destino = elegirNucleo(*proceso, tickActual);
+            traza::emitir(tickActual, proceso, traza::Evento::Despierta, 0, (int) destino);
+            encolar(destino, proceso);
+            break;
+        }
+        case TipoRafaga::ES:
+            traza::emitir(tickActual, proceso, traza::Evento::Bloquea, proceso->restante());
+            dispositivo.solicitar(proceso);
+            break;
+        case TipoRafaga::Dormir:
+            proceso->fijarEstado(EstadoProceso::Bloqueado);
+            proceso->despertar = (long long) tickActual + proceso->restante();
+            traza::emitir(tickActual, proceso, traza::Evento::Duerme, proceso->restante());
+            temporizadores.programar(proceso->despertar, proceso);
+            break;
+    }
+}
+
+void SMP::CierreTick::operator()() noexcept {
+    uint64_t tickActual = (uint64_t) ++smp->tickCierre;
+
+    // La E/S en curso avanza un tick y vencen los temporizadores de este tick
+    long long ocupado = smp->dispositivo.transcurrir(1, [&](PCB* proceso) {
+        ++smp->metricasES.solicitudesES;
+        proceso->avanzarRafaga();
+        smp->encaminar(proceso, tickActual);
+    });
+    smp->metricasES.ticksOcupadoES += ocupado;
+    if (smp->ocupadosEnTick.exchange(0) > 0)
+        smp->metricasES.ticksSolapados += ocupado;
+    smp->temporizadores.avanzar((long long) tickActual, [&](PCB* proceso) {
+        proceso->avanzarRafaga();
+        smp->encaminar(proceso, tickActual);
+    });
+
+    // El controlador ve las rafagas del tick en orden de nucleo; el quantum nuevo
+    // rige para los despachos del tick siguiente
+    if (smp->control.activo()) {
+        for (auto& nucleo : smp->nucleos) {
+            for (int duracion : nucleo->rafagas)
+                smp->control.registrar(duracion, (long long) tickActual);
+            nucleo->rafagas.clear();
+        }
+        smp->quantum = smp->control.quantum(smp->quantumFijo);
+    }
+
+    // Los que terminaron una rafaga de CPU en este tick empiezan su espera en el siguiente
+    for (auto& nucleo : smp->nucleos) {
+        for (PCB* proceso : nucleo->bloqueados)
+            smp->encaminar(proceso, tickActual);
+        nucleo->bloqueados.clear();
+    }
+
+    // Al cerrar cada tick se revisa si ya no queda trabajo en ningun nucleo
+    if (smp->vivos.load() == 0)
+        smp->detener = true;
+    else if (smp->tickCierre < smp->tickFinal)
+        smp->despachar(tickActual + 1);
+}
+
+void SMP::correrNucleo(int id, long long tick, barrier<CierreTick>& sincronia) {
+    Nucleo& nucleo = *nucleos[id];
+
+    for (long long t = 0; t < tick && !detener; ++t) {
+        uint64_t tickActual = reloj + t + 1;
+        PCB* proceso = nucleo.actual;
+        const PerfilNucleo& perfil = perfilNucleo(nucleo.tipo);
+        const EstadoFrecuencia& frecuencia = perfil.estados[nucleo.estado];
+        if (proceso && nucleo.deudaCambio > 0) {
+            // El cambio de contexto ocupa el nucleo sin que el proceso avance
+            --nucleo.deudaCambio;
+            ++nucleo.metricas.ticksCambio;
+            ocupadosEnTick.fetch_add(1, memory_order_relaxed);
+            visit([](auto& cola) {
+                if constexpr (requires { cola.transcurrir(0LL); })
+                    cola.transcurrir(1);
+            }, nucleo.cola);
+        } else if (proceso) {
+            nucleo.metricas.registrarPrimeraEjecucion(*proceso, tickActual - 1);
+            // El nucleo acumula su velocidad; cada VELOCIDAD_BASE es una unidad de trabajo.
+            // Un nucleo lento ocupa ticks enteros sin completar ninguna.
+            nucleo.credito += frecuencia.velocidad;
+            int trabajo = min(nucleo.credito / VELOCIDAD_BASE, proceso->restante());
+            nucleo.credito = min(nucleo.credito - trabajo * VELOCIDAD_BASE, VELOCIDAD_BASE - 1);
+            proceso->ejecutar(trabajo);
+            proceso->nucleoPrevio = id;
+            proceso->salidaCPU = (long long) tickActual;
+            ocupadosEnTick.fetch_add(1, memory_order_relaxed);
+            --nucleo.curQuantum;
+            ++nucleo.metricas.ticksOcupado;
+            traza::emitir(tickActual, proceso, traza::Evento::Ejecuta, trabajo, id);
+            visit([&](auto& cola) {
+                if constexpr (requires { cola.contabilizar(*proceso, 0); })
+                    cola.contabilizar(*proceso, trabajo);
+                if constexpr (requires { cola.transcurrir(0LL); })
+                    cola.transcurrir(1);
+            }, nucleo.cola);
+            if (proceso->restante() <= 0 && control.activo())
+                nucleo.rafagas.push_back(proceso->duracionRafaga());
+
+            if (proceso->terminado()) {
+                traza::emitir(tickActual, proceso, traza::Evento::Termina, 0, id);
+                nucleo.metricas.registrarTerminacion(*proceso, tickActual);
+                // La lista libre de la tabla no es concurrente: se libera despues del join
+                proceso->fijarEstado(EstadoProceso::Terminado);
+                nucleo.terminados.push_back(proceso);
+                nucleo.actual = nullptr;
+                --vivos;
+            } else if (proceso->restante() <= 0) {
+                // Fin de una rafaga de CPU: la siguiente es de E/S o de espera
+                proceso->avanzarRafaga();
+                nucleo.bloqueados.push_back(proceso);
+                nucleo.actual = nullptr;
+            } else if (nucleo.curQuantum <= 0) {
+                // La cola propia: nadie mas la toca hasta cerrar el tick
+                proceso->fijarEstado(EstadoProceso::Listo);
+                visit([&](auto& cola) { cola.encolar(proceso); }, nucleo.cola);
+                nucleo.actual = nullptr;
+            }
+        } else {
+            nucleo.credito = 0;
+        }
+
+        // Energia del tick; el gobernador decide al cerrar cada ventana
+        nucleo.metricas.energia += (uint64_t) (proceso ? frecuencia.potencia : perfil.reposo) * MS_POR_TICK;
+        ++nucleo.metricas.ticksEncendido;
+        nucleo.ocupadosVentana += proceso ? 1 : 0;
+        if (tickActual % VENTANA_DVFS == 0) {
+            nucleo.estado = ajustarFrecuencia(energia.gobernador, nucleo.estado, nucleo.ocupadosVentana);
+            nucleo.ocupadosVentana = 0;
+        }
+
+        sincronia.arrive_and_wait();
+    }
+}
+
+void SMP::ejecutar(long long tick) {
+    // El reloj solo avanza: un presupuesto negativo lo haria retroceder
+    if (tick <= 0)
+        return;
+    if (vivos == 0) {
+        reloj += tick;
+        return;
+    }
+    detener = false;
+    tickCierre = reloj;
+    tickFinal = reloj + tick;
+    despachar((uint64_t) reloj + 1);
+
+    barrier<CierreTick> sincronia((ptrdiff_t) nucleos.size(), CierreTick{this});
+    vector<thread> hilos;
+    for (int id = 0; id < (int) nucleos.size(); ++id)
+        hilos.emplace_back(&SMP::correrNucleo, this, id, tick, ref(sincronia));
+    for (thread& hilo : hilos)
+        hilo.join();
+    reloj += tick;
+
+    for (auto& nucleo : nucleos) {
+        for (PCB* proceso : nucleo->terminados)
+            tabla.liberar(proceso);
+        nucleo->terminados.clear();
+    }
+}
+
+void SMP::listarProcesos() const {
+    for (size_t id = 0; id < nucleos.size(); ++id) {
+        const Nucleo& nucleo = *nucleos[id];
+        cout << "=== Nucleo " << id << " (robos: " << nucleo.robos
+             << ", ticks ocupado: " << nucleo.metricas.ticksOcupado << ") ===" << endl;
+        auto mostrar = [](PCB* proceso) {
+            cout << "Proceso: " << proceso->name << " (pid " << proceso->pid << ")"
+                 << " | Tiempo restante: " << proceso->restante() << endl;
+        };
+        if (nucleo.actual)
+            mostrar(nucleo.actual);
+        visit([&](const auto& cola) { cola.recorrer(mostrar); }, nucleo.cola);
+    }
+
+    if (!dispositivo.ocioso()) {
+        cout << "=== Procesos bloqueados (E/S) ===" << endl;
+        dispositivo.recorrer([](PCB* proceso) {
+            cout << "Proceso: " << proceso->name << " (pid " << proceso->pid << ")"
+                 << " | E/S restante: " << proceso->restante() << endl;
+        });
+    }
+}
+
+Metricas SMP::estadisticas() const {
+    Metricas total;
+    total.cambiosContexto.assign(nucleos.size(), 0);
+    for (size_t id = 0; id < nucleos.size(); ++id) {
+        Metricas propias = nucleos[id]->metricas;
+        uint64_t cambios = propias.cambiosContexto[0];
+        propias.cambiosContexto[0] = 0;
+        total.combinar(propias);
+        total.cambiosContexto[id] = cambios;
+    }
+    total.combinar(metricasES);
+    return total;
+}
+
+void SMP::guardar(instantanea::Escritor& escritor) const {
+    escritor.valor(reloj);
+    escritor.valor<uint64_t>(siguienteNucleo);
+    escritor.valor<int64_t>(vivos.load());
+    escritor.valor(tickCierre);
+    for (const auto& nucleo : nucleos) {
+        visit([&](const auto& cola) { cola.guardar(escritor); }, nucleo->cola);
+        escritor.valor(TablaProcesos::indiceDe(nucleo->actual));
+        escritor.valor(nucleo->curQuantum);
+        escritor.valor(nucleo->robos);
+        escritor.valor(nucleo->ultimoPid);
+        escritor.valor(nucleo->huboDespacho);
+        escritor.valor(nucleo->deudaCambio);
+        escritor.valor(nucleo->tipo);
+        escritor.valor(nucleo->estado);
+        escritor.valor(nucleo->credito);
+        escritor.valor(nucleo->ocupadosVentana);
+        nucleo->metricas.guardar(escritor);
+    }
+    dispositivo.guardar(escritor);
+    temporizadores.guardar(escritor);
+    metricasES.guardar(escritor);
+    escritor.valor(quantum);
+    escritor.valor(quantumFijo);
+    control.guardar(escritor);
+    escritor.valor(modeloCambio);
+    escritor.valor(energia);
+}
+
+void SMP::cargar(instantanea::Lector& lector) {
+    reloj = lector.valor<long long>();
+    siguienteNucleo = (size_t) lector.valor<uint64_t>() % nucleos.size();
+    vivos = lector.valor<int64_t>();
+    tickCierre = lector.valor<long long>();
+    for (auto& nucleo : nucleos) {
+        nucleo = make_unique<Nucleo>();
+        nucleo->cola = crearCola(planificacion);
+        visit([&](auto& cola) { cola.cargar(lector, tabla); }, nucleo->cola);
+        nucleo->actual = tabla.ranura(lector.valor<uint32_t>());
+        nucleo->curQuantum = lector.valor<int>();
+        nucleo->robos = lector.valor<long long>();
+        nucleo->ultimoPid = lector.valor<Pid>();
+        nucleo->huboDespacho = lector.valor<bool>();
+        nucleo->deudaCambio = lector.valor<int>();
+        nucleo->tipo = lector.valor<TipoNucleo>();
+        nucleo->estado = lector.valor<int>();
+        nucleo->credito = lector.valor<int>();
+        nucleo->ocupadosVentana = lector.valor<int>();
+        if ((int) nucleo->tipo > (int) TipoNucleo::Eficiente || nucleo->estado < 0 || nucleo->estado > 2)
+            throw runtime_error("nucleo inconsistente");
+        nucleo->metricas.cargar(lector);
+    }
+    dispositivo.cargar(lector, tabla);
+    temporizadores.cargar(lector, tabla);
+    metricasES.cargar(lector);
+    quantum = lector.valor<int>();
+    quantumFijo = lector.valor<int>();
+    control.cargar(lector);
+    modeloCambio = lector.valor<CostoCambio>();
+    energia = lector.valor<ConfigEnergia>();
+}
+
+bool SMP::fijarTipos(const vector<TipoNucleo>& tipos) {
+    if (tipos.size() != nucleos.size())
+        return false;
+    for (size_t id = 0; id < nucleos.size(); ++id) {
+        nucleos[id]->tipo = tipos[id];
+        nucleos[id]->credito = 0;
+    }
+    return true;
+}
+
+void SMP::fijarEnergia(const ConfigEnergia& config) {
+    energia = config;
+    for (auto& nucleo : nucleos) {
+        nucleo->estado = energia.estadoInicial();
+        nucleo->ocupadosVentana = 0;
+    }
+}
+
+bool SMP::fijarRebanadasCFS(int granularidad, optional<int> latencia) {
+    if (!cfs())
+        return false;
+    // Todos los nucleos tienen la misma configuracion: si uno la acepta, todos
+    int objetivo = latencia.value_or(cfs()->latencia());
+    for (auto& nucleo : nucleos)
+        if (!get<politicas::CFS>(nucleo->cola).fijarRebanadas(granularidad, objetivo))
+            return false;
+    return true;
+}
+
+const politicas::CFS* SMP::cfs() const {
+    return get_if<politicas::CFS>(&nucleos[0]->cola);
+}
+
+void SMP::listarEnergia() const {
+    cout << "=== Energia (gobernador: " << nombreGobernador(energia.gobernador) << ", colocacion: "
+         << nombreColocacion(energia.colocacion);
+    if (energia.colocacion == Colocacion::Energia)
+        cout << ", cortas hasta " << energia.umbralCorta << " ticks";
+    cout << ") ===" << endl;
+    uint64_t total = 0;
+    for (size_t id = 0; id < nucleos.size(); ++id) {
+        const Nucleo& nucleo = *nucleos[id];
+        const PerfilNucleo& perfil = perfilNucleo(nucleo.tipo);
+        const EstadoFrecuencia& frecuencia = perfil.estados[nucleo.estado];
+        const Metricas& m = nucleo.metricas;
+        total += m.energia;
+        cout << "  Nucleo " << id << ": " << left << setw(10) << perfil.nombre << right << setw(5) << frecuencia.mhz
+             << " MHz (x" << fixed << setprecision(2) << (double) frecuencia.velocidad / VELOCIDAD_BASE << ", "
+             << frecuencia.potencia << " mW) | " << setprecision(3) << m.energia / 1e6 << " J | ocupado "
+             << m.ticksOcupado + m.ticksCambio << " de " << m.ticksEncendido << " ticks" << endl;
+    }
+    cout << "  total: " << fixed << setprecision(3) << total / 1e6 << " J" << endl;
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include "pcb.h"
+#include "politicas.h"
+#include "cola_prioridad.h"
+#include "cfs.h"
+#include "proporcional.h"
+#include "tabla_procesos.h"
+#include "metricas.h"
+#include "control_quantum.h"
+#include "costo_cambio.h"
+#include "energia.h"
+#include "../io/dispositivo.h"
+#include "rueda_temporizadores.h"
+#include <atomic>
+#include <barrier>
+#include <memory>
+#include <optional>
+#include <variant>
+#include <vector>
+
+using namespace std;
+
+// Cola de listos de un nucleo: una instancia de la politica elegida (mismo orden que Planificacion)
+using ColaNucleo = variant<politicas::FIFO, politicas::SJF, politicas::SRTF, politicas::Prioridad,
+                           politicas::RoundRobin, politicas::PrioridadO1, politicas::CFS,
+                           politicas::Loteria, politicas::Stride>;
+
+// Multiprocesador simulado: N nucleos, cada uno con su propia cola de la politica
+// elegida y su propio hilo durante `tick`. Los nucleos avanzan en paso con una
+// barrera por tick. Los despachos se deciden al cerrar cada tick, en orden de
+// nucleo: cada nucleo libre toma de su cola y, si esta vacia, le roba el proximo
+// proceso al primer nucleo con trabajo a partir del vecino. Asi el reparto no
+// depende de que hilo llega antes y la misma carga da siempre el mismo resultado.
+// El dispositivo de E/S y los temporizadores son compartidos y se atienden al cerrar cada tick.
+class SMP {
+public:
+    SMP(int nucleos, int quantum, Planificacion planificacion, TablaProcesos& tabla);
+    ~SMP();
+
+    void agregarProceso(PCB* proceso);
+    void ejecutar(long long tick);
+    void listarProcesos() const;
+    int cantidadNucleos() const { return (int) nucleos.size(); }
+    Metricas estadisticas() const; // combinada; cambios de contexto por nucleo
+    long long relojActual() const { return reloj; }
+    const RuedaTemporizadores& temporizadoresPendientes() const { return temporizadores; }
+    // Se ajusta entre comandos; el quantum vigente se recalcula al cerrar cada tick
+    ControlQuantum& controlQuantum() { return control; }
+    const ControlQuantum& controlQuantum() const { return control; }
+    void fijarQuantum(int nuevo) { quantumFijo = quantum = nuevo; }
+    CostoCambio& costoCambio() { return modeloCambio; }
+    const CostoCambio& costoCambio() const { return modeloCambio; }
+    // Tipo de cada nucleo (false si no hay uno por nucleo), gobernador y colocacion
+    bool fijarTipos(const vector<TipoNucleo>& tipos);
+    void fijarEnergia(const ConfigEnergia& config);
+    const ConfigEnergia& configEnergia() const { return energia; }
+    void listarEnergia() const;
+    // Rebanadas de CFS en todos los nucleos; false si la politica no es CFS o no
+    // 1 <= granularidad <= latencia. cfs() da la configuracion (nulo si no es CFS).
+    bool fijarRebanadasCFS(int granularidad, optional<int> latencia);
+    const politicas::CFS* cfs() const;
+
+    // Entre comandos: colas por nucleo, dispositivo, temporizadores y metricas.
+    // cargar espera la misma cantidad de nucleos y la tabla ya cargada.
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector);
+
+private:
+    struct Nucleo {
+        ColaNucleo cola;         // solo la toca su hilo durante el tick; el resto, al cerrarlo
+        PCB* actual = nullptr;
+        int curQuantum = 0;
+        long long robos = 0;
+        Metricas metricas;
+        Pid ultimoPid;
+        bool huboDespacho = false;
+        int deudaCambio = 0;     // ticks del cambio de contexto en curso
+        TipoNucleo tipo = TipoNucleo::Grande;
+        int estado = 0;          // estado de frecuencia vigente
+        int credito = 0;         // trabajo acumulado, en milesimas de unidad
+        int ocupadosVentana = 0; // ticks ocupados en la ventana del gobernador
+        vector<PCB*> terminados; // se devuelven a la tabla al cerrar el comando
+        vector<PCB*> bloqueados; // pasan al dispositivo o a dormir al cerrar el tick
+        vector<int> rafagas;     // rafagas de CPU completas en el tick, para el controlador
+    };
+
+    struct CierreTick {
+        SMP* smp;
+        void operator()() noexcept;
+    };
+
+    void correrNucleo(int id, long long tick, barrier<CierreTick>& sincronia);
+    void despachar(uint64_t tickActual);
+    PCB* tomarTrabajo(int id, uint64_t tickActual);
+    void encolar(size_t destino, PCB* proceso);
+    void encaminar(PCB* proceso, uint64_t tickActual);
+    size_t elegirNucleo(const PCB& proceso, uint64_t tickActual);
+    size_t nucleoPorEnergia(const PCB& proceso);
+
+    TablaProcesos& tabla;
+    Planificacion planificacion;
+    vector<unique_ptr<Nucleo>> nucleos;
+    int quantum;      // vigente: lo leen los nucleos al despachar
+    int quantumFijo;
+    ControlQuantum control;
+    CostoCambio modeloCambio;
+    ConfigEnergia energia;
+    size_t siguienteNucleo = 0;
+    atomic<long long> vivos{0};    // procesos sin terminar en todo el sistema
+    atomic<bool> detener{false};
+    long long reloj = 0;           // ticks simulados; solo cambia entre comandos
+
+    DispositivoES dispositivo;     // solo se tocan al cerrar cada tick, con los nucleos detenidos
+    RuedaTemporizadores temporizadores;
+    Metricas metricasES;
+    long long tickCierre = 0;
+    long long tickFinal = 0;       // ultimo tick del comando en curso
+    atomic<int> ocupadosEnTick{0}; // nucleos que ejecutaron algo en el tick en curso
+};
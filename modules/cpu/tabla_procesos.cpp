@@ -0,0 +1,171 @@
+#include "tabla_procesos.h"
+#include "vectorial.h"
+#include "../snapshot/instantanea.h"
+#include <climits>
+
+PCB* TablaProcesos::crear(const PCB& programa) {
+    uint32_t indice;
+    if (!libres.empty()) {
+        indice = libres.back();
+        libres.pop_back();
+        registros[indice] = programa;
+    } else {
+        indice = (uint32_t) registros.size();
+        registros.push_back(programa);
+        restante.push_back(0);
+        estado.push_back(EstadoProceso::Libre);
+        prioridad.push_back(0);
+        generacion.push_back(0);
+    }
+
+    PCB& proceso = registros[indice];
+    proceso.pid = Pid{indice, generacion[indice]};
+    proceso.tabla = this;
+    proceso.vruntime = 0;
+    proceso.llegada = 0;
+    proceso.primeraEjecucion = -1;
+    proceso.rafagaActual = 0;
+    proceso.sigCola = proceso.rbPadre = proceso.rbIzq = proceso.rbDer = nullptr;
+
+    restante[indice] = programa.rafagas.empty() ? programa.tiempoEjecucion : programa.rafagas[0].duracion;
+    estado[indice] = EstadoProceso::Listo;
+    prioridad[indice] = programa.prioridad;
+    memoria.crearEspacio(indice);
+    return &proceso;
+}
+
+void TablaProcesos::liberar(PCB* proceso) {
+    uint32_t indice = proceso->pid.indice;
+    estado[indice] = EstadoProceso::Libre;
+    restante[indice] = 0;
+    ++generacion[indice];
+    libres.push_back(indice);
+    memoria.destruirEspacio(indice);
+}
+
+PCB* TablaProcesos::obtener(Pid pid) {
+    return vivo(pid) ? &registros[pid.indice] : nullptr;
+}
+
+bool TablaProcesos::vivo(Pid pid) const {
+    return pid.indice < registros.size()
+        && generacion[pid.indice] == pid.generacion
+        && estado[pid.indice] != EstadoProceso::Libre;
+}
+
+PCB* TablaProcesos::ranura(uint32_t indice) {
+    if (indice == instantanea::NULO)
+        return nullptr;
+    if (indice >= registros.size())
+        throw runtime_error("ranura fuera de la tabla de procesos");
+    if (estado[indice] == EstadoProceso::Libre)
+        throw runtime_error("ranura libre en una cola de la instantanea");
+    return &registros[indice];
+}
+
+uint32_t TablaProcesos::indiceDe(const PCB* proceso) {
+    return proceso ? proceso->pid.indice : instantanea::NULO;
+}
+
+int TablaProcesos::minRestante(EstadoProceso filtro) const {
+    if (restante.size() >= UMBRAL_VECTORIAL)
+        return vectorial::minRestante(restante.data(), estado.data(), restante.size(), filtro);
+
+    int minimo = INT_MAX;
+    for (size_t i = 0; i < restante.size(); ++i)
+        if (estado[i] == filtro && restante[i] < minimo)
+            minimo = restante[i];
+    return minimo;
+}
+
+void TablaProcesos::avanzar(EstadoProceso filtro, int ticks) {
+    if (restante.size() >= UMBRAL_VECTORIAL) {
+        vectorial::avanzar(restante.data(), estado.data(), restante.size(), filtro, ticks);
+        return;
+    }
+    for (size_t i = 0; i < restante.size(); ++i)
+        if (estado[i] == filtro)
+            restante[i] -= ticks;
+}
+
+void TablaProcesos::guardar(instantanea::Escritor& escritor) const {
+    escritor.arreglo(restante);
+    escritor.arreglo(estado);
+    escritor.arreglo(prioridad);
+    escritor.arreglo(generacion);
+    escritor.arreglo(libres);
+
+    // Campos frios en registros de tamaño fijo; nombres y rafagas concatenados
+    vector<RegistroPCB> frios;
+    vector<uint32_t> largoNombre, cuantasRafagas;
+    string nombres;
+    vector<RafagaGuardada> rafagas;
+    frios.reserve(registros.size());
+    largoNombre.reserve(registros.size());
+    cuantasRafagas.reserve(registros.size());
+    for (const PCB& proceso : registros) {
+        frios.push_back(proceso.registro());
+        largoNombre.push_back((uint32_t) proceso.name.size());
+        nombres += proceso.name;
+        cuantasRafagas.push_back((uint32_t) proceso.rafagas.size());
+        for (const Rafaga& rafaga : proceso.rafagas) rafagas.push_back(RafagaGuardada::de(rafaga));
+    }
+    escritor.arreglo(frios);
+    escritor.arreglo(largoNombre);
+    escritor.texto(nombres);
+    escritor.arreglo(cuantasRafagas);
+    escritor.arreglo(rafagas);
+    memoria.guardar(escritor);
+}
+
+void TablaProcesos::cargar(instantanea::Lector& lector) {
+    lector.arreglo(restante);
+    lector.arreglo(estado);
+    lector.arreglo(prioridad);
+    lector.arreglo(generacion);
+    lector.arreglo(libres);
+
+    auto frios = lector.vista<RegistroPCB>();
+    auto largoNombre = lector.vista<uint32_t>();
+    auto nombres = lector.vista<char>();
+    auto cuantasRafagas = lector.vista<uint32_t>();
+    auto rafagas = lector.vista<RafagaGuardada>();
+    size_t n = restante.size();
+    if (estado.size() != n || prioridad.size() != n || generacion.size() != n || frios.size() != n
+        || largoNombre.size() != n || cuantasRafagas.size() != n)
+        throw runtime_error("tabla de procesos inconsistente");
+
+    // La lista libre tiene exactamente las ranuras Libre, cada una una vez; las demas
+    // guardan su propio indice y generacion en el pid
+    size_t sinUsar = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (estado[i] > EstadoProceso::Terminado)
+            throw runtime_error("tabla de procesos inconsistente");
+        if (estado[i] == EstadoProceso::Libre)
+            ++sinUsar;
+        else if (frios[i].pid.indice != i || frios[i].pid.generacion != generacion[i])
+            throw runtime_error("tabla de procesos inconsistente");
+    }
+    vector<char> enLista(n, 0);
+    for (uint32_t indice : libres) {
+        if (indice >= n || estado[indice] != EstadoProceso::Libre || enLista[indice])
+            throw runtime_error("lista libre inconsistente");
+        enLista[indice] = 1;
+    }
+    if (libres.size() != sinUsar)
+        throw runtime_error("lista libre inconsistente");
+
+    registros.clear();
+    size_t nombre = 0, rafaga = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (largoNombre[i] > nombres.size() - nombre || cuantasRafagas[i] > rafagas.size() - rafaga)
+            throw runtime_error("tabla de procesos inconsistente");
+        PCB& proceso = registros.emplace_back(string(nombres.data() + nombre, largoNombre[i]), 0);
+        nombre += largoNombre[i];
+        proceso.restaurar(frios[i]);
+        for (uint32_t k = 0; k < cuantasRafagas[i]; ++k)
+            proceso.rafagas.push_back(rafagas[rafaga++].rafaga());
+        proceso.tabla = this;
+    }
+    memoria.cargar(lector);
+}
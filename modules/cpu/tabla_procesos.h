@@ -0,0 +1,60 @@
+#pragma once
+#include "pcb.h"
+#include "../mem/paginacion.h"
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+using namespace std;
+
+// Tabla de procesos con identificadores generacionales.
+// Los campos que recorren los ciclos de planificacion (tiempo restante, estado,
+// prioridad efectiva) se guardan como arreglos paralelos indexados por ranura;
+// los PCB (campos frios y enlaces intrusivos) viven en una deque, asi que sus
+// direcciones no cambian al crecer. Las ranuras libres se reciclan con una lista
+// libre y cada reutilizacion incrementa la generacion.
+// Cada proceso tiene un espacio de direcciones en `memoria`, con la ranura como ASID:
+// se crea vacio junto con el proceso y se destruye al liberarlo.
+class TablaProcesos {
+public:
+    // Crea un proceso a partir de un programa. El proceso queda Listo.
+    PCB* crear(const PCB& programa);
+    // Devuelve la ranura a la lista libre e invalida su Pid.
+    void liberar(PCB* proceso);
+
+    // nullptr si el Pid ya no corresponde a un proceso vivo
+    PCB* obtener(Pid pid);
+    bool vivo(Pid pid) const;
+
+    // Proceso de la ranura (nulo para instantanea::NULO): reconstruye las colas de una
+    // instantanea. Lanza runtime_error si la ranura no existe o esta libre. indiceDe es la inversa.
+    PCB* ranura(uint32_t indice);
+    static uint32_t indiceDe(const PCB* proceso);
+
+    size_t vivos() const { return registros.size() - libres.size(); }
+    size_t ranuras() const { return registros.size(); }
+
+    // Recorridos sobre los arreglos calientes, restringidos a los procesos en `filtro`.
+    // A partir de UMBRAL_VECTORIAL ranuras usan los kernels de vectorial.h.
+    int minRestante(EstadoProceso filtro) const;
+    void avanzar(EstadoProceso filtro, int ticks);
+
+    static constexpr size_t UMBRAL_VECTORIAL = 64;
+
+    // Todas las ranuras (vivas y libres) con sus generaciones y la lista libre.
+    // Los enlaces de cola no se guardan: los reconstruye cada politica.
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector);
+
+    // Campos calientes, indexados por Pid::indice
+    vector<int> restante;
+    vector<EstadoProceso> estado;
+    vector<int> prioridad;
+
+    MemoriaVirtual memoria;
+
+private:
+    vector<uint32_t> generacion;
+    deque<PCB> registros;
+    vector<uint32_t> libres;
+};
@@ -0,0 +1,177 @@
+#include "tiempo_real.h"
+#include "traza.h"
+#include "../snapshot/instantanea.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+optional<ModoTiempoReal> modoTiempoRealDesdeNombre(const string& nombre) {
+    if (nombre == "edf") return ModoTiempoReal::EDF;
+    if (nombre == "rm") return ModoTiempoReal::RM;
+    return nullopt;
+}
+
+string nombreModoTiempoReal(ModoTiempoReal modo) {
+    return modo == ModoTiempoReal::EDF ? "edf" : "rm";
+}
+
+static double densidad(int wcet, int plazo) {
+    return (double) wcet / plazo;
+}
+
+double TiempoReal::cotaPara(ModoTiempoReal modo, size_t n) {
+    if (modo == ModoTiempoReal::EDF || n == 0)
+        return 1.0;
+    return n * (pow(2.0, 1.0 / n) - 1.0);
+}
+
+double TiempoReal::utilizacion() const {
+    double total = 0;
+    for (const Tarea& tarea : tareas)
+        total += densidad(tarea.wcet, tarea.plazo);
+    return total;
+}
+
+long long TiempoReal::clave(const Tarea& tarea) const {
+    return modoActual == ModoTiempoReal::EDF ? tarea.plazoAbsoluto : tarea.periodo;
+}
+
+optional<Pid> TiempoReal::admitir(const PCB& programa, long long reloj) {
+    int periodo = programa.periodo;
+    int wcet = programa.tiempoEjecucion;
+    int plazo = programa.plazo > 0 ? min(programa.plazo, periodo) : periodo;
+    if (periodo <= 0 || wcet <= 0 || wcet > plazo)
+        return nullopt;
+    if (utilizacion() + densidad(wcet, plazo) > cotaPara(modoActual, tareas.size() + 1) + 1e-9)
+        return nullopt;
+
+    Tarea tarea{programa, periodo, wcet, plazo};
+    tarea.proceso.pid = Pid{BASE_PID_TIEMPO_REAL + (uint32_t) tareas.size(), 0};
+    tarea.proceso.tabla = nullptr;
+    tarea.proceso.tiempoEjecucion = 0;
+    tarea.proximaLiberacion = reloj;
+    tareas.push_back(tarea);
+    siguienteEvento = min(siguienteEvento, reloj);
+    return tarea.proceso.pid;
+}
+
+bool TiempoReal::fijarModo(ModoTiempoReal nuevo) {
+    if (utilizacion() > cotaPara(nuevo, tareas.size()) + 1e-9)
+        return false;
+    modoActual = nuevo;
+    for (uint32_t i = 0; i < tareas.size(); ++i)
+        if (listos.contiene(i))
+            listos.cambiarClave(i, clave(tareas[i]));
+    return true;
+}
+
+void TiempoReal::actualizar(long long reloj) {
+    if (reloj < siguienteEvento)
+        return;
+
+    siguienteEvento = LLONG_MAX;
+    for (uint32_t i = 0; i < tareas.size(); ++i) {
+        Tarea& tarea = tareas[i];
+        // Un trabajo pendiente cuyo plazo ya paso se pierde
+        auto vencer = [&] {
+            ++tarea.perdidos;
+            listos.borrar(i);
+            traza::emitir(tarea.plazoAbsoluto, &tarea.proceso, traza::Evento::Vence, tarea.proceso.tiempoEjecucion);
+        };
+        if (listos.contiene(i) && tarea.plazoAbsoluto <= reloj)
+            vencer();
+        while (tarea.proximaLiberacion <= reloj) {
+            // Con D <= T el plazo del trabajo anterior no pasa de esta liberacion
+            if (listos.contiene(i))
+                vencer();
+            tarea.liberacion = tarea.proximaLiberacion;
+            tarea.plazoAbsoluto = tarea.liberacion + tarea.plazo;
+            tarea.proximaLiberacion += tarea.periodo;
+            tarea.proceso.tiempoEjecucion = tarea.wcet;
+            ++tarea.liberados;
+            listos.insertar(i, clave(tarea));
+            traza::emitir(tarea.liberacion, &tarea.proceso, traza::Evento::Llegada, tarea.wcet);
+        }
+        if (listos.contiene(i) && tarea.plazoAbsoluto <= reloj)
+            vencer();
+        siguienteEvento = min(siguienteEvento, tarea.proximaLiberacion);
+        if (listos.contiene(i))
+            siguienteEvento = min(siguienteEvento, tarea.plazoAbsoluto);
+    }
+}
+
+long long TiempoReal::proximoEvento(long long reloj) const {
+    return siguienteEvento == LLONG_MAX ? LLONG_MAX : max(1LL, siguienteEvento - reloj);
+}
+
+int TiempoReal::ejecutar(long long reloj, long long ticks) {
+    uint32_t i = listos.tope();
+    Tarea& tarea = tareas[i];
+    int corrido = (int) min<long long>(tarea.proceso.tiempoEjecucion, ticks);
+    tarea.proceso.tiempoEjecucion -= corrido;
+    if (tarea.proceso.tiempoEjecucion == 0) {
+        ++tarea.completados;
+        tarea.peorRespuesta = max(tarea.peorRespuesta, reloj + corrido - tarea.liberacion);
+        listos.borrar(i);
+    }
+    return corrido;
+}
+
+void TiempoReal::listar() const {
+    cout << "=== Tiempo real (" << nombreModoTiempoReal(modoActual) << ") | utilizacion: "
+         << fixed << setprecision(3) << utilizacion() << " | cota: " << cota() << " ===" << endl;
+    for (const Tarea& tarea : tareas) {
+        cout << "Tarea: " << tarea.proceso.name << " (pid " << tarea.proceso.pid << ")"
+             << " | T=" << tarea.periodo << " C=" << tarea.wcet << " D=" << tarea.plazo
+             << " | liberados: " << tarea.liberados << " completados: " << tarea.completados
+             << " plazos perdidos: " << tarea.perdidos << " peor respuesta: " << tarea.peorRespuesta
+             << endl;
+    }
+}
+
+namespace {
+    // Tarea sin su PCB, que se guarda aparte
+    struct TareaGuardada {
+        int32_t periodo;
+        int32_t wcet;
+        int32_t plazo;
+        uint32_t lista; // trabajo liberado y sin terminar
+        int64_t proximaLiberacion;
+        int64_t liberacion;
+        int64_t plazoAbsoluto;
+        uint64_t liberados;
+        uint64_t completados;
+        uint64_t perdidos;
+        int64_t peorRespuesta;
+    };
+}
+
+void TiempoReal::guardar(instantanea::Escritor& escritor) const {
+    escritor.valor(modoActual);
+    escritor.valor(siguienteEvento);
+    escritor.valor<uint64_t>(tareas.size());
+    for (uint32_t i = 0; i < tareas.size(); ++i) {
+        const Tarea& t = tareas[i];
+        escritor.valor(TareaGuardada{t.periodo, t.wcet, t.plazo, listos.contiene(i), t.proximaLiberacion, t.liberacion,
+                                     t.plazoAbsoluto, t.liberados, t.completados, t.perdidos, t.peorRespuesta});
+        t.proceso.guardar(escritor);
+    }
+}
+
+void TiempoReal::cargar(instantanea::Lector& lector) {
+    modoActual = lector.valor<ModoTiempoReal>();
+    siguienteEvento = lector.valor<long long>();
+    tareas.clear();
+    listos = MonticuloDario<4>();
+    uint64_t cantidad = lector.valor<uint64_t>();
+    for (uint64_t i = 0; i < cantidad; ++i) {
+        TareaGuardada g = lector.valor<TareaGuardada>();
+        Tarea tarea{PCB::cargar(lector), g.periodo, g.wcet, g.plazo, g.proximaLiberacion, g.liberacion,
+                    g.plazoAbsoluto, g.liberados, g.completados, g.perdidos, g.peorRespuesta};
+        tareas.push_back(tarea);
+        // Los empates del monticulo se resuelven por id: el orden de insercion no importa
+        if (g.lista)
+            listos.insertar((uint32_t) i, clave(tareas.back()));
+    }
+}
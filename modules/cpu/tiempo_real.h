@@ -0,0 +1,83 @@
+#pragma once
+#include "pcb.h"
+#include "monticulo.h"
+#include <climits>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Orden entre los trabajos de tiempo real listos
+enum class ModoTiempoReal {
+    EDF, // plazo absoluto mas cercano primero (dinamico)
+    RM   // rate monotonic: periodo mas corto primero (prioridad fija)
+};
+
+optional<ModoTiempoReal> modoTiempoRealDesdeNombre(const string& nombre);
+string nombreModoTiempoReal(ModoTiempoReal modo);
+
+// Clase de tiempo real: tareas periodicas (periodo T, peor tiempo de ejecucion C,
+// plazo relativo D <= T). Cada periodo libera un trabajo de C ticks que debe
+// terminar antes de su plazo; un trabajo que vence se cuenta como perdido y se
+// descarta (plazos firmes). Tiene prioridad absoluta sobre la clase normal.
+class TiempoReal {
+public:
+    struct Tarea {
+        PCB proceso; // tiempoEjecucion es lo que le falta al trabajo en curso
+        int periodo;
+        int wcet;
+        int plazo;
+
+        long long proximaLiberacion = 0;
+        long long liberacion = 0;     // del trabajo en curso
+        long long plazoAbsoluto = 0;
+
+        uint64_t liberados = 0;
+        uint64_t completados = 0;
+        uint64_t perdidos = 0;
+        long long peorRespuesta = 0;
+    };
+
+    // Test de admision por cota de utilizacion (densidad C/D):
+    //   EDF: suma <= 1
+    //   RM:  suma <= n(2^(1/n) - 1)  (Liu y Layland, suficiente)
+    // Si pasa, el primer trabajo se libera en `reloj`. Devuelve el pid de la tarea.
+    optional<Pid> admitir(const PCB& programa, long long reloj);
+
+    // false (sin cambios) si las tareas ya admitidas no pasan la cota del modo nuevo:
+    // un conjunto admitido con EDF puede no ser planificable con RM
+    bool fijarModo(ModoTiempoReal nuevo);
+    ModoTiempoReal modo() const { return modoActual; }
+    double utilizacion() const;
+    double cota() const { return cotaPara(modoActual, tareas.size()); }
+
+    bool vacia() const { return tareas.empty(); }
+    bool hayListo() const { return !listos.vacio(); }
+
+    // Libera trabajos y registra vencimientos hasta `reloj` inclusive
+    void actualizar(long long reloj);
+    // Ticks desde `reloj` hasta la proxima liberacion o vencimiento (LLONG_MAX si no hay tareas)
+    long long proximoEvento(long long reloj) const;
+
+    // Trabajo mas urgente; solo si hayListo()
+    PCB& proximo() { return tareas[listos.tope()].proceso; }
+    // Corre el trabajo mas urgente hasta `ticks` o hasta que termine; devuelve lo ejecutado
+    int ejecutar(long long reloj, long long ticks);
+
+    const vector<Tarea>& lista() const { return tareas; }
+    void listar() const;
+
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector);
+
+private:
+    static double cotaPara(ModoTiempoReal modo, size_t n);
+    long long clave(const Tarea& tarea) const;
+
+    ModoTiempoReal modoActual = ModoTiempoReal::EDF;
+    vector<Tarea> tareas;
+    MonticuloDario<4> listos; // trabajos liberados y sin terminar, por indice de tarea
+    long long siguienteEvento = LLONG_MAX; // cota inferior del proximo evento absoluto
+};
@@ -0,0 +1,194 @@
+#include "traza.h"
+#include "../sync/ring_buffer.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace traza {
+
+namespace {
+    const char MAGIA[4] = {'K', 'S', 'T', 'R'};
+    constexpr uint16_t VERSION = 2; // 2: registros con la generacion del pid
+    constexpr size_t LOTE = 256;
+
+    atomic<bool> grabando{false};
+    atomic<Consola> nivelConsola{Consola::Terminaciones};
+    RingBuffer<Registro> anillo(1 << 16);
+    atomic<uint64_t> totalRegistrados{0};
+
+    mutex mutexSpool; // protege spool y serializa al consumidor del anillo
+    FILE* spool = nullptr;
+    thread drenador;
+    atomic<bool> drenando{false};
+
+    mutex mutexConsola;
+
+    // Requiere mutexSpool. Sin spool los registros se descartan.
+    size_t drenarAnillo() {
+        Registro lote[LOTE];
+        size_t total = 0;
+        size_t n;
+        do {
+            n = 0;
+            while (n < LOTE && anillo.try_pop(lote[n])) ++n;
+            if (n && spool)
+                fwrite(lote, sizeof(Registro), n, spool);
+            total += n;
+        } while (n == LOTE);
+        if (spool)
+            totalRegistrados += total;
+        return total;
+    }
+
+    void bucleDrenaje() {
+        while (drenando) {
+            size_t n;
+            {
+                lock_guard<mutex> lock(mutexSpool);
+                n = drenarAnillo();
+            }
+            if (n == 0)
+                this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        lock_guard<mutex> lock(mutexSpool);
+        drenarAnillo();
+    }
+
+    void imprimir(const PCB& proceso, Evento evento, long long cantidad, int nucleo) {
+        lock_guard<mutex> lock(mutexConsola);
+        if (nucleo >= 0)
+            cout << "[nucleo " << nucleo << "] ";
+        switch (evento) {
+            case Evento::Llegada:
+                cout << "Proceso " << proceso.name << " llega a la cola." << endl;
+                break;
+            case Evento::Ejecuta:
+                cout << "Proceso " << proceso.name << " ejecuta " << cantidad
+                     << " unidades. Restante: " << proceso.restante() << endl;
+                break;
+            case Evento::Termina:
+                cout << "Proceso " << proceso.name << " terminado." << endl;
+                break;
+            case Evento::Robo:
+                cout << "Proceso " << proceso.name << " robado por este nucleo." << endl;
+                break;
+            case Evento::Bloquea:
+                cout << "Proceso " << proceso.name << " se bloquea por E/S (" << cantidad << " unidades)." << endl;
+                break;
+            case Evento::Despierta:
+                cout << "Proceso " << proceso.name << " despierta y vuelve a la cola." << endl;
+                break;
+            case Evento::Duerme:
+                cout << "Proceso " << proceso.name << " duerme " << cantidad << " unidades." << endl;
+                break;
+            case Evento::Vence:
+                cout << "Tarea " << proceso.name << " pierde su plazo (faltaban " << cantidad << " unidades)." << endl;
+                break;
+            case Evento::Salto:
+                break;
+        }
+    }
+
+    // Detiene el hilo de drenaje antes de la destruccion de los estaticos
+    struct Cierre {
+        ~Cierre() {
+            detener();
+            if (spool) fclose(spool);
+        }
+    } cierre;
+}
+
+void iniciar() {
+    if (grabando)
+        return;
+    {
+        lock_guard<mutex> lock(mutexSpool);
+        if (spool) fclose(spool);
+        spool = nullptr;
+        drenarAnillo(); // descartar restos de una grabacion anterior
+        spool = tmpfile();
+        totalRegistrados = 0;
+    }
+    drenando = true;
+    grabando = true;
+    drenador = thread(bucleDrenaje);
+}
+
+void detener() {
+    if (!grabando)
+        return;
+    grabando = false;
+    drenando = false;
+    if (drenador.joinable())
+        drenador.join();
+}
+
+bool volcar(const string& archivo) {
+    lock_guard<mutex> lock(mutexSpool);
+    if (!spool)
+        return false;
+    drenarAnillo();
+    fflush(spool);
+
+    FILE* destino = fopen(archivo.c_str(), "wb");
+    if (!destino)
+        return false;
+
+    uint16_t version = VERSION;
+    uint16_t tamRegistro = sizeof(Registro);
+    fwrite(MAGIA, 1, sizeof(MAGIA), destino);
+    fwrite(&version, sizeof(version), 1, destino);
+    fwrite(&tamRegistro, sizeof(tamRegistro), 1, destino);
+
+    rewind(spool);
+    char bloque[1 << 16];
+    size_t leidos;
+    while ((leidos = fread(bloque, 1, sizeof(bloque), spool)) > 0)
+        fwrite(bloque, 1, leidos, destino);
+    fseek(spool, 0, SEEK_END);
+
+    return fclose(destino) == 0;
+}
+
+bool activa() {
+    return grabando.load(memory_order_relaxed);
+}
+
+void fijarConsola(Consola nivel) {
+    nivelConsola = nivel;
+}
+
+Consola consola() {
+    return nivelConsola.load(memory_order_relaxed);
+}
+
+void emitir(uint64_t tick, const PCB* proceso, Evento evento, long long cantidad, int nucleo) {
+    if (grabando.load(memory_order_relaxed)) {
+        Registro registro{};
+        registro.tick = tick;
+        registro.pid = proceso ? proceso->pid.indice : 0;
+        registro.generacion = proceso ? proceso->pid.generacion : 0;
+        registro.cantidad = (int32_t) min<long long>(cantidad, numeric_limits<int32_t>::max());
+        registro.evento = (uint8_t) evento;
+        registro.nucleo = nucleo >= 0 ? (uint8_t) nucleo : SIN_NUCLEO;
+        anillo.try_push(registro);
+    }
+
+    Consola nivel = nivelConsola.load(memory_order_relaxed);
+    if (proceso && (nivel == Consola::Todo || (nivel == Consola::Terminaciones && (evento == Evento::Termina || evento == Evento::Vence))))
+        imprimir(*proceso, evento, cantidad, nucleo);
+}
+
+uint64_t registrados() {
+    return totalRegistrados.load();
+}
+
+uint64_t perdidos() {
+    return anillo.dropped();
+}
+
+} // namespace traza
@@ -0,0 +1,47 @@
+#pragma once
+#include "pcb.h"
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// Traza de eventos del planificador.
+// Los eventos van a dos sumideros opcionales:
+//  - un anillo binario sin bloqueos que un hilo de drenaje vuelca a un archivo compacto
+//    (trace on|off|dump), sin costo de consola en el ciclo caliente;
+//  - la consola, con nivel configurable (por defecto solo terminaciones).
+namespace traza {
+
+enum class Evento : uint8_t { Llegada, Ejecuta, Termina, Salto, Robo, Bloquea, Despierta, Vence, Duerme };
+
+enum class Consola { Nada, Terminaciones, Todo };
+
+// Registro binario de tamaño fijo; el archivo es una cabecera seguida de registros
+struct Registro {
+    uint64_t tick;
+    uint32_t pid;        // indice de la ranura en la tabla de procesos
+    uint32_t generacion; // con el indice identifica al proceso aunque la ranura se reuse
+    int32_t cantidad;
+    uint8_t evento;
+    uint8_t nucleo; // SIN_NUCLEO en modo de un solo nucleo
+    uint16_t reservado;
+};
+
+constexpr uint8_t SIN_NUCLEO = 0xFF;
+
+void iniciar();
+void detener();
+bool volcar(const string& archivo);
+bool activa();
+
+void fijarConsola(Consola nivel);
+Consola consola();
+
+// Llamado desde los ciclos de planificacion (posiblemente desde varios hilos).
+// proceso puede ser nulo para eventos del sistema (Salto).
+void emitir(uint64_t tick, const PCB* proceso, Evento evento, long long cantidad, int nucleo = -1);
+
+uint64_t registrados();
+uint64_t perdidos();
+
+} // namespace traza
@@ -0,0 +1,110 @@
+#include "vectorial.h"
+#include <algorithm>
+#include <climits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KERNEL_SIM_X86 1
+#endif
+
+namespace vectorial {
+
+namespace {
+
+int minEscalar(const int* restante, const EstadoProceso* estado, size_t n, EstadoProceso filtro) {
+    int minimo = INT_MAX;
+    for (size_t i = 0; i < n; ++i)
+        if (estado[i] == filtro && restante[i] < minimo)
+            minimo = restante[i];
+    return minimo;
+}
+
+void avanzarEscalar(int* restante, const EstadoProceso* estado, size_t n, EstadoProceso filtro, int ticks) {
+    for (size_t i = 0; i < n; ++i)
+        if (estado[i] == filtro)
+            restante[i] -= ticks;
+}
+
+#ifdef KERNEL_SIM_X86
+
+// Mascara de 8 carriles de 32 bits: estado[i..i+7] == filtro
+__attribute__((target("avx2")))
+inline __m256i mascaraEstado(const EstadoProceso* estado, __m256i filtro) {
+    __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(estado));
+    return _mm256_cmpeq_epi32(_mm256_cvtepu8_epi32(bytes), filtro);
+}
+
+__attribute__((target("avx2")))
+int minAVX2(const int* restante, const EstadoProceso* estado, size_t n, EstadoProceso filtro) {
+    const __m256i vfiltro = _mm256_set1_epi32((int) filtro);
+    const __m256i vmax = _mm256_set1_epi32(INT_MAX);
+    __m256i acumulado = vmax;
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i mascara = mascaraEstado(estado + i, vfiltro);
+        __m256i valores = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(restante + i));
+        acumulado = _mm256_min_epi32(acumulado, _mm256_blendv_epi8(vmax, valores, mascara));
+    }
+
+    alignas(32) int carriles[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(carriles), acumulado);
+    int minimo = *std::min_element(carriles, carriles + 8);
+    return std::min(minimo, minEscalar(restante + i, estado + i, n - i, filtro));
+}
+
+__attribute__((target("avx2")))
+void avanzarAVX2(int* restante, const EstadoProceso* estado, size_t n, EstadoProceso filtro, int ticks) {
+    const __m256i vfiltro = _mm256_set1_epi32((int) filtro);
+    const __m256i vticks = _mm256_set1_epi32(ticks);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i mascara = mascaraEstado(estado + i, vfiltro);
+        __m256i* destino = reinterpret_cast<__m256i*>(restante + i);
+        __m256i valores = _mm256_loadu_si256(destino);
+        _mm256_storeu_si256(destino, _mm256_sub_epi32(valores, _mm256_and_si256(vticks, mascara)));
+    }
+    avanzarEscalar(restante + i, estado + i, n - i, filtro, ticks);
+}
+
+#endif
+
+struct Despacho {
+    int (*min)(const int*, const EstadoProceso*, size_t, EstadoProceso);
+    void (*avanzar)(int*, const EstadoProceso*, size_t, EstadoProceso, int);
+    const char* nombre;
+};
+
+const Despacho ESCALAR{minEscalar, avanzarEscalar, "escalar"};
+
+Despacho elegir() {
+#ifdef KERNEL_SIM_X86
+    if (__builtin_cpu_supports("avx2"))
+        return Despacho{minAVX2, avanzarAVX2, "avx2"};
+#endif
+    return ESCALAR;
+}
+
+const Despacho NATIVO = elegir();
+const Despacho* despacho = &NATIVO;
+
+} // namespace
+
+int minRestante(const int* restante, const EstadoProceso* estado, size_t n, EstadoProceso filtro) {
+    return despacho->min(restante, estado, n, filtro);
+}
+
+void avanzar(int* restante, const EstadoProceso* estado, size_t n, EstadoProceso filtro, int ticks) {
+    despacho->avanzar(restante, estado, n, filtro, ticks);
+}
+
+const char* implementacion() {
+    return despacho->nombre;
+}
+
+void forzarEscalar(bool escalar) {
+    despacho = escalar ? &ESCALAR : &NATIVO;
+}
+
+} // namespace vectorial
@@ -0,0 +1,26 @@
+#pragma once
+#include "pcb.h"
+#include <cstddef>
+
+// Kernels en bloque sobre los arreglos calientes de la tabla de procesos.
+// Cada kernel opera solo sobre las ranuras cuyo estado es `filtro`.
+// La implementacion (AVX2 o escalar) se elige una vez al arrancar segun la CPU real.
+//
+// No hay kernel para contar terminados: el salto de rondas de round robin se detiene
+// una ronda antes de la primera terminacion, asi que un tramo saltado nunca contiene
+// una, y las terminaciones se registran una por una en el ciclo de despacho.
+namespace vectorial {
+
+// Minimo tiempo restante (INT_MAX si no hay ranuras en `filtro`)
+int minRestante(const int* restante, const EstadoProceso* estado, size_t n, EstadoProceso filtro);
+
+// Resta `ticks` al tiempo restante de todas las ranuras en `filtro`
+void avanzar(int* restante, const EstadoProceso* estado, size_t n, EstadoProceso filtro, int ticks);
+
+// Nombre de la implementacion activa ("avx2" o "escalar")
+const char* implementacion();
+
+// Para comparar en benchmarks: fuerza la version escalar aunque haya AVX2
+void forzarEscalar(bool escalar);
+
+} // namespace vectorial
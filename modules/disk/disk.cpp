@@ -4,6 +4,8 @@
 #include <sstream>
 #include <variant>
 #include "../cpu/cpu.h"
+#include "../snapshot/instantanea.h"
+#include "../mem/slab.h"
 // GENERAL
 
 
@@ -57,6 +59,85 @@ Information::Information(const string& name, T content) {
     this->content = content;
 }
 
+namespace {
+    enum class TipoNodo : uint8_t { Informacion, Archivo, Directorio };
+}
+
+void Information::guardar(instantanea::Escritor& escritor) const {
+    const File* file = dynamic_cast<const File*>(this);
+    TipoNodo tipo = file ? TipoNodo::Archivo
+                  : dynamic_cast<const Directory*>(this) ? TipoNodo::Directorio : TipoNodo::Informacion;
+    escritor.valor(tipo);
+    escritor.texto(name);
+    if (file)
+        escritor.texto(file->extension);
+
+    escritor.valor<uint8_t>((uint8_t) content.index());
+    if (auto texto = get_if<string>(&content)) {
+        escritor.texto(*texto);
+    } else if (auto programa = get_if<PCB*>(&content)) {
+        escritor.valor<uint8_t>(*programa != nullptr);
+        if (*programa)
+            (*programa)->guardar(escritor);
+    } else {
+        const auto& hijos = get<vector<Information*>>(content);
+        escritor.valor<uint64_t>(hijos.size());
+        for (const Information* hijo : hijos)
+            hijo->guardar(escritor);
+    }
+}
+
+Information* Information::cargar(instantanea::Lector& lector) {
+    TipoNodo tipo = lector.valor<TipoNodo>();
+    string nombre = lector.texto();
+    Information* info;
+    switch (tipo) {
+        case TipoNodo::Archivo: info = new File(nombre, lector.texto()); break;
+        case TipoNodo::Directorio: info = new Directory(nombre); break;
+        case TipoNodo::Informacion: info = new Information(nombre); break;
+        default: throw runtime_error("nodo de disco desconocido");
+    }
+
+    // Los hijos se cuelgan del nodo a medida que se leen: si algo falla, destruir
+    // libera todo lo armado hasta ahi
+    try {
+        switch (lector.valor<uint8_t>()) {
+            case 0:
+                info->content = lector.texto();
+                break;
+            case 1:
+                info->content = lector.valor<uint8_t>() ? new PCB(PCB::cargar(lector)) : (PCB*) nullptr;
+                break;
+            case 2: {
+                // Cada hijo ocupa al menos la cantidad de su nombre: una cuenta mayor es basura
+                uint64_t cantidad = lector.valor<uint64_t>();
+                if (cantidad > lector.restantes() / sizeof(uint64_t))
+                    throw runtime_error("instantanea truncada");
+                auto& hijos = info->content.emplace<vector<Information*>>();
+                hijos.reserve(cantidad);
+                for (uint64_t i = 0; i < cantidad; ++i)
+                    hijos.push_back(cargar(lector));
+                break;
+            }
+            default:
+                throw runtime_error("contenido de disco desconocido");
+        }
+    } catch (...) {
+        destruir(info);
+        throw;
+    }
+    return info;
+}
+
+void Information::destruir(Information* nodo) {
+    if (auto hijos = get_if<vector<Information*>>(&nodo->content))
+        for (Information* hijo : *hijos)
+            destruir(hijo);
+    else if (auto programa = get_if<PCB*>(&nodo->content))
+        delete *programa;
+    delete nodo;
+}
+
 // File
 
 int File::get_size() {
@@ -86,6 +167,14 @@ File::File(const string &name, const string &extension): Information(name) {
     this->extension = extension;
 }
 
+void* File::operator new(size_t tamano) {
+    return slab::asignar<File>("file", tamano);
+}
+
+void File::operator delete(void* p) {
+    slab::liberar<File>("file", p);
+}
+
 template<typename T> //template
 File::File(const string &name, const string &extension, T content): Information(name, content) {
     this->extension = extension;
@@ -96,6 +185,14 @@ File::File(const string &name, const string &extension, T content): Information(
 
 Directory::Directory(const string &name):Information(name) {}
 
+void* Directory::operator new(size_t tamano) {
+    return slab::asignar<Directory>("directory", tamano);
+}
+
+void Directory::operator delete(void* p) {
+    slab::liberar<Directory>("directory", p);
+}
+
 void Directory::push_content(Information* info) {
     if (std::holds_alternative<std::vector<Information*>>(get_content())) {
         auto content = std::get<std::vector<Information*>>(get_content());
@@ -118,7 +215,7 @@ int Directory::get_size() {
     return 0;
 }
 
-string Directory::command(string command, optional<CPU> s) {
+string Directory::command(string command, CPU* s) {
     stringstream ss(command);
     string n;
     ss >> n;
@@ -130,7 +227,12 @@ string Directory::command(string command, optional<CPU> s) {
         return ls_();
     } else if (n == "run") {
         ss >> n; // Extrae el siguiente argumento
-        return run_(n, s.value());
+        if (!s)
+            return "No hay una CPU disponible para ejecutar";
+        int tickets = 0; // opcional: boletos para loteria y stride
+        if (ss >> tickets && tickets < 1)
+            return "La cantidad de boletos debe ser positiva";
+        return run_(n, *s, tickets);
     } else if (n == "kill") {
         ss >> n;
         return kill_(n);;
@@ -188,7 +290,7 @@ string Directory::ls_() {
     }
 }
 
-string Directory::run_(const string& n, CPU& s) {
+string Directory::run_(const string& n, CPU& s, int tickets) {
     try {
         if (n.empty())
             return "No se a proveeido un nombre de un programa";
@@ -196,8 +298,26 @@ string Directory::run_(const string& n, CPU& s) {
             File* file = dynamic_cast<File*>(info);
 
             if (file != nullptr && file->get_name()+".exe"==n) {
-                s.add_process(get<PCB*>(file->get_content()));
-                return "proceso añadido a la cola para correr";
+                // Cada ejecucion crea un proceso nuevo; el programa sigue en el archivo
+                PCB* programa = get<PCB*>(file->get_content());
+                stringstream ss;
+                if (programa->periodo > 0) {
+                    if (auto pid = s.agregarTareaPeriodica(*programa))
+                        ss << "tarea periodica admitida en la clase de tiempo real (pid " << *pid << ")";
+                    else
+                        ss << "tarea periodica rechazada: no pasa el test de admision de tiempo real"
+                              " (o la CPU tiene varios nucleos)";
+                    return ss.str();
+                }
+                if (tickets > 0) {
+                    PCB conBoletos = *programa;
+                    conBoletos.tickets = tickets;
+                    ss << "proceso añadido a la cola para correr con " << tickets << " boletos (pid "
+                       << s.add_process(conBoletos) << ")";
+                    return ss.str();
+                }
+                ss << "proceso añadido a la cola para correr (pid " << s.add_process(*programa) << ")";
+                return ss.str();
             }
         }
         return "el proceso dado no existe en el directorio";
@@ -293,3 +413,51 @@ string Disk::go_to_path(const string& path) {
 
 
 
+
+void Disk::guardar(instantanea::Escritor& escritor) const {
+    escritor.texto(name);
+    root->guardar(escritor);
+    // Ruta actual como lista de subdirectorios desde la raiz
+    escritor.valor<uint64_t>(path_stack.size());
+    for (size_t i = 1; i <= path_stack.size(); ++i) {
+        Directory* dir = i < path_stack.size() ? path_stack[i] : cur_dir;
+        escritor.texto(dir->get_name());
+    }
+}
+
+Disk::~Disk() {
+    if (root)
+        Information::destruir(root);
+}
+
+Disk::Disk(Disk&& otro) noexcept
+    : name(move(otro.name)), cur_path(move(otro.cur_path)), root(otro.root), cur_dir(otro.cur_dir),
+      path_stack(move(otro.path_stack)) {
+    otro.root = otro.cur_dir = nullptr;
+}
+
+// Intercambia: el arbol anterior se destruye con `otro`
+Disk& Disk::operator=(Disk&& otro) noexcept {
+    swap(name, otro.name);
+    swap(cur_path, otro.cur_path);
+    swap(root, otro.root);
+    swap(cur_dir, otro.cur_dir);
+    swap(path_stack, otro.path_stack);
+    return *this;
+}
+
+void Disk::cargar(instantanea::Lector& lector) {
+    Disk cargado(lector.texto());
+    Information* nodo = Information::cargar(lector);
+    Directory* raiz = dynamic_cast<Directory*>(nodo);
+    if (!raiz) {
+        Information::destruir(nodo);
+        throw runtime_error("la raiz del disco no es un directorio");
+    }
+    Information::destruir(cargado.root);
+    cargado.root = cargado.cur_dir = raiz;
+    uint64_t profundidad = lector.valor<uint64_t>();
+    for (uint64_t i = 0; i < profundidad; ++i)
+        cargado.go_to_path(lector.texto());
+    *this = move(cargado);
+}
@@ -25,12 +25,19 @@ public:
 
     template<typename T>
     Information(const string&, T content); // Constructor genérico
+
+    // Subarbol en preorden para las instantaneas
+    void guardar(instantanea::Escritor& escritor) const;
+    static Information* cargar(instantanea::Lector& lector);
+    // Libera el nodo con todo su subarbol y los programas de sus archivos
+    static void destruir(Information* nodo);
 protected:
     string name;
     variant<string, PCB*, vector<Information*>> content; // Ahora soporta los 3 tipos
 };
 
 class File : public Information {
+    friend class Information;
 public:
     int get_size() override;
     string get_extension();
@@ -38,6 +45,10 @@ public:
     void edit_content(PCB* program);
 
     File(const string &name, const string &extension);
+
+    // Nodos del arbol desde los caches de slabs "file" y "directory"
+    static void* operator new(size_t tamano);
+    static void operator delete(void* p);
     template<typename T>
     File(const string &name, const string &extension, T content);
 private:
@@ -47,14 +58,17 @@ private:
 class Directory : public Information {
 public:
     int get_size() override;
-    string command(string command, optional<CPU> s);
+    string command(string command, CPU* s);
     void push_content(Information* info);
 
     explicit Directory(const string &name);
+
+    static void* operator new(size_t tamano);
+    static void operator delete(void* p);
 private:
     string new_(string n);
     string ls_();
-    string run_(const string& n, CPU& s);
+    string run_(const string& n, CPU& s, int tickets = 0);
     string kill_(const string& n);
 };
 
@@ -66,6 +80,16 @@ public:
     string go_to_path(const string& path);
 
     explicit Disk(const string &name);
+    // El disco es dueño del arbol
+    ~Disk();
+    Disk(const Disk&) = delete;
+    Disk& operator=(const Disk&) = delete;
+    Disk(Disk&& otro) noexcept;
+    Disk& operator=(Disk&& otro) noexcept;
+
+    // Arbol completo y ruta actual
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector);
 private:
     string name;
 
@@ -0,0 +1,24 @@
+#include "dispositivo.h"
+#include "../snapshot/instantanea.h"
+#include <climits>
+
+void DispositivoES::solicitar(PCB* proceso) {
+    proceso->fijarEstado(EstadoProceso::Bloqueado);
+    cola.push_back(proceso);
+}
+
+long long DispositivoES::proximaFinalizacion() const {
+    return cola.empty() ? LLONG_MAX : cola.front()->restante();
+}
+
+void DispositivoES::guardar(instantanea::Escritor& escritor) const {
+    vector<uint32_t> indices;
+    indices.reserve(cola.size());
+    for (PCB* proceso : cola) indices.push_back(TablaProcesos::indiceDe(proceso));
+    escritor.arreglo(indices);
+}
+
+void DispositivoES::cargar(instantanea::Lector& lector, TablaProcesos& tabla) {
+    cola.clear();
+    for (uint32_t indice : lector.vista<uint32_t>()) cola.push_back(tabla.ranura(indice));
+}
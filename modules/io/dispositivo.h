@@ -0,0 +1,53 @@
+#pragma once
+#include "../cpu/pcb.h"
+#include "../cpu/tabla_procesos.h"
+#include <algorithm>
+#include <deque>
+
+using namespace std;
+
+// Dispositivo de E/S simulado: atiende una solicitud a la vez, en orden de llegada.
+// Los procesos bloqueados esperan en su cola; la E/S pendiente de cada uno es su
+// tiempo restante (su rafaga actual es de E/S).
+class DispositivoES {
+public:
+    // El proceso queda Bloqueado hasta que termine su rafaga de E/S
+    void solicitar(PCB* proceso);
+
+    // Ticks hasta la proxima finalizacion (LLONG_MAX si esta ocioso)
+    long long proximaFinalizacion() const;
+
+    // Avanza `ticks` de tiempo simulado y llama alCompletar(proceso) por cada solicitud
+    // que termina, en orden. Devuelve los ticks en que el dispositivo estuvo ocupado.
+    template <typename F>
+    long long transcurrir(long long ticks, F alCompletar) {
+        long long ocupado = 0;
+        while (ticks > 0 && !cola.empty()) {
+            PCB* proceso = cola.front();
+            int& pendiente = proceso->restante();
+            int avance = (int) min<long long>(ticks, pendiente);
+            pendiente -= avance;
+            ticks -= avance;
+            ocupado += avance;
+            if (pendiente <= 0) {
+                cola.pop_front();
+                alCompletar(proceso);
+            }
+        }
+        return ocupado;
+    }
+
+    bool ocioso() const { return cola.empty(); }
+    size_t enEspera() const { return cola.size(); }
+
+    template <typename F>
+    void recorrer(F f) const {
+        for (PCB* proceso : cola) f(proceso);
+    }
+
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector, TablaProcesos& tabla);
+
+private:
+    deque<PCB*> cola;
+};
@@ -0,0 +1,180 @@
+#include "buddy.h"
+#include <algorithm>
+#include <bit>
+#include <iomanip>
+
+// MapaNiveles
+
+Buddy::MapaNiveles::MapaNiveles(uint64_t bits) {
+    do {
+        bits = std::max<uint64_t>(1, (bits + 63) / 64);
+        niveles.emplace_back(bits, 0);
+    } while (bits > 1);
+}
+
+void Buddy::MapaNiveles::poner(uint64_t i) {
+    for (auto& nivel : niveles) {
+        uint64_t& palabra = nivel[i / 64];
+        bool estabaVacia = palabra == 0;
+        palabra |= 1ull << (i % 64);
+        if (!estabaVacia)
+            break;
+        i /= 64;
+    }
+}
+
+void Buddy::MapaNiveles::quitar(uint64_t i) {
+    for (auto& nivel : niveles) {
+        uint64_t& palabra = nivel[i / 64];
+        palabra &= ~(1ull << (i % 64));
+        if (palabra != 0)
+            break;
+        i /= 64;
+    }
+}
+
+int64_t Buddy::MapaNiveles::primero() const {
+    if (niveles.back()[0] == 0)
+        return -1;
+    uint64_t i = 0;
+    for (size_t l = niveles.size(); l-- > 0;)
+        i = i * 64 + std::countr_zero(niveles[l][i]);
+    return (int64_t) i;
+}
+
+// Buddy
+
+Buddy::Buddy(int64_t paginas) : total(std::max<int64_t>(0, paginas)), disponibles(total) {
+    int maximo = total > 0 ? (int) std::bit_width((uint64_t) total) - 1 : 0;
+    for (int orden = 0; orden <= maximo; ++orden) {
+        uint64_t bloques = ((uint64_t) total >> orden) + 1;
+        libresPorOrden.emplace_back(bloques);
+        divididos.emplace_back((bloques + 63) / 64, 0);
+    }
+    contadores.resize(maximo + 1);
+
+    // De mayor a menor orden: cada bloque queda alineado a su tamano
+    int64_t pagina = 0;
+    for (int orden = maximo; orden >= 0; --orden)
+        if (pagina + (1LL << orden) <= total) {
+            ponerLibre(orden, (uint64_t) pagina >> orden);
+            pagina += 1LL << orden;
+        }
+}
+
+int Buddy::ordenPara(int64_t cantidad) {
+    return cantidad <= 1 ? 0 : (int) std::bit_width((uint64_t) cantidad - 1);
+}
+
+bool Buddy::dividido(int orden, uint64_t bloque) const {
+    return (divididos[orden][bloque / 64] >> (bloque % 64)) & 1;
+}
+
+void Buddy::marcarDividido(int orden, uint64_t bloque, bool valor) {
+    uint64_t bit = 1ull << (bloque % 64);
+    if (valor)
+        divididos[orden][bloque / 64] |= bit;
+    else
+        divididos[orden][bloque / 64] &= ~bit;
+}
+
+// Un bloque sin padre: su padre se saldria del final de la memoria
+bool Buddy::esRaiz(int orden, uint64_t bloque) const {
+    return orden == ordenMaximo() || (((bloque >> 1) + 1) << (orden + 1)) > (uint64_t) total;
+}
+
+void Buddy::ponerLibre(int orden, uint64_t bloque) {
+    libresPorOrden[orden].poner(bloque);
+    ++contadores[orden].libres;
+}
+
+void Buddy::quitarLibre(int orden, uint64_t bloque) {
+    libresPorOrden[orden].quitar(bloque);
+    --contadores[orden].libres;
+}
+
+int64_t Buddy::asignar(int64_t cantidad) {
+    if (cantidad < 1 || cantidad > disponibles)
+        return -1;
+    int orden = ordenPara(cantidad);
+    int desde = orden;
+    while (desde <= ordenMaximo() && contadores[desde].libres == 0)
+        ++desde;
+    if (desde > ordenMaximo())
+        return -1;
+
+    uint64_t bloque = (uint64_t) libresPorOrden[desde].primero();
+    quitarLibre(desde, bloque);
+    // Se parte hasta el orden pedido; la mitad derecha de cada division queda libre
+    for (; desde > orden; --desde) {
+        marcarDividido(desde, bloque, true);
+        ++contadores[desde].divisiones;
+        bloque *= 2;
+        ponerLibre(desde - 1, bloque + 1);
+    }
+    ++contadores[orden].ocupados;
+    ++contadores[orden].asignaciones;
+    disponibles -= 1LL << orden;
+    pedidas += cantidad;
+    entregadas += 1LL << orden;
+    return (int64_t) (bloque << orden);
+}
+
+bool Buddy::liberar(int64_t inicio, int64_t cantidad) {
+    int orden = ordenPara(cantidad);
+    if (cantidad < 1 || inicio < 0 || orden > ordenMaximo() || (inicio & ((1LL << orden) - 1)) != 0
+        || inicio + (1LL << orden) > total)
+        return false;
+    uint64_t bloque = (uint64_t) inicio >> orden;
+    // Entregado: ni libre ni dividido, y su padre (si tiene) esta dividido
+    if (libresPorOrden[orden].prueba(bloque) || (orden > 0 && dividido(orden, bloque))
+        || !(esRaiz(orden, bloque) || dividido(orden + 1, bloque >> 1)))
+        return false;
+
+    --contadores[orden].ocupados;
+    disponibles += 1LL << orden;
+    pedidas -= cantidad;
+    entregadas -= 1LL << orden;
+    while (!esRaiz(orden, bloque) && libresPorOrden[orden].prueba(bloque ^ 1)) {
+        quitarLibre(orden, bloque ^ 1);
+        ++contadores[orden].fusiones;
+        bloque >>= 1;
+        ++orden;
+        marcarDividido(orden, bloque, false);
+    }
+    ponerLibre(orden, bloque);
+    return true;
+}
+
+int64_t Buddy::mayorBloqueLibre() const {
+    for (int orden = ordenMaximo(); orden >= 0; --orden)
+        if (contadores[orden].libres > 0)
+            return 1LL << orden;
+    return 0;
+}
+
+double Buddy::fragmentacionInterna() const {
+    return entregadas > 0 ? 1.0 - (double) pedidas / entregadas : 0.0;
+}
+
+double Buddy::fragmentacionExterna() const {
+    return disponibles > 0 ? 1.0 - (double) mayorBloqueLibre() / disponibles : 0.0;
+}
+
+void Buddy::imprimir(std::ostream& os) const {
+    os << "=== Buddy (" << total << " paginas, " << disponibles << " libres) ===\n";
+    os << std::right << std::setw(7) << "orden" << std::setw(12) << "paginas" << std::setw(10) << "libres"
+       << std::setw(10) << "ocupados" << std::setw(14) << "asignaciones" << std::setw(12) << "divisiones"
+       << std::setw(10) << "fusiones" << "\n";
+    for (int orden = 0; orden <= ordenMaximo(); ++orden) {
+        const EstadisticasOrden& c = contadores[orden];
+        if (c.libres == 0 && c.ocupados == 0 && c.asignaciones == 0 && c.divisiones == 0)
+            continue;
+        os << std::setw(7) << orden << std::setw(12) << (1LL << orden) << std::setw(10) << c.libres
+           << std::setw(10) << c.ocupados << std::setw(14) << c.asignaciones << std::setw(12) << c.divisiones
+           << std::setw(10) << c.fusiones << "\n";
+    }
+    os << "  fragmentacion interna: " << std::fixed << std::setprecision(1) << 100.0 * fragmentacionInterna()
+       << "% | externa: " << 100.0 * fragmentacionExterna() << "% (mayor bloque libre: " << mayorBloqueLibre()
+       << " paginas)\n";
+}
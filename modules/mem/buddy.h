@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Contadores de un orden del buddy (bloques de 2^orden paginas)
+struct EstadisticasOrden {
+    uint64_t libres = 0;        // bloques libres ahora
+    uint64_t ocupados = 0;      // bloques entregados ahora
+    uint64_t asignaciones = 0;
+    uint64_t divisiones = 0;    // bloques de este orden partidos en dos
+    uint64_t fusiones = 0;      // pares de este orden unidos en uno del orden siguiente
+};
+
+// Asignador buddy binario sobre paginas fisicas simuladas. Un pedido se redondea a
+// la potencia de dos siguiente; si no hay bloque libre de ese orden se parte uno
+// mayor, y al liberar un bloque se une con su companero (el bloque vecino de su
+// mismo orden) mientras este tambien libre.
+//
+// Sin metadatos por pagina: cada orden tiene un mapa de bits de bloques libres con
+// niveles de resumen (un bit por palabra no vacia), que da el libre de menor
+// direccion con un count-trailing-zeros por nivel, y un mapa de bits de bloques
+// divididos para validar liberaciones.
+// Asignar y liberar son O(ordenes). 64 GiB en paginas de 4 KiB (2^24 paginas)
+// ocupan unos 6 MiB de mapas.
+class Buddy {
+public:
+    // `paginas` no necesita ser potencia de dos: el resto se reparte en bloques menores
+    explicit Buddy(int64_t paginas);
+
+    // Primera pagina de un bloque de al menos `cantidad` paginas, o -1
+    int64_t asignar(int64_t cantidad);
+    // Con la misma cantidad que se pidio; false si no es un bloque entregado
+    bool liberar(int64_t inicio, int64_t cantidad);
+
+    int64_t paginas() const { return total; }
+    int64_t libres() const { return disponibles; }
+    int ordenMaximo() const { return (int) libresPorOrden.size() - 1; }
+    const EstadisticasOrden& estadisticas(int orden) const { return contadores[orden]; }
+    int64_t mayorBloqueLibre() const;
+    // 1 - paginas pedidas / paginas entregadas (el redondeo a potencia de dos)
+    double fragmentacionInterna() const;
+    // 1 - mayor bloque libre / paginas libres
+    double fragmentacionExterna() const;
+    void imprimir(std::ostream& os) const;
+
+private:
+    // Conjunto de bits con resumen: nivel 0 un bit por bloque, cada nivel siguiente
+    // un bit por palabra no vacia del anterior
+    class MapaNiveles {
+    public:
+        explicit MapaNiveles(uint64_t bits);
+        void poner(uint64_t i);
+        void quitar(uint64_t i);
+        bool prueba(uint64_t i) const { return (niveles[0][i / 64] >> (i % 64)) & 1; }
+        int64_t primero() const; // -1 si esta vacio
+    private:
+        std::vector<std::vector<uint64_t>> niveles;
+    };
+
+    static int ordenPara(int64_t cantidad);
+    bool dividido(int orden, uint64_t bloque) const;
+    void marcarDividido(int orden, uint64_t bloque, bool valor);
+    bool esRaiz(int orden, uint64_t bloque) const;
+    void ponerLibre(int orden, uint64_t bloque);
+    void quitarLibre(int orden, uint64_t bloque);
+
+    int64_t total;
+    int64_t disponibles;
+    int64_t pedidas = 0;    // paginas pedidas por los bloques entregados
+    int64_t entregadas = 0; // paginas de los bloques entregados
+    std::vector<MapaNiveles> libresPorOrden;
+    std::vector<std::vector<uint64_t>> divididos; // por orden; el orden 0 no se divide
+    std::vector<EstadisticasOrden> contadores;
+};
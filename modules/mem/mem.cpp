@@ -1,25 +1,246 @@
 #include "mem.h"
+#include "../snapshot/instantanea.h"
+#include <algorithm>
+#include <bit>
+#include <climits>
 #include <iostream>
 
-Memoria::Memoria(int tamaño) : bloques(tamaño, 0) {}
+static constexpr uint64_t LLENA = ~0ull;
 
-int Memoria::asignar(int cantidad) {
-    for (size_t i = 0; i < bloques.size(); ++i) {
-        if (bloques[i] == 0) {
-            bloques[i] = 1;
-            return i;
+// Bits [desde, hasta) de una palabra, con 0 <= desde < hasta <= 64
+static uint64_t mascara(int desde, int hasta) {
+    uint64_t alto = hasta == 64 ? LLENA : (1ull << hasta) - 1;
+    return alto & (LLENA << desde);
+}
+
+Memoria::Memoria(int tamaño, Ajuste ajuste) : total(std::max(0, tamaño)), disponibles(total), ajuste(ajuste) {
+    palabras.assign(((size_t) total + 63) / 64, 0);
+    if (total % 64)
+        palabras.back() = LLENA << (total % 64);
+    if (total > 0)
+        agregarHueco(0, total);
+}
+
+std::optional<Ajuste> ajusteDesdeNombre(const std::string& nombre) {
+    if (nombre == "primero") return Ajuste::Primero;
+    if (nombre == "siguiente") return Ajuste::Siguiente;
+    if (nombre == "mejor") return Ajuste::Mejor;
+    if (nombre == "peor") return Ajuste::Peor;
+    return std::nullopt;
+}
+
+std::string nombreAjuste(Ajuste ajuste) {
+    switch (ajuste) {
+        case Ajuste::Primero: return "primero";
+        case Ajuste::Siguiente: return "siguiente";
+        case Ajuste::Mejor: return "mejor";
+        case Ajuste::Peor: return "peor";
+    }
+    return "?";
+}
+
+// Primer bloque ocupado desde `bloque` (libre); el relleno corta el ultimo hueco en `total`
+int Memoria::finDelHueco(size_t bloque) const {
+    size_t w = bloque / 64;
+    uint64_t ocupados = palabras[w] & (LLENA << (bloque % 64));
+    while (ocupados == 0) {
+        if (++w == palabras.size())
+            return total;
+        ocupados = palabras[w];
+    }
+    return (int) (w * 64 + std::countr_zero(ocupados));
+}
+
+void Memoria::marcar(int inicio, int cantidad) {
+    size_t primera = (size_t) inicio / 64, ultima = (size_t) (inicio + cantidad - 1) / 64;
+    int desde = inicio % 64, hasta = (inicio + cantidad - 1) % 64 + 1;
+    if (primera == ultima) {
+        palabras[primera] |= mascara(desde, hasta);
+        return;
+    }
+    palabras[primera] |= mascara(desde, 64);
+    std::fill(palabras.begin() + (ptrdiff_t) primera + 1, palabras.begin() + (ptrdiff_t) ultima, LLENA);
+    palabras[ultima] |= mascara(0, hasta);
+}
+
+// Primer hueco que alcance, por palabras del mapa de bits
+int Memoria::primerAjuste(int cantidad) const {
+    size_t w = primeraLibre;
+    uint64_t libresEnPalabra = w < palabras.size() ? ~palabras[w] : 0;
+    while (w < palabras.size()) {
+        if (libresEnPalabra == 0) {
+            // Palabra llena: siguiente
+            if (++w < palabras.size())
+                libresEnPalabra = ~palabras[w];
+            continue;
         }
+        size_t inicio = w * 64 + std::countr_zero(libresEnPalabra);
+        if (inicio + (size_t) cantidad > (size_t) total)
+            return -1;
+        int fin = finDelHueco(inicio);
+        if (fin - (int) inicio >= cantidad)
+            return (int) inicio;
+        // Hueco corto: seguir desde el bloque ocupado que lo cierra
+        w = (size_t) fin / 64;
+        if (w >= palabras.size())
+            break;
+        libresEnPalabra = ~palabras[w] & (LLENA << (fin % 64));
     }
     return -1;
 }
 
+// Desde el cursor hasta el final y luego desde el principio hasta el cursor
+int Memoria::siguienteAjuste(int cantidad) const {
+    for (auto hueco = porDireccion.lower_bound(cursor); hueco != porDireccion.end(); ++hueco)
+        if (hueco->second >= cantidad)
+            return hueco->first;
+    for (auto hueco = porDireccion.begin(); hueco != porDireccion.end() && hueco->first < cursor; ++hueco)
+        if (hueco->second >= cantidad)
+            return hueco->first;
+    return -1;
+}
+
+int Memoria::asignar(int cantidad) {
+    if (cantidad < 1 || cantidad > disponibles)
+        return -1;
+    int inicio = -1;
+    switch (ajuste) {
+        case Ajuste::Primero:
+            inicio = primerAjuste(cantidad);
+            break;
+        case Ajuste::Siguiente:
+            inicio = siguienteAjuste(cantidad);
+            break;
+        case Ajuste::Mejor: {
+            auto hueco = porTamano.lower_bound({cantidad, INT_MIN});
+            if (hueco != porTamano.end())
+                inicio = hueco->second;
+            break;
+        }
+        case Ajuste::Peor:
+            if (mayorHueco() >= cantidad)
+                inicio = porTamano.lower_bound({mayorHueco(), INT_MIN})->second;
+            break;
+    }
+    if (inicio < 0)
+        return -1;
+    ocupar(inicio, cantidad);
+    cursor = inicio + cantidad;
+    return inicio;
+}
+
+std::map<int, int>::iterator Memoria::quitarHueco(std::map<int, int>::iterator hueco) {
+    porTamano.erase({hueco->second, hueco->first});
+    return porDireccion.erase(hueco);
+}
+
+// Inserta [inicio, inicio + largo) fusionandolo con los huecos que toca o se solapan
+void Memoria::agregarHueco(int inicio, int largo) {
+    int fin = inicio + largo;
+    auto hueco = porDireccion.upper_bound(inicio);
+    if (hueco != porDireccion.begin()) {
+        auto previo = std::prev(hueco);
+        if (previo->first + previo->second >= inicio) {
+            inicio = previo->first;
+            fin = std::max(fin, previo->first + previo->second);
+            hueco = quitarHueco(previo);
+        }
+    }
+    while (hueco != porDireccion.end() && hueco->first <= fin) {
+        fin = std::max(fin, hueco->first + hueco->second);
+        hueco = quitarHueco(hueco);
+    }
+    porDireccion.emplace(inicio, fin - inicio);
+    porTamano.emplace(fin - inicio, inicio);
+}
+
+// Marca el tramo (libre, dentro de un hueco) y devuelve a los arboles lo que sobra a cada lado
+void Memoria::ocupar(int inicio, int cantidad) {
+    marcar(inicio, cantidad);
+    disponibles -= cantidad;
+    while (primeraLibre < palabras.size() && palabras[primeraLibre] == LLENA)
+        ++primeraLibre;
+
+    auto hueco = std::prev(porDireccion.upper_bound(inicio));
+    int desde = hueco->first, hasta = hueco->first + hueco->second;
+    quitarHueco(hueco);
+    if (desde < inicio)
+        agregarHueco(desde, inicio - desde);
+    if (inicio + cantidad < hasta)
+        agregarHueco(inicio + cantidad, hasta - inicio - cantidad);
+}
+
+void Memoria::reconstruirHuecos() {
+    porDireccion.clear();
+    porTamano.clear();
+    for (int i = 0; i < total;) {
+        size_t w = (size_t) i / 64;
+        uint64_t libresEnPalabra = ~palabras[w] & (LLENA << (i % 64));
+        if (libresEnPalabra == 0) {
+            i = (int) (w + 1) * 64;
+            continue;
+        }
+        int inicio = (int) (w * 64) + std::countr_zero(libresEnPalabra);
+        if (inicio >= total)
+            break;
+        i = finDelHueco((size_t) inicio);
+        porDireccion.emplace(inicio, i - inicio);
+        porTamano.emplace(i - inicio, inicio);
+    }
+}
+
+double Memoria::fragmentacionExterna() const {
+    return disponibles > 0 ? 1.0 - (double) mayorHueco() / disponibles : 0.0;
+}
+
 void Memoria::liberar(int inicio, int cantidad) {
-    for (int i = inicio; i < inicio + cantidad && i < bloques.size(); ++i)
-        bloques[i] = 0;
+    inicio = std::max(inicio, 0);
+    int fin = std::min(inicio + std::max(cantidad, 0), total);
+    for (int i = inicio; i < fin;) {
+        size_t w = (size_t) i / 64;
+        int hasta = (int) std::min<size_t>(64, (size_t) fin - w * 64);
+        uint64_t m = mascara(i % 64, hasta);
+        disponibles += std::popcount(palabras[w] & m);
+        palabras[w] &= ~m;
+        i = (int) (w * 64) + hasta;
+    }
+    if (inicio < fin) {
+        primeraLibre = std::min(primeraLibre, (size_t) inicio / 64);
+        agregarHueco(inicio, fin - inicio);
+    }
 }
 
 void Memoria::mostrar() {
-    for (auto b : bloques)
-        std::cout << (b ? "#" : "_");
+    for (int i = 0; i < total; ++i)
+        std::cout << ((palabras[i / 64] >> (i % 64)) & 1 ? "#" : "_");
     std::cout << "\n";
 }
+
+void Memoria::guardar(instantanea::Escritor& escritor) const {
+    escritor.valor(total);
+    escritor.arreglo(palabras);
+    escritor.valor(ajuste);
+    escritor.valor(cursor);
+}
+
+void Memoria::cargar(instantanea::Lector& lector) {
+    int tamaño = lector.valor<int>();
+    Memoria cargada(tamaño);
+    lector.arreglo(cargada.palabras);
+    if (tamaño < 0 || cargada.palabras.size() != ((size_t) tamaño + 63) / 64)
+        throw std::runtime_error("mapa de memoria inconsistente");
+    if (tamaño % 64)
+        cargada.palabras.back() |= LLENA << (tamaño % 64);
+    cargada.disponibles = 0;
+    for (uint64_t palabra : cargada.palabras)
+        cargada.disponibles += std::popcount(~palabra);
+    cargada.ajuste = lector.valor<Ajuste>();
+    cargada.cursor = lector.valor<int>();
+    if ((int) cargada.ajuste > (int) Ajuste::Peor)
+        throw std::runtime_error("estrategia de memoria desconocida");
+    cargada.reconstruirHuecos();
+    cargada.primeraLibre = 0;
+    while (cargada.primeraLibre < cargada.palabras.size() && cargada.palabras[cargada.primeraLibre] == LLENA)
+        ++cargada.primeraLibre;
+    *this = std::move(cargada);
+}
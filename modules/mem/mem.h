@@ -1,12 +1,70 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
 #include <vector>
 
+namespace instantanea { class Escritor; class Lector; }
+
+// Estrategia de colocacion: en que hueco libre va una asignacion
+//   Primero   - el de menor direccion que alcance (busqueda por palabras en el mapa de bits)
+//   Siguiente - como Primero, pero desde donde termino la asignacion anterior
+//   Mejor     - el mas chico que alcance (empates: menor direccion)
+//   Peor      - el mas grande
+enum class Ajuste : uint8_t { Primero, Siguiente, Mejor, Peor };
+
+std::optional<Ajuste> ajusteDesdeNombre(const std::string& nombre);
+std::string nombreAjuste(Ajuste ajuste);
+
+// Mapa de bloques empaquetado: un bit por bloque (1 = ocupado) en palabras de 64 bits.
+// La busqueda salta palabras llenas enteras y ubica los bordes de cada hueco con
+// count-trailing-zeros, asi que recorrer 16M bloques toca 256K palabras.
+//
+// Los huecos libres se llevan ademas como extensiones en dos arboles: por direccion
+// (para fusionar un hueco liberado con sus vecinos y para el ajuste siguiente) y por
+// tamano (mejor y peor ajuste en O(log n)). La asignacion siempre toma el principio
+// del hueco elegido.
 class Memoria {
 private:
-    std::vector<int> bloques;
+    std::vector<uint64_t> palabras; // los bits de relleno de la ultima palabra van ocupados
+    int total;
+    int disponibles;
+    std::size_t primeraLibre = 0; // ninguna palabra anterior tiene bloques libres
+
+    Ajuste ajuste = Ajuste::Primero;
+    std::map<int, int> porDireccion;           // inicio -> largo
+    std::set<std::pair<int, int>> porTamano;   // (largo, inicio)
+    int cursor = 0;                            // ajuste siguiente: fin de la ultima asignacion
+
+    int finDelHueco(std::size_t bloque) const;
+    void marcar(int inicio, int cantidad);
+    int primerAjuste(int cantidad) const;
+    int siguienteAjuste(int cantidad) const;
+    std::map<int, int>::iterator quitarHueco(std::map<int, int>::iterator hueco);
+    void agregarHueco(int inicio, int largo);
+    void ocupar(int inicio, int cantidad);
+    void reconstruirHuecos();
 public:
-    Memoria(int tamaño);
+    Memoria(int tamaño, Ajuste ajuste = Ajuste::Primero);
+    // Tramo contiguo de `cantidad` bloques libres segun la estrategia: devuelve su inicio, o -1
     int asignar(int cantidad);
     void liberar(int inicio, int cantidad);
     void mostrar();
+    int tamano() const { return total; }
+    int libres() const { return disponibles; }
+
+    // Se puede cambiar en cualquier momento; no mueve lo ya asignado
+    void fijarAjuste(Ajuste nuevo) { ajuste = nuevo; }
+    Ajuste estrategia() const { return ajuste; }
+    int huecos() const { return (int) porDireccion.size(); }
+    int mayorHueco() const { return porTamano.empty() ? 0 : porTamano.rbegin()->first; }
+    // 1 - mayor hueco / bloques libres: 0 con todo lo libre junto
+    double fragmentacionExterna() const;
+
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector);
 };
@@ -0,0 +1,355 @@
+#include "paginacion.h"
+#include "../snapshot/instantanea.h"
+#include <algorithm>
+#include <bit>
+#include <iomanip>
+
+static constexpr uint64_t PAGINAS_VIRTUALES = uint64_t(1) << (BITS_VIRTUALES - BITS_PAGINA);
+
+// ---------------------------------------------------------------- TLB
+
+TLB::TLB(int conjuntos, int vias)
+    : vias_(std::max(vias, 1)), mascara(std::bit_ceil((uint64_t) std::max(conjuntos, 1)) - 1) {
+    std::size_t total = (std::size_t) (mascara + 1) * (std::size_t) vias_;
+    etiquetas.assign(total, SIN_TRADUCCION);
+    marcos.assign(total, 0);
+    usos.assign(total, 0);
+}
+
+uint64_t TLB::buscar(uint32_t espacio, uint64_t pagina) {
+    uint64_t buscada = clave(espacio, pagina);
+    std::size_t inicio = conjunto(pagina);
+    for (std::size_t i = inicio; i < inicio + (std::size_t) vias_; ++i)
+        if (etiquetas[i] == buscada) {
+            usos[i] = ++reloj;
+            ++aciertos_;
+            return marcos[i];
+        }
+    ++fallos_;
+    return SIN_TRADUCCION;
+}
+
+// En la via libre o, si no hay, en la usada hace mas tiempo
+void TLB::insertar(uint32_t espacio, uint64_t pagina, uint64_t marco) {
+    std::size_t inicio = conjunto(pagina), victima = inicio;
+    for (std::size_t i = inicio; i < inicio + (std::size_t) vias_; ++i) {
+        if (etiquetas[i] == SIN_TRADUCCION) {
+            victima = i;
+            break;
+        }
+        if (usos[i] < usos[victima])
+            victima = i;
+    }
+    etiquetas[victima] = clave(espacio, pagina);
+    marcos[victima] = marco;
+    usos[victima] = ++reloj;
+}
+
+void TLB::invalidar(uint32_t espacio, uint64_t pagina) {
+    uint64_t buscada = clave(espacio, pagina);
+    std::size_t inicio = conjunto(pagina);
+    for (std::size_t i = inicio; i < inicio + (std::size_t) vias_; ++i)
+        if (etiquetas[i] == buscada)
+            etiquetas[i] = SIN_TRADUCCION;
+}
+
+void TLB::invalidarEspacio(uint32_t espacio) {
+    for (uint64_t& etiqueta : etiquetas)
+        if (etiqueta != SIN_TRADUCCION && etiqueta >> 36 == espacio)
+            etiqueta = SIN_TRADUCCION;
+}
+
+void TLB::vaciar() {
+    std::fill(etiquetas.begin(), etiquetas.end(), SIN_TRADUCCION);
+}
+
+void TLB::guardar(instantanea::Escritor& escritor) const {
+    escritor.valor(aciertos_);
+    escritor.valor(fallos_);
+}
+
+void TLB::cargar(instantanea::Lector& lector) {
+    vaciar();
+    aciertos_ = lector.valor<uint64_t>();
+    fallos_ = lector.valor<uint64_t>();
+}
+
+// ---------------------------------------------------------------- tabla de paginas
+
+uint64_t EspacioDirecciones::buscar(uint64_t pagina) const {
+    if (tablas.empty())
+        return SIN_TRADUCCION;
+    uint64_t tabla = 0;
+    for (int nivel = 0; nivel < NIVELES_PAGINACION - 1; ++nivel) {
+        tabla = tablas[tabla][indice(pagina, nivel)];
+        if (tabla == 0)
+            return SIN_TRADUCCION;
+    }
+    return entrada((uint32_t) tabla, pagina);
+}
+
+uint32_t EspacioDirecciones::hoja(uint64_t pagina, bool crear) {
+    if (tablas.empty()) {
+        if (!crear)
+            return 0;
+        tablas.emplace_back().fill(0);
+    }
+    uint64_t tabla = 0;
+    for (int nivel = 0; nivel < NIVELES_PAGINACION - 1; ++nivel) {
+        uint64_t hija = tablas[tabla][indice(pagina, nivel)];
+        if (hija == 0) {
+            if (!crear)
+                return 0;
+            hija = tablas.size();
+            tablas.emplace_back().fill(0);
+            tablas[tabla][indice(pagina, nivel)] = hija;
+        }
+        tabla = hija;
+    }
+    return (uint32_t) tabla;
+}
+
+bool EspacioDirecciones::mapear(uint64_t pagina, uint64_t marco) {
+    uint64_t& valor = tablas[hoja(pagina, true)][indice(pagina, NIVELES_PAGINACION - 1)];
+    if (valor & PRESENTE)
+        return false;
+    valor = marco << BITS_PAGINA | PRESENTE;
+    ++mapeadas;
+    return true;
+}
+
+uint64_t EspacioDirecciones::desmapear(uint64_t pagina) {
+    uint32_t tabla = hoja(pagina, false);
+    if (tabla == 0)
+        return SIN_TRADUCCION;
+    uint64_t marco = entrada(tabla, pagina);
+    if (marco != SIN_TRADUCCION) {
+        tablas[tabla][indice(pagina, NIVELES_PAGINACION - 1)] = 0;
+        --mapeadas;
+    }
+    return marco;
+}
+
+void EspacioDirecciones::vaciarDesde(uint32_t tabla, int nivel, std::vector<uint64_t>& marcosLiberados) const {
+    for (uint64_t valor : tablas[tabla]) {
+        if (valor == 0)
+            continue;
+        if (nivel == NIVELES_PAGINACION - 1)
+            marcosLiberados.push_back(valor >> BITS_PAGINA);
+        else
+            vaciarDesde((uint32_t) valor, nivel + 1, marcosLiberados);
+    }
+}
+
+void EspacioDirecciones::vaciar(std::vector<uint64_t>& marcosLiberados) {
+    if (mapeadas > 0)
+        vaciarDesde(0, 0, marcosLiberados);
+    tablas.clear();
+    mapeadas = 0;
+}
+
+void EspacioDirecciones::guardar(instantanea::Escritor& escritor) const {
+    escritor.arreglo(tablas);
+}
+
+// Recorre la tabla cargada desde la raiz: cada tabla a lo sumo una vez y en un solo nivel
+void EspacioDirecciones::cargar(instantanea::Lector& lector) {
+    EspacioDirecciones cargado;
+    lector.arreglo(cargado.tablas);
+    std::vector<uint8_t> visitada(cargado.tablas.size(), 0);
+    std::vector<std::pair<uint64_t, int>> pendientes;
+    if (!cargado.tablas.empty())
+        pendientes.emplace_back(0, 0);
+    while (!pendientes.empty()) {
+        auto [tabla, nivel] = pendientes.back();
+        pendientes.pop_back();
+        if (tabla >= cargado.tablas.size() || visitada[tabla])
+            throw std::runtime_error("tabla de paginas inconsistente");
+        visitada[tabla] = 1;
+        for (uint64_t valor : cargado.tablas[tabla]) {
+            if (valor == 0)
+                continue;
+            if (nivel == NIVELES_PAGINACION - 1)
+                ++cargado.mapeadas;
+            else
+                pendientes.emplace_back(valor, nivel + 1);
+        }
+    }
+    *this = std::move(cargado);
+}
+
+// ---------------------------------------------------------------- memoria virtual
+
+MemoriaVirtual::MemoriaVirtual(uint64_t marcos) : totalMarcos(marcos) {}
+
+void MemoriaVirtual::crearEspacio(uint32_t espacio) {
+    if (espacio >= espacios.size()) {
+        espacios.resize((std::size_t) espacio + 1);
+        vivos.resize((std::size_t) espacio + 1, 0);
+    }
+    if (vivos[espacio])
+        destruirEspacio(espacio);
+    vivos[espacio] = 1;
+}
+
+void MemoriaVirtual::destruirEspacio(uint32_t espacio) {
+    if (!existe(espacio))
+        return;
+    vivos[espacio] = 0;
+    // Un espacio que nunca mapeo nada no puede tener entradas en el TLB
+    if (espacios[espacio].tablasUsadas() == 0)
+        return;
+    espacios[espacio].vaciar(libres);
+    tlb_.invalidarEspacio(espacio);
+}
+
+uint64_t MemoriaVirtual::tomarMarco() {
+    if (!libres.empty()) {
+        uint64_t marco = libres.back();
+        libres.pop_back();
+        return marco;
+    }
+    return siguienteMarco++;
+}
+
+bool MemoriaVirtual::mapear(uint32_t espacio, uint64_t direccion, uint64_t paginas) {
+    uint64_t primera = direccion >> BITS_PAGINA;
+    if (!existe(espacio) || primera >= PAGINAS_VIRTUALES || paginas > PAGINAS_VIRTUALES - primera
+        || paginas > marcosLibres())
+        return false;
+    EspacioDirecciones& destino = espacios[espacio];
+    for (uint64_t pagina = primera; pagina < primera + paginas; ++pagina)
+        if (destino.buscar(pagina) != SIN_TRADUCCION)
+            return false;
+    for (uint64_t pagina = primera; pagina < primera + paginas; ++pagina)
+        destino.mapear(pagina, tomarMarco());
+    return true;
+}
+
+uint64_t MemoriaVirtual::desmapear(uint32_t espacio, uint64_t direccion, uint64_t paginas) {
+    uint64_t primera = direccion >> BITS_PAGINA;
+    if (!existe(espacio) || primera >= PAGINAS_VIRTUALES)
+        return 0;
+    paginas = std::min(paginas, PAGINAS_VIRTUALES - primera);
+    uint64_t liberadas = 0;
+    for (uint64_t pagina = primera; pagina < primera + paginas; ++pagina) {
+        uint64_t marco = espacios[espacio].desmapear(pagina);
+        if (marco == SIN_TRADUCCION)
+            continue;
+        libres.push_back(marco);
+        tlb_.invalidar(espacio, pagina);
+        ++liberadas;
+    }
+    return liberadas;
+}
+
+uint64_t MemoriaVirtual::traducir(uint32_t espacio, uint64_t direccion) {
+    uint64_t pagina = direccion >> BITS_PAGINA;
+    if (!existe(espacio) || pagina >= PAGINAS_VIRTUALES) {
+        ++fallos;
+        return SIN_TRADUCCION;
+    }
+    uint64_t marco = tlb_.buscar(espacio, pagina);
+    if (marco == SIN_TRADUCCION) {
+        ++caminatas;
+        marco = espacios[espacio].buscar(pagina);
+        if (marco == SIN_TRADUCCION) {
+            ++fallos;
+            return SIN_TRADUCCION;
+        }
+        tlb_.insertar(espacio, pagina, marco);
+    }
+    return marco << BITS_PAGINA | (direccion & (TAMANO_PAGINA - 1));
+}
+
+void MemoriaVirtual::traducirLote(uint32_t espacio, const uint64_t* direcciones, uint64_t* fisicas, std::size_t n) {
+    if (!existe(espacio)) {
+        std::fill(fisicas, fisicas + n, SIN_TRADUCCION);
+        fallos += n;
+        return;
+    }
+    EspacioDirecciones& origen = espacios[espacio];
+    uint64_t paginaPrevia = SIN_TRADUCCION, marcoPrevio = SIN_TRADUCCION;
+    uint64_t prefijoHoja = SIN_TRADUCCION; // paginas que cubre `hoja`, desplazadas BITS_NIVEL
+    uint32_t hoja = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        uint64_t pagina = direcciones[i] >> BITS_PAGINA;
+        uint64_t marco;
+        if (pagina == paginaPrevia && marcoPrevio != SIN_TRADUCCION) {
+            // La busqueda anterior dejo esta pagina en el TLB como la mas reciente
+            tlb_.contarAcierto();
+            marco = marcoPrevio;
+        } else if (pagina >= PAGINAS_VIRTUALES) {
+            ++fallos;
+            marco = SIN_TRADUCCION;
+        } else if ((marco = tlb_.buscar(espacio, pagina)) == SIN_TRADUCCION) {
+            if (pagina >> BITS_NIVEL != prefijoHoja) {
+                ++caminatas;
+                hoja = origen.hoja(pagina, false);
+                prefijoHoja = pagina >> BITS_NIVEL;
+            }
+            marco = hoja ? origen.entrada(hoja, pagina) : SIN_TRADUCCION;
+            if (marco == SIN_TRADUCCION)
+                ++fallos;
+            else
+                tlb_.insertar(espacio, pagina, marco);
+        }
+        paginaPrevia = pagina;
+        marcoPrevio = marco;
+        fisicas[i] = marco == SIN_TRADUCCION ? SIN_TRADUCCION
+                                             : marco << BITS_PAGINA | (direcciones[i] & (TAMANO_PAGINA - 1));
+    }
+}
+
+void MemoriaVirtual::imprimir(std::ostream& os) const {
+    std::size_t activos = 0, paginas = 0, tablas = 0;
+    for (std::size_t i = 0; i < espacios.size(); ++i) {
+        if (!vivos[i])
+            continue;
+        ++activos;
+        paginas += espacios[i].paginas();
+        tablas += espacios[i].tablasUsadas();
+    }
+    uint64_t busquedas = tlb_.aciertos() + tlb_.fallos();
+    os << "  espacios: " << activos << " | paginas mapeadas: " << paginas
+       << " | tablas de paginas: " << tablas << " (" << tablas * sizeof(EspacioDirecciones::Tabla) / 1024 << " KiB)\n";
+    os << "  marcos: " << totalMarcos - marcosLibres() << " de " << totalMarcos << " en uso ("
+       << TAMANO_PAGINA / 1024 << " KiB cada uno)\n";
+    os << "  TLB " << tlb_.entradas() / (std::size_t) tlb_.vias() << "x" << tlb_.vias()
+       << ": aciertos " << tlb_.aciertos() << " | fallos " << tlb_.fallos() << " | tasa de acierto "
+       << std::fixed << std::setprecision(1) << (busquedas ? 100.0 * tlb_.aciertos() / busquedas : 0.0) << "%"
+       << " | recorridos de tabla " << caminatas << " | fallos de pagina " << fallos << "\n";
+}
+
+void MemoriaVirtual::guardar(instantanea::Escritor& escritor) const {
+    escritor.valor(totalMarcos);
+    escritor.valor(siguienteMarco);
+    escritor.arreglo(libres);
+    escritor.arreglo(vivos);
+    for (std::size_t i = 0; i < espacios.size(); ++i)
+        espacios[i].guardar(escritor);
+    escritor.valor(fallos);
+    escritor.valor(caminatas);
+    tlb_.guardar(escritor);
+}
+
+void MemoriaVirtual::cargar(instantanea::Lector& lector) {
+    MemoriaVirtual cargada(lector.valor<uint64_t>());
+    cargada.siguienteMarco = lector.valor<uint64_t>();
+    lector.arreglo(cargada.libres);
+    lector.arreglo(cargada.vivos);
+    if (cargada.siguienteMarco > cargada.totalMarcos || cargada.libres.size() > cargada.siguienteMarco)
+        throw std::runtime_error("marcos de memoria virtual inconsistentes");
+    cargada.espacios.resize(cargada.vivos.size());
+    uint64_t enUso = 0;
+    for (std::size_t i = 0; i < cargada.espacios.size(); ++i) {
+        cargada.espacios[i].cargar(lector);
+        enUso += cargada.espacios[i].paginas();
+    }
+    if (enUso != cargada.siguienteMarco - cargada.libres.size())
+        throw std::runtime_error("marcos de memoria virtual inconsistentes");
+    cargada.fallos = lector.valor<uint64_t>();
+    cargada.caminatas = lector.valor<uint64_t>();
+    cargada.tlb_.cargar(lector);
+    *this = std::move(cargada);
+}
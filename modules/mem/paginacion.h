@@ -0,0 +1,155 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace instantanea { class Escritor; class Lector; }
+
+// Memoria virtual paginada: paginas de 4 KiB y direcciones virtuales de 48 bits
+// traducidas con una tabla radix de 4 niveles de 512 entradas (como x86-64).
+constexpr int BITS_PAGINA = 12;
+constexpr uint64_t TAMANO_PAGINA = uint64_t(1) << BITS_PAGINA;
+constexpr int NIVELES_PAGINACION = 4;
+constexpr int BITS_NIVEL = 9;
+constexpr int BITS_VIRTUALES = BITS_PAGINA + NIVELES_PAGINACION * BITS_NIVEL;
+constexpr uint64_t SIN_TRADUCCION = ~uint64_t(0);
+
+// TLB asociativo por conjuntos. Las entradas llevan el espacio de direcciones
+// (ASID) en la etiqueta, asi que cambiar de proceso no obliga a vaciarlo; al
+// destruir un espacio se invalidan sus entradas. Reemplazo LRU dentro del conjunto,
+// que se elige con los bits bajos del numero de pagina virtual.
+class TLB {
+public:
+    // `conjuntos` se redondea a potencia de dos
+    explicit TLB(int conjuntos = 16, int vias = 4);
+
+    // Marco de la pagina o SIN_TRADUCCION; cuenta el acierto o el fallo
+    uint64_t buscar(uint32_t espacio, uint64_t pagina);
+    void insertar(uint32_t espacio, uint64_t pagina, uint64_t marco);
+    void invalidar(uint32_t espacio, uint64_t pagina);
+    void invalidarEspacio(uint32_t espacio);
+    void vaciar();
+
+    // Una busqueda que se sabe acertada sin mirar el arreglo (ver traducirLote)
+    void contarAcierto() { ++aciertos_; }
+
+    std::size_t entradas() const { return etiquetas.size(); }
+    int vias() const { return vias_; }
+    uint64_t aciertos() const { return aciertos_; }
+    uint64_t fallos() const { return fallos_; }
+
+    // Solo los contadores: las entradas no sobreviven a una instantanea
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector);
+
+private:
+    // El espacio va en los bits altos: hasta 2^28 espacios
+    static uint64_t clave(uint32_t espacio, uint64_t pagina) { return (uint64_t) espacio << 36 | pagina; }
+    std::size_t conjunto(uint64_t pagina) const { return (std::size_t) (pagina & mascara) * (std::size_t) vias_; }
+
+    int vias_;
+    uint64_t mascara;
+    std::vector<uint64_t> etiquetas; // SIN_TRADUCCION = entrada invalida
+    std::vector<uint64_t> marcos;
+    std::vector<uint64_t> usos;      // marca del ultimo uso, para LRU
+    uint64_t reloj = 0;
+    uint64_t aciertos_ = 0, fallos_ = 0;
+};
+
+// Tabla de paginas de un proceso. Las tablas de cada nivel se crean al mapear la
+// primera pagina que las necesita y viven en un arreglo; una entrada interna es el
+// indice de la tabla hija (0: no hay, la raiz es la 0) y una hoja es el marco
+// desplazado BITS_PAGINA con el bit de presente. Desmapear no devuelve tablas.
+class EspacioDirecciones {
+public:
+    using Tabla = std::array<uint64_t, std::size_t(1) << BITS_NIVEL>;
+
+    // Marco de la pagina virtual o SIN_TRADUCCION (recorre los cuatro niveles)
+    uint64_t buscar(uint64_t pagina) const;
+    // Tabla hoja que cubre la pagina (0 si no existe); con `crear`, la arma
+    uint32_t hoja(uint64_t pagina, bool crear);
+    uint64_t entrada(uint32_t hoja, uint64_t pagina) const {
+        uint64_t valor = tablas[hoja][pagina & (TAMANO_TABLA - 1)];
+        return valor & PRESENTE ? valor >> BITS_PAGINA : SIN_TRADUCCION;
+    }
+
+    // false si la pagina ya estaba mapeada
+    bool mapear(uint64_t pagina, uint64_t marco);
+    // Marco que tenia, o SIN_TRADUCCION
+    uint64_t desmapear(uint64_t pagina);
+    // Marcos de todas las paginas mapeadas; deja el espacio vacio
+    void vaciar(std::vector<uint64_t>& marcosLiberados);
+
+    std::size_t paginas() const { return mapeadas; }
+    std::size_t tablasUsadas() const { return tablas.size(); }
+
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector);
+
+private:
+    static constexpr std::size_t TAMANO_TABLA = std::size_t(1) << BITS_NIVEL;
+    static constexpr uint64_t PRESENTE = 1;
+    static std::size_t indice(uint64_t pagina, int nivel) {
+        return (std::size_t) (pagina >> (BITS_NIVEL * (NIVELES_PAGINACION - 1 - nivel))) & (TAMANO_TABLA - 1);
+    }
+    void vaciarDesde(uint32_t tabla, int nivel, std::vector<uint64_t>& marcosLiberados) const;
+
+    std::vector<Tabla> tablas; // vacio hasta la primera pagina; la raiz es tablas[0]
+    std::size_t mapeadas = 0;
+};
+
+// Espacios de direcciones por proceso (indexados por ASID: la ranura del proceso en
+// su tabla), los marcos fisicos que reparten y el TLB que comparten.
+class MemoriaVirtual {
+public:
+    explicit MemoriaVirtual(uint64_t marcos = uint64_t(1) << 16);
+
+    // Un espacio vacio para el ASID; destruirlo devuelve sus marcos e invalida el TLB
+    void crearEspacio(uint32_t espacio);
+    void destruirEspacio(uint32_t espacio);
+    bool existe(uint32_t espacio) const { return espacio < espacios.size() && vivos[espacio]; }
+
+    // `paginas` paginas desde la de `direccion`, cada una con un marco libre. false
+    // (sin cambios) si el espacio no existe, el rango se sale de los 48 bits, alguna
+    // pagina ya estaba mapeada o no alcanzan los marcos
+    bool mapear(uint32_t espacio, uint64_t direccion, uint64_t paginas);
+    // Paginas no mapeadas del rango se ignoran; devuelve cuantas se liberaron
+    uint64_t desmapear(uint32_t espacio, uint64_t direccion, uint64_t paginas);
+
+    // Direccion fisica o SIN_TRADUCCION (fallo de pagina). Primero el TLB; en un
+    // fallo del TLB se recorre la tabla y la traduccion se carga en el TLB.
+    uint64_t traducir(uint32_t espacio, uint64_t direccion);
+    // Mismo resultado, aciertos, fallos del TLB y fallos de pagina que traducir una
+    // por una, pero una referencia a la misma pagina que la anterior no busca en el
+    // TLB, y en un fallo del TLB se reusa la ultima tabla hoja si cubre la pagina, sin
+    // recorrer los niveles de arriba. Pensado para trazas de referencias con localidad.
+    void traducirLote(uint32_t espacio, const uint64_t* direcciones, uint64_t* fisicas, std::size_t n);
+
+    const TLB& tlb() const { return tlb_; }
+    const EspacioDirecciones* espacio(uint32_t espacio) const {
+        return existe(espacio) ? &espacios[espacio] : nullptr;
+    }
+    uint64_t fallosPagina() const { return fallos; }
+    uint64_t recorridos() const { return caminatas; } // recorridos de la tabla desde la raiz
+    uint64_t marcosTotales() const { return totalMarcos; }
+    uint64_t marcosLibres() const { return totalMarcos - siguienteMarco + libres.size(); }
+    void imprimir(std::ostream& os) const;
+
+    // Espacios, marcos y contadores; el TLB queda vacio al cargar
+    void guardar(instantanea::Escritor& escritor) const;
+    void cargar(instantanea::Lector& lector);
+
+private:
+    uint64_t tomarMarco();
+
+    uint64_t totalMarcos;
+    uint64_t siguienteMarco = 0;  // marcos desde aqui nunca se entregaron
+    std::vector<uint64_t> libres; // marcos devueltos
+    std::vector<EspacioDirecciones> espacios;
+    std::vector<uint8_t> vivos;
+    TLB tlb_;
+    uint64_t fallos = 0;
+    uint64_t caminatas = 0;
+};
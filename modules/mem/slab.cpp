@@ -0,0 +1,299 @@
+#include "slab.h"
+#include <algorithm>
+#include <iomanip>
+#include <sys/mman.h>
+
+namespace slab {
+
+static atomic<bool> interruptor{true};
+static atomic<int> proximoId{0};
+
+// Registro de caches para las estadisticas; nunca se borra nada
+static mutex candadoRegistro;
+static vector<Cache*>& registro() {
+    static auto* caches = new vector<Cache*>();
+    return *caches;
+}
+
+bool activo() { return interruptor.load(memory_order_relaxed); }
+void fijarActivo(bool valor) { interruptor.store(valor, memory_order_relaxed); }
+
+// Solo el hilo duenio escribe; los atomicos relajados (carga y guardado, sin
+// lectura-modificacion-escritura) dejan que las estadisticas los lean desde otro hilo
+struct Cargador {
+    Cache* cache = nullptr;
+    atomic<int> cuenta{0};
+    atomic<uint64_t> asignaciones{0}, liberaciones{0};
+    void* objetos[CAPACIDAD_CARGADOR] = {};
+
+    int cantidad() const { return cuenta.load(memory_order_relaxed); }
+    void fijarCantidad(int n) { cuenta.store(n, memory_order_relaxed); }
+    static void sumar(atomic<uint64_t>& contador) {
+        contador.store(contador.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    }
+};
+
+// Camino rapido: un puntero por cache, sin destructor ni inicializacion perezosa
+static thread_local Cargador* cargadoresRapidos[MAX_CACHES];
+
+// Duenio de los cargadores del hilo: al terminar el hilo los devuelve a sus caches
+struct Cargadores {
+    bool registrado = false;
+    ~Cargadores() {
+        for (Cargador*& cargador : cargadoresRapidos)
+            if (cargador) {
+                cargador->cache->retirar(cargador);
+                cargador = nullptr;
+            }
+    }
+};
+static thread_local Cargadores cargadoresDelHilo;
+
+static size_t redondear(size_t valor, size_t multiplo) {
+    return (valor + multiplo - 1) / multiplo * multiplo;
+}
+
+Cache::Cache(const string& nombre, size_t tamano, size_t alineacion)
+    : nombre(nombre), tamano(tamano), id(proximoId.fetch_add(1)) {
+    alineacion = max(alineacion, alignof(void*));
+    ranura = redondear(max(tamano, sizeof(void*)), alineacion);
+    primeraRanura = redondear(sizeof(Slab), alineacion);
+    porSlab = tamano <= TAMANO_SLAB / 8 && id < MAX_CACHES ? (TAMANO_SLAB - primeraRanura) / ranura : 0;
+
+    // Solo espacio de direcciones: las paginas se respaldan al tocarlas
+    void* region = mmap(nullptr, RESERVA_CACHE + TAMANO_SLAB, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (region != MAP_FAILED && porSlab > 0) {
+        base = redondear(reinterpret_cast<uintptr_t>(region), TAMANO_SLAB);
+        fin = base + RESERVA_CACHE;
+        siguiente = base;
+    } else if (region != MAP_FAILED) {
+        munmap(region, RESERVA_CACHE + TAMANO_SLAB);
+    }
+
+    lock_guard<mutex> guardia(candadoRegistro);
+    registro().push_back(this);
+}
+
+Cargador& Cache::nuevoCargador() {
+    cargadoresDelHilo.registrado = true; // el primer uso registra el destructor del hilo
+    auto* cargador = new Cargador{this};
+    cargadoresRapidos[id] = cargador;
+    lock_guard<mutex> guardia(candado);
+    cargadores.push_back(cargador);
+    return *cargador;
+}
+
+void Cache::retirar(Cargador* cargador) {
+    if (cargador->cantidad() > 0)
+        vaciar(*cargador, cargador->cantidad());
+    lock_guard<mutex> guardia(candado);
+    asignacionesPrevias += cargador->asignaciones.load(memory_order_relaxed);
+    liberacionesPrevias += cargador->liberaciones.load(memory_order_relaxed);
+    cargadores.erase(find(cargadores.begin(), cargadores.end(), cargador));
+    delete cargador;
+}
+
+void* Cache::asignar() {
+    if (porSlab == 0)
+        return nullptr;
+    Cargador* cargador = cargadoresRapidos[id];
+    if (!cargador)
+        cargador = &nuevoCargador();
+    int n = cargador->cantidad();
+    void* objeto;
+    if (n > 0) {
+        objeto = cargador->objetos[n - 1];
+        cargador->fijarCantidad(n - 1);
+    } else if (!(objeto = recargar(*cargador))) {
+        return nullptr;
+    }
+    Cargador::sumar(cargador->asignaciones);
+    return objeto;
+}
+
+void Cache::liberar(void* objeto) {
+    Cargador* cargador = cargadoresRapidos[id];
+    if (!cargador)
+        cargador = &nuevoCargador();
+    if (cargador->cantidad() == CAPACIDAD_CARGADOR)
+        vaciar(*cargador, CAPACIDAD_CARGADOR / 2);
+    int n = cargador->cantidad();
+    cargador->objetos[n] = objeto;
+    cargador->fijarCantidad(n + 1);
+    Cargador::sumar(cargador->liberaciones);
+}
+
+// Llena medio cargador desde los slabs parciales, luego los vacios y por ultimo
+// slabs nuevos, y entrega uno de esos objetos
+void* Cache::recargar(Cargador& cargador) {
+    lock_guard<mutex> guardia(candado);
+    ++recargas;
+    int n = cargador.cantidad();
+    while (n < CAPACIDAD_CARGADOR / 2) {
+        Slab* s = listas[Parciales] ? listas[Parciales] : listas[Vacios];
+        if (!s && !(s = nuevoSlab()))
+            break;
+        while (s->libre && n < CAPACIDAD_CARGADOR / 2) {
+            void* objeto = s->libre;
+            s->libre = *static_cast<void**>(objeto);
+            ++s->enUso;
+            ++fueraDeSlabs;
+            cargador.objetos[n++] = objeto;
+        }
+        reubicar(s);
+    }
+    void* objeto = n > 0 ? cargador.objetos[--n] : nullptr;
+    cargador.fijarCantidad(n);
+    return objeto;
+}
+
+// Devuelve a sus slabs los `cantidad` objetos de la cima del cargador
+void Cache::vaciar(Cargador& cargador, int cantidad) {
+    lock_guard<mutex> guardia(candado);
+    ++recargas;
+    int n = cargador.cantidad();
+    for (int i = 0; i < cantidad; ++i) {
+        void* objeto = cargador.objetos[--n];
+        Slab* s = slabDe(objeto);
+        *static_cast<void**>(objeto) = s->libre;
+        s->libre = objeto;
+        --s->enUso;
+        --fueraDeSlabs;
+        reubicar(s);
+    }
+    cargador.fijarCantidad(n);
+}
+
+Cache::Slab* Cache::nuevoSlab() {
+    uintptr_t direccion;
+    if (!devueltos.empty()) {
+        direccion = reinterpret_cast<uintptr_t>(devueltos.back());
+        devueltos.pop_back();
+    } else if (siguiente < fin) {
+        direccion = siguiente;
+        siguiente += TAMANO_SLAB;
+    } else {
+        return nullptr;
+    }
+    Slab* s = new (reinterpret_cast<void*>(direccion)) Slab();
+    // Lista de ranuras libres en orden de direccion
+    void** enlace = &s->libre;
+    for (size_t i = 0; i < porSlab; ++i) {
+        void* ranuraLibre = reinterpret_cast<void*>(direccion + primeraRanura + i * ranura);
+        *enlace = ranuraLibre;
+        enlace = static_cast<void**>(ranuraLibre);
+    }
+    *enlace = nullptr;
+    enlazar(s, Vacios);
+    return s;
+}
+
+// El slab sigue en la region pero sus paginas vuelven al sistema
+void Cache::devolverSlab(Slab* s) {
+    madvise(s, TAMANO_SLAB, MADV_DONTNEED);
+    devueltos.push_back(s);
+}
+
+void Cache::enlazar(Slab* s, Lista lista) {
+    s->lista = lista;
+    s->ant = nullptr;
+    s->sig = listas[lista];
+    if (s->sig)
+        s->sig->ant = s;
+    listas[lista] = s;
+    ++cuenta[lista];
+}
+
+void Cache::desenlazar(Slab* s) {
+    if (s->ant)
+        s->ant->sig = s->sig;
+    else
+        listas[s->lista] = s->sig;
+    if (s->sig)
+        s->sig->ant = s->ant;
+    --cuenta[s->lista];
+}
+
+// Mueve el slab a la lista que corresponde a su ocupacion y devuelve los vacios de mas
+void Cache::reubicar(Slab* s) {
+    Lista destino = s->enUso == 0 ? Vacios : s->enUso == porSlab ? Llenos : Parciales;
+    if (destino != s->lista) {
+        desenlazar(s);
+        enlazar(s, destino);
+    }
+    size_t retenidos = max<size_t>(VACIOS_RETENIDOS, (cuenta[Parciales] + cuenta[Llenos]) / 8);
+    while (cuenta[Vacios] > retenidos) {
+        Slab* vacio = listas[Vacios];
+        desenlazar(vacio);
+        devolverSlab(vacio);
+    }
+}
+
+Estadisticas Cache::estadisticas() const {
+    Estadisticas e;
+    e.nombre = nombre;
+    e.tamanoObjeto = ranura;
+    e.objetosPorSlab = porSlab;
+    lock_guard<mutex> guardia(candado);
+    e.asignaciones = asignacionesPrevias;
+    e.liberaciones = liberacionesPrevias;
+    for (const Cargador* cargador : cargadores) {
+        e.asignaciones += cargador->asignaciones.load(memory_order_relaxed);
+        e.liberaciones += cargador->liberaciones.load(memory_order_relaxed);
+        e.enCargadores += (uint64_t) cargador->cantidad();
+    }
+    // Los cargadores de otros hilos pueden moverse mientras se leen: acotar
+    e.enCargadores = min(e.enCargadores, fueraDeSlabs);
+    e.vivos = fueraDeSlabs - e.enCargadores;
+    e.parciales = cuenta[Parciales];
+    e.llenos = cuenta[Llenos];
+    e.vacios = cuenta[Vacios];
+    e.recargas = recargas;
+    e.bytesSlabs = e.slabs() * TAMANO_SLAB;
+    return e;
+}
+
+double Estadisticas::utilizacion() const {
+    size_t ranuras = slabs() * objetosPorSlab;
+    return ranuras > 0 ? (double) vivos / ranuras : 0.0;
+}
+
+double Estadisticas::sobrecarga(size_t tamanoPedido) const {
+    return vivos > 0 ? (double) bytesSlabs / (vivos * tamanoPedido) - 1.0 : 0.0;
+}
+
+vector<Estadisticas> estadisticas() {
+    vector<Cache*> caches;
+    {
+        lock_guard<mutex> guardia(candadoRegistro);
+        caches = registro();
+    }
+    vector<Estadisticas> todas;
+    for (Cache* cache : caches)
+        todas.push_back(cache->estadisticas());
+    return todas;
+}
+
+void imprimir(ostream& os) {
+    vector<Cache*> caches;
+    {
+        lock_guard<mutex> guardia(candadoRegistro);
+        caches = registro();
+    }
+    if (caches.empty())
+        return;
+    os << "  slabs (" << (activo() ? "activo" : "apagado") << "):\n";
+    for (Cache* cache : caches) {
+        Estadisticas e = cache->estadisticas();
+        os << "  " << left << setw(10) << e.nombre << right
+           << " objeto=" << setw(4) << e.tamanoObjeto << "B x" << e.objetosPorSlab
+           << " | slabs " << e.parciales << "/" << e.llenos << "/" << e.vacios << " (parc/llenos/vacios)"
+           << " | vivos " << e.vivos << " + " << e.enCargadores << " en cargadores"
+           << " | utilizacion " << fixed << setprecision(1) << 100.0 * e.utilizacion() << "%"
+           << " | " << e.bytesSlabs / 1024 << " KiB de slabs para "
+           << e.vivos * cache->tamanoPedido() / 1024 << " KiB de objetos\n";
+    }
+}
+
+} // namespace slab
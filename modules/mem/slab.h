@@ -0,0 +1,157 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Asignador de slabs para objetos de tamano fijo del nucleo (PCB, File, Directory).
+//
+// Cada tipo tiene su cache: slabs de TAMANO_SLAB bytes, alineados a su tamano, con
+// una cabecera al principio y el resto partido en ranuras del objeto. Las ranuras
+// libres de un slab forman una lista intrusiva, y los slabs van en tres listas segun
+// su ocupacion: parciales (de donde se asigna), llenos y vacios. Los vacios se
+// guardan hasta un octavo de los slabs en uso (al menos VACIOS_RETENIDOS) para no
+// devolver y volver a pedir paginas en cada vaiven; los demas vuelven al sistema.
+//
+// Cada hilo tiene ademas un cargador por cache (una pila de hasta CAPACIDAD_CARGADOR
+// objetos): asignar y liberar solo tocan esa pila, sin candado; el cache solo se
+// bloquea para recargar o vaciar medio cargador de una vez.
+//
+// Los slabs salen de una region virtual reservada por cache, asi que saber si un
+// puntero es de un cache es comparar con los bordes de la region. Eso permite
+// cambiar el interruptor (slab::fijarActivo) en cualquier momento: los objetos
+// creados con el heap vuelven al heap y los de slab a su cache.
+namespace slab {
+
+constexpr size_t TAMANO_SLAB = 64 * 1024;
+constexpr size_t RESERVA_CACHE = size_t(1) << 30; // espacio virtual por cache
+constexpr int CAPACIDAD_CARGADOR = 32;
+constexpr int VACIOS_RETENIDOS = 2;
+constexpr int MAX_CACHES = 16; // los caches de mas no tienen slabs: todo va al heap
+
+struct Cargador;
+
+struct Estadisticas {
+    string nombre;
+    size_t tamanoObjeto = 0;        // ranura, con el relleno de alineacion
+    size_t objetosPorSlab = 0;
+    size_t parciales = 0, llenos = 0, vacios = 0;
+    uint64_t vivos = 0;             // entregados y no liberados
+    uint64_t enCargadores = 0;      // fuera de los slabs pero guardados en los cargadores
+    uint64_t asignaciones = 0, liberaciones = 0;
+    uint64_t recargas = 0;          // viajes al cache (recargar o vaciar un cargador)
+    size_t bytesSlabs = 0;          // memoria de los slabs en uso
+
+    size_t slabs() const { return parciales + llenos + vacios; }
+    // Ranuras ocupadas por objetos vivos sobre las ranuras de todos los slabs
+    double utilizacion() const;
+    // Bytes de slab por byte de objeto vivo, menos uno
+    double sobrecarga(size_t tamanoPedido) const;
+};
+
+class Cache {
+public:
+    Cache(const string& nombre, size_t tamano, size_t alineacion);
+    Cache(const Cache&) = delete;
+    Cache& operator=(const Cache&) = delete;
+
+    // nullptr si la region del cache se agoto
+    void* asignar();
+    void liberar(void* objeto);
+    bool posee(const void* p) const {
+        auto direccion = reinterpret_cast<uintptr_t>(p);
+        return direccion >= base && direccion < fin;
+    }
+
+    Estadisticas estadisticas() const;
+    size_t tamanoPedido() const { return tamano; }
+
+private:
+    struct Slab {
+        Slab* ant = nullptr;
+        Slab* sig = nullptr;
+        void* libre = nullptr; // primera ranura libre; cada ranura libre apunta a la siguiente
+        uint32_t enUso = 0;
+        uint8_t lista = 0;
+    };
+    enum Lista : uint8_t { Parciales, Llenos, Vacios };
+
+    friend struct Cargadores;
+    Cargador& nuevoCargador();
+    void retirar(Cargador* cargador);
+    void* recargar(Cargador& cargador);
+    void vaciar(Cargador& cargador, int cantidad);
+
+    Slab* slabDe(void* objeto) const {
+        return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(objeto) & ~(TAMANO_SLAB - 1));
+    }
+    Slab* nuevoSlab();
+    void devolverSlab(Slab* s);
+    void enlazar(Slab* s, Lista lista);
+    void desenlazar(Slab* s);
+    void reubicar(Slab* s);
+
+    string nombre;
+    size_t tamano;
+    size_t ranura;
+    size_t primeraRanura; // desplazamiento de la primera ranura tras la cabecera
+    size_t porSlab;
+    int id;
+
+    uintptr_t base = 0;      // region reservada, alineada a TAMANO_SLAB (vacia si no se pudo)
+    uintptr_t fin = 0;
+    uintptr_t siguiente = 0; // primer slab nunca usado de la region
+    vector<Slab*> devueltos; // slabs liberados al sistema, listos para reusar
+
+    mutable mutex candado;
+    Slab* listas[3] = {nullptr, nullptr, nullptr};
+    size_t cuenta[3] = {0, 0, 0};
+    uint64_t fueraDeSlabs = 0; // ranuras entregadas a cargadores o a usuarios
+    uint64_t recargas = 0;
+    // Los contadores van en cada cargador; aqui quedan los de hilos ya terminados
+    vector<Cargador*> cargadores;
+    uint64_t asignacionesPrevias = 0, liberacionesPrevias = 0;
+};
+
+// Interruptor global: apagado, los tipos con operador new de slab usan el heap
+bool activo();
+void fijarActivo(bool valor);
+
+// Cache de un tipo: se crea en el primer uso y no se destruye nunca (puede haber
+// objetos vivos hasta el final del programa)
+template <typename T>
+Cache& cacheDe(const char* nombre) {
+    static Cache* cache = new Cache(nombre, sizeof(T), alignof(T));
+    return *cache;
+}
+
+// Para los operator new/delete de clase. Una subclase mas grande que no los
+// redefina cae en el heap por el tamano.
+template <typename T>
+void* asignar(const char* nombre, size_t tamano) {
+    if (tamano == sizeof(T) && activo())
+        if (void* p = cacheDe<T>(nombre).asignar())
+            return p;
+    return ::operator new(tamano);
+}
+
+template <typename T>
+void liberar(const char* nombre, void* p) {
+    Cache& cache = cacheDe<T>(nombre);
+    if (cache.posee(p))
+        cache.liberar(p);
+    else
+        ::operator delete(p);
+}
+
+vector<Estadisticas> estadisticas();
+// Tabla de los caches creados; nada si todavia no hay ninguno
+void imprimir(ostream& os);
+
+} // namespace slab
@@ -0,0 +1,169 @@
+#include "instantanea.h"
+#include "../cpu/cpu.h"
+#include "../disk/disk.h"
+#include "../mem/mem.h"
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace instantanea {
+
+namespace {
+    const char MAGIA[8] = {'K', 'S', 'I', 'M', 'S', 'N', 'A', 'P'};
+
+    struct Cabecera {
+        char magia[8];
+        uint32_t version;
+        uint32_t reservado;
+        uint64_t tamano; // bytes despues de la cabecera
+    };
+
+    // Archivo de solo lectura mapeado en memoria; se desmapea al salir de alcance
+    struct Mapeo {
+        const char* datos = nullptr;
+        size_t tamano = 0;
+
+        explicit Mapeo(const string& archivo) {
+            int fd = open(archivo.c_str(), O_RDONLY);
+            if (fd < 0)
+                return;
+            struct stat info;
+            if (fstat(fd, &info) == 0 && info.st_size > 0) {
+                void* p = mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    datos = static_cast<const char*>(p);
+                    tamano = (size_t) info.st_size;
+                }
+            }
+            close(fd);
+        }
+
+        ~Mapeo() {
+            if (datos)
+                munmap(const_cast<char*>(datos), tamano);
+        }
+
+        Mapeo(const Mapeo&) = delete;
+        Mapeo& operator=(const Mapeo&) = delete;
+    };
+}
+
+// Escritor
+
+void Escritor::crudo(const void* datos, size_t bytes) {
+    size_t inicio = bufer.size();
+    bufer.resize(inicio + bytes);
+    if (bytes)
+        memcpy(bufer.data() + inicio, datos, bytes);
+}
+
+void Escritor::alinear() {
+    bufer.resize((bufer.size() + 7) & ~size_t(7), 0);
+}
+
+// Lector
+
+const char* Lector::tomar(size_t bytes) {
+    if (bytes > (size_t) (fin - pos))
+        throw runtime_error("instantanea truncada");
+    const char* p = pos;
+    pos += bytes;
+    return p;
+}
+
+void Lector::alinear() {
+    size_t desplazamiento = ((size_t) (pos - inicio) + 7) & ~size_t(7);
+    pos = inicio + min(desplazamiento, (size_t) (fin - inicio));
+}
+
+// Archivo
+
+bool guardar(const string& archivo, const CPU& cpu, const Disk& disco, const Memoria* memoria, string& error) {
+    Escritor escritor;
+    escritor.seccion(Seccion::CPU);
+    cpu.guardar(escritor);
+    escritor.seccion(Seccion::Disco);
+    disco.guardar(escritor);
+    escritor.seccion(Seccion::Memoria);
+    escritor.valor<uint8_t>(memoria != nullptr);
+    if (memoria)
+        memoria->guardar(escritor);
+    escritor.seccion(Seccion::Fin);
+
+    FILE* destino = fopen(archivo.c_str(), "wb");
+    if (!destino) {
+        error = "no se pudo escribir " + archivo;
+        return false;
+    }
+    Cabecera cabecera{};
+    memcpy(cabecera.magia, MAGIA, sizeof(MAGIA));
+    cabecera.version = VERSION;
+    cabecera.tamano = escritor.datos().size();
+    bool escrito = fwrite(&cabecera, sizeof(cabecera), 1, destino) == 1
+                && fwrite(escritor.datos().data(), 1, escritor.datos().size(), destino) == escritor.datos().size();
+    if (fclose(destino) != 0 || !escrito) {
+        error = "no se pudo escribir " + archivo;
+        return false;
+    }
+    return true;
+}
+
+bool cargar(const string& archivo, CPU& cpu, Disk& disco, Memoria* memoria, string& error) {
+    Mapeo mapeo(archivo);
+    if (!mapeo.datos) {
+        error = "no se pudo abrir " + archivo;
+        return false;
+    }
+
+    // La cabecera se valida antes de tocar el estado actual
+    Cabecera cabecera;
+    if (mapeo.tamano < sizeof(cabecera)) {
+        error = "archivo demasiado corto";
+        return false;
+    }
+    memcpy(&cabecera, mapeo.datos, sizeof(cabecera));
+    if (memcmp(cabecera.magia, MAGIA, sizeof(MAGIA)) != 0) {
+        error = "no es una instantanea de Kernel-Sim";
+        return false;
+    }
+    if (cabecera.version != VERSION) {
+        error = "version " + to_string(cabecera.version) + " no soportada (se espera "
+              + to_string(VERSION) + ")";
+        return false;
+    }
+    if (cabecera.tamano != mapeo.tamano - sizeof(cabecera)) {
+        error = "instantanea truncada";
+        return false;
+    }
+
+    // Cada seccion se lee en un temporal; el estado actual solo se reemplaza cuando
+    // el archivo entero resulto valido
+    Lector lector(mapeo.datos + sizeof(cabecera), (size_t) cabecera.tamano);
+    CPU cpuCargada(1);
+    Disk discoCargado(disco.get_name());
+    Memoria memoriaCargada(0);
+    bool hayMemoria;
+    try {
+        lector.seccion(Seccion::CPU);
+        cpuCargada.cargar(lector);
+        lector.seccion(Seccion::Disco);
+        discoCargado.cargar(lector);
+        lector.seccion(Seccion::Memoria);
+        hayMemoria = lector.valor<uint8_t>();
+        if (hayMemoria)
+            memoriaCargada.cargar(lector);
+        lector.seccion(Seccion::Fin);
+    } catch (const exception& e) {
+        error = e.what();
+        return false;
+    }
+    cpu = move(cpuCargada);
+    disco = move(discoCargado);
+    if (memoria && hayMemoria)
+        *memoria = move(memoriaCargada);
+    return true;
+}
+
+} // namespace instantanea
@@ -0,0 +1,134 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+class CPU;
+class Disk;
+class Memoria;
+
+// Instantaneas del estado completo del simulador (save/load).
+//
+// El archivo es una cabecera {magia, version, tamaño} seguida de secciones
+// etiquetadas (cpu, disco, memoria). Dentro de cada seccion los arreglos calientes
+// (tabla de procesos, colas, histogramas) se escriben tal cual estan en memoria,
+// alineados a 8 bytes; al cargar, el archivo se mapea con mmap y cada arreglo se
+// copia en bloque a su destino, sin interpretar campo por campo.
+namespace instantanea {
+
+constexpr uint32_t VERSION = 13;
+constexpr uint32_t NULO = UINT32_MAX; // indice de ranura ausente (proceso nulo)
+
+// Etiquetas de seccion: detectan un archivo desalineado con el lector
+enum class Seccion : uint32_t { CPU = 0x20555043, Disco = 0x4b534944, Memoria = 0x204d454d, Fin = 0x204e4946 };
+
+class Escritor {
+public:
+    template <typename T>
+    void valor(const T& v) {
+        static_assert(is_trivially_copyable_v<T>);
+        crudo(&v, sizeof(T));
+    }
+
+    // Cantidad seguida de los elementos; ambos empiezan alineados a 8 bytes aunque
+    // antes se haya escrito un valor suelto mas chico
+    template <typename T>
+    void arreglo(const T* datos, size_t cantidad) {
+        static_assert(is_trivially_copyable_v<T> && alignof(T) <= 8);
+        alinear();
+        valor<uint64_t>(cantidad);
+        crudo(datos, cantidad * sizeof(T));
+        alinear();
+    }
+
+    template <typename T>
+    void arreglo(const vector<T>& v) { arreglo(v.data(), v.size()); }
+
+    void texto(const string& s) { arreglo(s.data(), s.size()); }
+    void seccion(Seccion s) { valor(s); }
+
+    const vector<char>& datos() const { return bufer; }
+
+private:
+    void crudo(const void* datos, size_t bytes);
+    void alinear();
+
+    vector<char> bufer;
+};
+
+// Lee sobre una region mapeada. Un archivo truncado o desalineado lanza runtime_error.
+class Lector {
+public:
+    Lector(const char* inicio, size_t tamano) : inicio(inicio), fin(inicio + tamano), pos(inicio) {}
+
+    template <typename T>
+    T valor() {
+        static_assert(is_trivially_copyable_v<T>);
+        T v;
+        memcpy(&v, tomar(sizeof(T)), sizeof(T));
+        return v;
+    }
+
+    // Vista sobre los elementos del archivo, sin copiarlos. La region tiene que empezar
+    // alineada a 8 bytes (mmap y vector<char> lo estan, y la cabecera mide 24)
+    template <typename T>
+    span<const T> vista() {
+        static_assert(is_trivially_copyable_v<T> && alignof(T) <= 8);
+        alinear();
+        uint64_t cantidad = valor<uint64_t>();
+        if (cantidad > (uint64_t) (fin - pos) / max<size_t>(sizeof(T), 1))
+            throw runtime_error("instantanea truncada");
+        if (reinterpret_cast<uintptr_t>(pos) % alignof(T) != 0)
+            throw runtime_error("instantanea desalineada");
+        const T* datos = reinterpret_cast<const T*>(tomar(cantidad * sizeof(T)));
+        alinear();
+        return {datos, cantidad};
+    }
+
+    // Copia en bloque el arreglo al vector destino
+    template <typename T>
+    void arreglo(vector<T>& destino) {
+        span<const T> v = vista<T>();
+        destino.resize(v.size());
+        if (!v.empty())
+            memcpy(destino.data(), v.data(), v.size() * sizeof(T));
+    }
+
+    string texto() {
+        span<const char> v = vista<char>();
+        return string(v.begin(), v.end());
+    }
+
+    size_t restantes() const { return (size_t) (fin - pos); }
+
+    void seccion(Seccion esperada) {
+        if (valor<Seccion>() != esperada)
+            throw runtime_error("seccion inesperada en la instantanea");
+    }
+
+private:
+    const char* tomar(size_t bytes);
+    void alinear();
+
+    const char* inicio;
+    const char* fin;
+    const char* pos;
+};
+
+// Escribe la CPU (tabla de procesos, planificador, E/S, temporizadores, tiempo real,
+// metricas), el arbol del disco y, si se da, la memoria.
+bool guardar(const string& archivo, const CPU& cpu, const Disk& disco, const Memoria* memoria, string& error);
+
+// Reemplaza el estado de cpu, disco y memoria por el de la instantanea. La CPU toma
+// la politica, el quantum y los nucleos guardados. Si el archivo esta dañado no
+// cambia nada: todo se lee antes de reemplazar.
+bool cargar(const string& archivo, CPU& cpu, Disk& disco, Memoria* memoria, string& error);
+
+} // namespace instantanea
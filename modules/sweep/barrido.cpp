@@ -0,0 +1,165 @@
+#include "barrido.h"
+#include "../cpu/cpu.h"
+#include "../mem/mem.h"
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <iomanip>
+#include <map>
+#include <thread>
+
+vector<PuntoBarrido> expandir(const Grilla& grilla) {
+    vector<PuntoBarrido> puntos;
+    for (uint64_t semilla : grilla.semillas)
+        for (Planificacion politica : grilla.politicas)
+            for (int quantum : grilla.quantums)
+                for (const string& tipos : grilla.tipos) {
+                    vector<int> nucleos = tipos.empty() ? grilla.nucleos : vector<int>{(int) tipos.size()};
+                    for (int n : nucleos)
+                        for (int memoria : grilla.memorias)
+                            puntos.push_back({politica, quantum, n, memoria, semilla, tipos});
+                }
+    return puntos;
+}
+
+ResultadoBarrido simular(const PuntoBarrido& punto, const vector<PCB>& carga, long long paso,
+                         const ConfigEnergia& energia) {
+    auto inicio = chrono::steady_clock::now();
+    ResultadoBarrido resultado{punto};
+    CPU cpu(punto.quantum, punto.politica, punto.nucleos);
+    // Con un nucleo no hay nada que configurar: es un nucleo grande a frecuencia fija
+    if (auto tipos = tiposDesdeTexto(punto.tipos))
+        cpu.fijarTiposNucleo(*tipos);
+    cpu.fijarEnergia(energia);
+    // La CPU se detiene sola cuando no queda trabajo
+    const long long hastaTerminar = LLONG_MAX / 4;
+
+    if (punto.memoria <= 0) {
+        for (const PCB& programa : carga) cpu.add_process(programa);
+        cpu.ejecutar(hastaTerminar);
+    } else {
+        struct Residente {
+            Pid pid;
+            int bloque;
+        };
+        Memoria memoria(punto.memoria);
+        vector<Residente> residentes;
+        size_t siguiente = 0;
+        long long esperaTotal = 0;
+        while (true) {
+            // Los bloques de los procesos que terminaron vuelven a la memoria
+            if (cpu.procesos().vivos() < residentes.size()) {
+                erase_if(residentes, [&](const Residente& r) {
+                    if (cpu.procesos().vivo(r.pid))
+                        return false;
+                    memoria.liberar(r.bloque, 1);
+                    return true;
+                });
+            }
+            // Admision en orden de llegada mientras haya bloques libres
+            while (siguiente < carga.size()) {
+                int bloque = memoria.asignar(1);
+                if (bloque < 0)
+                    break;
+                residentes.push_back({cpu.add_process(carga[siguiente++]), bloque});
+                esperaTotal += cpu.reloj();
+            }
+            if (siguiente == carga.size()) {
+                cpu.ejecutar(hastaTerminar);
+                break;
+            }
+            cpu.ejecutar(paso);
+        }
+        resultado.esperaMemoria = carga.empty() ? 0.0 : (double) esperaTotal / carga.size();
+    }
+
+    resultado.metricas = cpu.estadisticas();
+    resultado.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    return resultado;
+}
+
+vector<ResultadoBarrido> barrer(const Grilla& grilla, int hilos) {
+    vector<PuntoBarrido> puntos = expandir(grilla);
+
+    // Una carga por semilla, compartida entre los hilos solo para lectura
+    map<uint64_t, vector<PCB>> cargas;
+    for (uint64_t semilla : grilla.semillas)
+        if (!cargas.count(semilla))
+            cargas[semilla] = generarCarga(grilla.distribucion, grilla.procesos, semilla, grilla.media);
+
+    vector<ResultadoBarrido> resultados(puntos.size());
+    atomic<size_t> proximo{0};
+    auto trabajador = [&] {
+        for (size_t i; (i = proximo.fetch_add(1, memory_order_relaxed)) < puntos.size();)
+            resultados[i] = simular(puntos[i], cargas.at(puntos[i].semilla), grilla.paso, grilla.energia);
+    };
+
+    if (hilos <= 0)
+        hilos = (int) max(1u, thread::hardware_concurrency());
+    hilos = (int) min<size_t>(hilos, max<size_t>(puntos.size(), 1));
+    vector<thread> grupo;
+    for (int i = 0; i < hilos; ++i)
+        grupo.emplace_back(trabajador);
+    for (thread& hilo : grupo)
+        hilo.join();
+    return resultados;
+}
+
+namespace {
+    uint64_t totalCambios(const Metricas& m) {
+        uint64_t total = 0;
+        for (uint64_t c : m.cambiosContexto) total += c;
+        return total;
+    }
+
+    double julios(const ResultadoBarrido& r) { return r.metricas.energia / 1e6; }
+
+    // Rendimiento por vatio: (procesos / s) / W = procesos / J
+    double procesosPorJulio(const ResultadoBarrido& r) {
+        return julios(r) > 0 ? r.metricas.terminados / julios(r) : 0.0;
+    }
+
+    string etiquetaTipos(const ResultadoBarrido& r) {
+        return r.punto.tipos.empty() ? string(r.punto.nucleos, 'g') : r.punto.tipos;
+    }
+
+    double utilizacion(const ResultadoBarrido& r) {
+        long long capacidad = r.metricas.ultimaTerminacion * r.punto.nucleos;
+        return capacidad > 0 ? 100.0 * r.metricas.ticksOcupado / capacidad : 0.0;
+    }
+}
+
+void imprimirBarrido(ostream& os, const vector<ResultadoBarrido>& resultados) {
+    os << left << setw(10) << "politica" << right << setw(4) << "q" << setw(4) << "n" << setw(9) << "tipos"
+       << setw(8) << "memoria" << setw(8) << "semilla" << setw(11) << "terminados" << setw(11) << "makespan" << setw(7) << "util%"
+       << setw(9) << "ret_p50" << setw(9) << "ret_p99" << setw(10) << "espera" << setw(9) << "resp_p99"
+       << setw(10) << "cambios" << setw(10) << "esp_mem" << setw(10) << "julios" << setw(9) << "proc/J"
+       << setw(9) << "seg" << "\n";
+    for (const ResultadoBarrido& r : resultados) {
+        const Metricas& m = r.metricas;
+        os << left << setw(10) << nombrePlanificacion(r.punto.politica) << right << setw(4) << r.punto.quantum
+           << setw(4) << r.punto.nucleos << setw(9) << etiquetaTipos(r) << setw(8) << r.punto.memoria
+           << setw(8) << r.punto.semilla
+           << setw(11) << m.terminados << setw(11) << m.ultimaTerminacion << fixed << setprecision(1)
+           << setw(7) << utilizacion(r) << setw(9) << m.retorno.percentil(0.50) << setw(9) << m.retorno.percentil(0.99)
+           << setw(10) << m.espera.media() << setw(9) << m.respuesta.percentil(0.99) << setw(10) << totalCambios(m)
+           << setw(10) << r.esperaMemoria << setprecision(3) << setw(10) << julios(r) << setprecision(1)
+           << setw(9) << procesosPorJulio(r) << setprecision(3) << setw(9) << r.segundos << "\n";
+    }
+}
+
+void volcarBarridoCSV(ostream& os, const vector<ResultadoBarrido>& resultados) {
+    os << "politica,quantum,nucleos,tipos,memoria,semilla,terminados,makespan,utilizacion,retorno_p50,retorno_p99,"
+          "retorno_media,espera_media,respuesta_p50,respuesta_p99,cambios_contexto,espera_memoria,energia_j,"
+          "procesos_por_joule,segundos\n";
+    for (const ResultadoBarrido& r : resultados) {
+        const Metricas& m = r.metricas;
+        os << nombrePlanificacion(r.punto.politica) << "," << r.punto.quantum << "," << r.punto.nucleos << ","
+           << etiquetaTipos(r) << "," << r.punto.memoria << "," << r.punto.semilla << "," << m.terminados << ","
+           << m.ultimaTerminacion << ","
+           << setprecision(6) << utilizacion(r) << "," << m.retorno.percentil(0.50) << ","
+           << m.retorno.percentil(0.99) << "," << m.retorno.media() << "," << m.espera.media() << ","
+           << m.respuesta.percentil(0.50) << "," << m.respuesta.percentil(0.99) << "," << totalCambios(m) << ","
+           << r.esperaMemoria << "," << julios(r) << "," << procesosPorJulio(r) << "," << r.segundos << "\n";
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "../cpu/carga.h"
+#include "../cpu/energia.h"
+#include "../cpu/metricas.h"
+#include "../cpu/politicas.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Barrido de parametros: la misma carga sintetica corre sobre cada combinacion de
+// politica, quantum, nucleos (o tipos de nucleo) y memoria de la grilla, una simulacion independiente
+// por punto (su propia CPU y su propia Memoria, sin estado mutable compartido).
+// Los puntos se reparten entre un grupo de hilos; cada resultado ocupa la posicion
+// de su punto, asi que la tabla no depende del orden en que terminan los hilos y
+// la misma semilla reproduce los mismos numeros, tambien con varios nucleos (el SMP
+// despacha y roba en orden de nucleo). Solo `segundos`, tiempo real, cambia.
+struct Grilla {
+    Distribucion distribucion = Distribucion::Exponencial;
+    size_t procesos = 10000;
+    double media = 50.0;
+    vector<uint64_t> semillas = {42};
+    vector<Planificacion> politicas = {Planificacion::RoundRobin};
+    vector<int> quantums = {5};
+    vector<int> nucleos = {1};
+    vector<int> memorias = {0}; // bloques; 0 = sin limite
+    // Tipos de nucleo ("ggee"); uno no vacio reemplaza a la lista de nucleos por su largo
+    vector<string> tipos = {""};
+    ConfigEnergia energia;      // gobernador y colocacion, con varios nucleos
+    long long paso = 50;        // ticks entre revisiones de admision cuando la memoria esta llena
+};
+
+struct PuntoBarrido {
+    Planificacion politica;
+    int quantum;
+    int nucleos;
+    int memoria;
+    uint64_t semilla;
+    string tipos; // vacio: todos grandes
+};
+
+struct ResultadoBarrido {
+    PuntoBarrido punto;
+    Metricas metricas{};
+    double esperaMemoria = 0;   // ticks medios entre la llegada y la admision
+    double segundos = 0;        // tiempo real de la simulacion
+};
+
+// Producto cartesiano de la grilla, en orden estable (semilla mas externa)
+vector<PuntoBarrido> expandir(const Grilla& grilla);
+
+// Una simulacion completa. Cada proceso ocupa un bloque de memoria mientras vive
+// (la memoria fija el grado de multiprogramacion); los que no caben esperan en
+// orden de llegada a que termine alguno.
+ResultadoBarrido simular(const PuntoBarrido& punto, const vector<PCB>& carga, long long paso,
+                         const ConfigEnergia& energia = {});
+
+// Corre todos los puntos con `hilos` hilos (0 = uno por nucleo del equipo)
+vector<ResultadoBarrido> barrer(const Grilla& grilla, int hilos = 0);
+
+void imprimirBarrido(ostream& os, const vector<ResultadoBarrido>& resultados);
+void volcarBarridoCSV(ostream& os, const vector<ResultadoBarrido>& resultados);
@@ -1,14 +1,400 @@
+// Las pruebas corren tambien en Release: assert no debe desaparecer
+#undef NDEBUG
 #include "../modules/cpu/cpu.h"
+#include "../modules/cpu/traza.h"
+#include "../modules/sweep/barrido.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <tuple>
+#include <vector>
 
-int main() {
-    CPU cpu(2); // quantum = 2
+// Arbol rojo-negro de CFS contra una lista ordenada por (vruntime, llegada)
+static void probarCFS() {
+    mt19937 azar(4);
+    TablaProcesos tabla;
+    vector<PCB*> procesos;
+    for (int i = 0; i < 300; ++i)
+        procesos.push_back(tabla.crear(PCB("p", 10)));
+
+    politicas::CFS cfs;
+    vector<tuple<long long, int, PCB*>> referencia; // (vruntime, llegada, proceso)
+    vector<char> encolado(procesos.size(), 0);
+    int llegada = 0;
+    for (int op = 0; op < 20000; ++op) {
+        size_t i = azar() % procesos.size();
+        if (!encolado[i] && azar() % 3) {
+            // Pocos valores distintos: muchos empates, que respetan el orden de llegada
+            procesos[i]->vruntime = azar() % 50;
+            cfs.encolar(procesos[i]);
+            referencia.push_back({procesos[i]->vruntime, llegada++, procesos[i]});
+            encolado[i] = 1;
+        } else if (!referencia.empty()) {
+            auto menor = min_element(referencia.begin(), referencia.end());
+            PCB* elegido = cfs.siguiente();
+            assert(elegido == get<2>(*menor));
+            encolado[TablaProcesos::indiceDe(elegido)] = 0;
+            referencia.erase(menor);
+        }
+        assert(cfs.tamano() == referencia.size() && cfs.vacia() == referencia.empty());
+    }
+
+    size_t recorridos = 0;
+    long long anterior = -1;
+    cfs.recorrer([&](PCB* p) {
+        assert(p->vruntime >= anterior);
+        anterior = p->vruntime;
+        ++recorridos;
+    });
+    assert(recorridos == cfs.tamano());
+
+    // Rebanadas: nunca por debajo de la granularidad; valores invalidos no se aceptan
+    assert(!cfs.fijarRebanadas(0, 10) && !cfs.fijarRebanadas(8, 4));
+    assert(cfs.fijarRebanadas(5, 40));
+    assert(cfs.granularidad() == 5 && cfs.latencia() == 40);
+    for (PCB* p : procesos)
+        assert(cfs.rebanada(*p, 0) >= 5);
+}
+
+// Rueda de temporizadores: cada uno vence una sola vez, en su tick y en orden, aunque
+// haya bajado en cascada desde los niveles altos; los cancelados no vencen
+static void probarRuedaTemporizadores() {
+    mt19937_64 azar(13);
+    vector<PCB> procesos;
+    for (int i = 0; i < 3000; ++i)
+        procesos.emplace_back("t", 1);
+
+    RuedaTemporizadores rueda;
+    vector<long long> vence(procesos.size(), -1);
+    vector<RuedaTemporizadores::Id> ids(procesos.size());
+    vector<char> vencido(procesos.size(), 0);
+    for (size_t i = 0; i < procesos.size(); ++i) {
+        // Cerca (nivel 0), a media distancia y muy lejos (varias cascadas)
+        long long distancia = i % 3 == 0 ? 1 + (long long) (azar() % 64)
+                            : i % 3 == 1 ? 1 + (long long) (azar() % 300000)
+                                         : 1 + (long long) (azar() % (1LL << 40));
+        vence[i] = rueda.ahora() + distancia;
+        ids[i] = rueda.programar(vence[i], &procesos[i]);
+    }
+    for (size_t i = 0; i < procesos.size(); i += 7) {
+        rueda.cancelar(ids[i]);
+        vence[i] = -1;
+    }
+
+    long long ultimo = 0;
+    size_t vencidos = 0;
+    auto alVencer = [&](PCB* proceso) {
+        size_t i = (size_t) (proceso - procesos.data());
+        assert(vence[i] >= 0 && !vencido[i]);
+        assert(rueda.ahora() == vence[i] && vence[i] >= ultimo);
+        vencido[i] = 1;
+        ultimo = vence[i];
+        ++vencidos;
+    };
+    // Pasos cortos al principio y largos despues
+    for (int paso = 0; paso < 2000; ++paso)
+        rueda.avanzar(rueda.ahora() + 1 + (long long) (azar() % 200), alVencer);
+    while (!rueda.vacia())
+        rueda.avanzar(rueda.ahora() + (1LL << 34), alVencer);
+
+    size_t esperados = (size_t) count_if(vence.begin(), vence.end(), [](long long v) { return v >= 0; });
+    assert(vencidos == esperados);
+}
+
+// Loteria: cada proceso gana en proporcion a sus boletos; el que sale del sorteo no
+// vuelve a salir hasta reencolarse
+static void probarLoteria() {
+    TablaProcesos tabla;
+    vector<PCB*> procesos;
+    for (int boletos : {100, 200, 700}) {
+        PCB programa("p", 10);
+        programa.tickets = boletos;
+        procesos.push_back(tabla.crear(programa));
+    }
+
+    politicas::Loteria loteria;
+    for (PCB* p : procesos) loteria.encolar(p);
+    PCB* primero = loteria.siguiente();
+    PCB* segundo = loteria.siguiente();
+    PCB* tercero = loteria.siguiente();
+    assert(loteria.vacia());
+    assert(primero != segundo && segundo != tercero && primero != tercero);
+    for (PCB* p : procesos) loteria.encolar(p);
+
+    const int SORTEOS = 200000;
+    vector<int> ganados(procesos.size(), 0);
+    for (int i = 0; i < SORTEOS; ++i) {
+        PCB* ganador = loteria.siguiente();
+        ++ganados[TablaProcesos::indiceDe(ganador)];
+        loteria.encolar(ganador);
+    }
+    assert(fabs(ganados[0] / (double) SORTEOS - 0.1) < 0.01);
+    assert(fabs(ganados[1] / (double) SORTEOS - 0.2) < 0.01);
+    assert(fabs(ganados[2] / (double) SORTEOS - 0.7) < 0.01);
+}
+
+// Stride: el reparto se aparta de la proporcion ideal en a lo sumo un quantum
+static void probarStride() {
+    TablaProcesos tabla;
+    vector<PCB*> procesos;
+    for (int boletos : {100, 200, 700}) {
+        PCB programa("p", 10);
+        programa.tickets = boletos;
+        procesos.push_back(tabla.crear(programa));
+    }
+
+    politicas::Stride stride;
+    for (PCB* p : procesos) stride.encolar(p);
+    vector<int> corridos(procesos.size(), 0);
+    for (int tick = 1; tick <= 10000; ++tick) {
+        PCB* elegido = stride.siguiente();
+        stride.contabilizar(*elegido, 1);
+        ++corridos[TablaProcesos::indiceDe(elegido)];
+        stride.encolar(elegido);
+        if (tick % 10 == 0) {
+            assert(abs(corridos[0] - tick / 10) <= 1);
+            assert(abs(corridos[1] - tick / 5) <= 1);
+            assert(abs(corridos[2] - tick * 7 / 10) <= 1);
+        }
+    }
+}
+
+// P2 contra el cuantil exacto de las mismas muestras
+static void probarCuantilP2() {
+    mt19937_64 azar(16);
+    uniform_real_distribution<double> uniforme(0, 1000);
+    exponential_distribution<double> exponencial(0.1);
+    for (double p : {0.5, 0.9, 0.99}) {
+        for (int distribucion = 0; distribucion < 2; ++distribucion) {
+            CuantilP2 cuantil(p);
+            vector<double> muestras;
+            for (int i = 0; i < 100000; ++i) {
+                double x = distribucion == 0 ? uniforme(azar) : exponencial(azar);
+                muestras.push_back(x);
+                cuantil.registrar(x);
+            }
+            sort(muestras.begin(), muestras.end());
+            double exacto = muestras[(size_t) (p * (muestras.size() - 1))];
+            assert(cuantil.cuenta() == muestras.size());
+            assert(fabs(cuantil.estimacion() - exacto) <= 0.02 * exacto);
+        }
+    }
+
+    // Con menos de cinco muestras el cuantil es exacto
+    CuantilP2 pocas(0.5);
+    for (double x : {9.0, 1.0, 5.0}) pocas.registrar(x);
+    assert(pocas.estimacion() == 5.0);
+}
 
-    /*
-    cpu.add_process(new PCB("1", 5));
-    cpu.add_process(new PCB("2", 3));
-    cpu.add_process(new PCB("3", 7));
+// Clase de tiempo real: plazos perdidos con EDF y RM. Cada tick libera y vence
+// trabajos y corre el mas urgente, como el scheduler
+static void simularTiempoReal(TiempoReal& tiempoReal, long long ticks) {
+    for (long long reloj = 0; reloj < ticks; ++reloj) {
+        tiempoReal.actualizar(reloj);
+        if (tiempoReal.hayListo())
+            tiempoReal.ejecutar(reloj, 1);
+    }
+}
+
+static void probarTiempoReal() {
+    auto programa = [](int wcet, int periodo) {
+        PCB p("rt", wcet);
+        p.periodo = periodo;
+        return p;
+    };
+
+    // Utilizacion 0.971: EDF la cumple, RM (cota 0.828 con dos tareas) no la acepta
+    TiempoReal edf;
+    assert(edf.admitir(programa(2, 5), 0) && edf.admitir(programa(4, 7), 0));
+    simularTiempoReal(edf, 35 * 100);
+    for (const auto& tarea : edf.lista()) {
+        assert(tarea.perdidos == 0);
+        assert(tarea.liberados - tarea.completados <= 1);
+    }
+    assert(!edf.fijarModo(ModoTiempoReal::RM) && edf.modo() == ModoTiempoReal::EDF);
+
+    // Debajo de la cota de Liu y Layland, RM tampoco pierde plazos
+    TiempoReal rm;
+    assert(rm.fijarModo(ModoTiempoReal::RM));
+    assert(rm.admitir(programa(1, 4), 0) && rm.admitir(programa(2, 6), 0));
+    assert(!rm.admitir(programa(3, 10), 0)); // 0.883 > 0.780 con tres tareas
+    simularTiempoReal(rm, 1200);
+    for (const auto& tarea : rm.lista())
+        assert(tarea.perdidos == 0 && tarea.liberados == tarea.completados);
+    assert(rm.fijarModo(ModoTiempoReal::EDF));
+
+    // Sin CPU cada trabajo vence en su plazo, con ambos modos
+    for (ModoTiempoReal modo : {ModoTiempoReal::EDF, ModoTiempoReal::RM}) {
+        TiempoReal ocioso;
+        assert(ocioso.fijarModo(modo));
+        assert(ocioso.admitir(programa(3, 10), 0));
+        ocioso.actualizar(95);
+        assert(ocioso.lista()[0].liberados == 10 && ocioso.lista()[0].perdidos == 9);
+        ocioso.actualizar(100);
+        assert(ocioso.lista()[0].liberados == 11 && ocioso.lista()[0].perdidos == 10);
+        assert(ocioso.lista()[0].completados == 0);
+    }
+}
+
+// Round robin: el salto en forma cerrada hace las mismas rondas que ir rebanada por
+// rebanada, y no salta la ronda en que termina alguien
+static void probarSaltoRoundRobin() {
+    mt19937 azar(8);
+    for (int caso = 0; caso < 500; ++caso) {
+        TablaProcesos tabla;
+        politicas::RoundRobin rr;
+        int n = 1 + (int) (azar() % 100);
+        for (int i = 0; i < n; ++i)
+            rr.encolar(tabla.crear(PCB("p", 1 + (int) (azar() % 2000))));
+        int quantum = 1 + (int) (azar() % 10);
+        long long presupuesto = (long long) (azar() % 200000);
+
+        vector<int> antes = tabla.restante;
+        long long consumido = rr.saltarRondas(tabla, quantum, presupuesto);
+        long long costoRonda = (long long) n * quantum;
+        assert(consumido % costoRonda == 0 && consumido <= presupuesto);
+        int rondas = (int) (consumido / costoRonda);
+        int minimo = *min_element(antes.begin(), antes.end());
+        for (int i = 0; i < n; ++i) {
+            assert(tabla.restante[i] == antes[i] - rondas * quantum);
+            assert(tabla.restante[i] > 0);
+        }
+        // Una ronda mas terminaria a alguien o no alcanza el presupuesto
+        assert(minimo - (rondas + 1) * quantum <= 0 || consumido + costoRonda > presupuesto);
+    }
+
+    // De punta a punta: un tick largo (con saltos) contra uno por vez (sin saltos)
+    for (int caso = 0; caso < 20; ++caso) {
+        int quantum = 1 + (int) (azar() % 6);
+        CPU conSaltos(quantum), pasoAPaso(quantum);
+        for (int i = 0; i < 60; ++i) {
+            PCB programa("p", 1 + (int) (azar() % 400));
+            conSaltos.add_process(programa);
+            pasoAPaso.add_process(programa);
+        }
+        const long long TICKS = 30000;
+        conSaltos.ejecutar(TICKS);
+        for (long long t = 0; t < TICKS; ++t)
+            pasoAPaso.ejecutar(1);
+
+        Metricas a = conSaltos.estadisticas(), b = pasoAPaso.estadisticas();
+        assert(conSaltos.reloj() == pasoAPaso.reloj());
+        assert(a.terminados == b.terminados && a.terminados == 60);
+        assert(a.ultimaTerminacion == b.ultimaTerminacion);
+        assert(a.retorno.media() == b.retorno.media() && a.espera.media() == b.espera.media());
+        assert(a.respuesta.media() == b.respuesta.media());
+        assert(a.ticksOcupado == b.ticksOcupado);
+    }
+}
+
+// Varios nucleos: la misma carga da las mismas metricas en cada corrida (los robos se
+// deciden en orden de nucleo, no por que hilo llega antes) y cada nucleo usa la politica elegida
+static string correrSMP(Planificacion politica, int nucleos, uint64_t semilla) {
+    mt19937_64 azar(semilla);
+    CPU cpu(1 + (int) (azar() % 6), politica, nucleos);
+    assert(cpu.planificacion() == politica && cpu.nucleos() == nucleos);
+    for (int ronda = 0; ronda < 4; ++ronda) {
+        for (int i = (int) (azar() % 50); i > 0; --i) {
+            PCB programa("p", 1 + (int) (azar() % 80), (int) (azar() % 5));
+            programa.nice = (int) (azar() % 10) - 5;
+            programa.tickets = 1 + (int) (azar() % 500);
+            if (azar() % 2)
+                programa.fijarRafagas(vector<int>{1 + (int) (azar() % 20), 1 + (int) (azar() % 20), 1 + (int) (azar() % 20)});
+            cpu.add_process(programa);
+        }
+        cpu.ejecutar(1 + (long long) (azar() % 300));
+    }
+    cpu.ejecutar(1000000);
+    assert(cpu.procesos().vivos() == 0);
+    stringstream salida;
+    Metricas metricas = cpu.estadisticas();
+    metricas.quantum.nsSobrecosto = 0; // tiempo real, no simulado
+    metricas.volcarJSON(salida, cpu.reloj());
+    return salida.str();
+}
+
+static void probarSMP() {
+    int politicas = (int) variant_size_v<SchedulerVariante>;
+    for (int politica = 0; politica < politicas; ++politica)
+        for (int nucleos : {2, 4})
+            for (uint64_t semilla = 0; semilla < 5; ++semilla)
+                assert(correrSMP((Planificacion) politica, nucleos, semilla)
+                       == correrSMP((Planificacion) politica, nucleos, semilla));
+
+    // Todos llegan juntos: el mas corto primero en cada nucleo baja el retorno medio
+    auto retornoMedio = [](Planificacion politica) {
+        mt19937 azar(5);
+        CPU cpu(4, politica, 2);
+        for (int i = 0; i < 200; ++i)
+            cpu.add_process(PCB("p", 1 + (int) (azar() % 100)));
+        cpu.ejecutar(100000);
+        assert(cpu.estadisticas().terminados == 200);
+        return cpu.estadisticas().retorno.media();
+    };
+    assert(retornoMedio(Planificacion::SJF) < retornoMedio(Planificacion::FIFO));
+}
 
-    cpu.ejecutarRoundRobin();*/
+// El peso reparte la CPU entre grupos hermanos con cualquier politica, aunque uno
+// tenga muchos mas procesos que otro; la cuota acota a su grupo aunque le toque mas
+static void probarGrupos() {
+    int politicas = (int) variant_size_v<SchedulerVariante>;
+    for (int politica = 0; politica < politicas; ++politica) {
+        CPU cpu(4, (Planificacion) politica);
+        assert(cpu.crearGrupo("a") && cpu.crearGrupo("b") && cpu.crearGrupo("c"));
+        assert(cpu.fijarPesoGrupo("b", 3 * Grupos::PESO_BASE) && cpu.fijarCuotaGrupo("c", 10, 100));
+        assert(!cpu.fijarPesoGrupo("a", Grupos::PESO_MAXIMO + 1));
+        for (auto [grupo, procesos] : {pair{"a", 30}, pair{"b", 2}, pair{"c", 1}}) {
+            assert(cpu.usarGrupo(grupo));
+            for (int i = 0; i < procesos; ++i)
+                cpu.add_process(PCB(grupo, 100000 + i));
+        }
+        cpu.ejecutar(20000);
+        uint64_t a = cpu.consumoGrupo("a")->consumo;
+        uint64_t b = cpu.consumoGrupo("b")->consumo;
+        uint64_t c = cpu.consumoGrupo("c")->consumo;
+        assert(a + b + c == 20000);
+        // Sin cuota c tendria 1/5 de la CPU: la cuota lo deja en 10 de cada 100 ticks
+        assert(c > 1900 && c <= 2000);
+        assert(b > 2.9 * a && b < 3.1 * a);
+    }
+}
 
+// Un barrido con varios nucleos y memoria limitada da la misma tabla en cada corrida
+static void probarBarrido() {
+    Grilla grilla;
+    grilla.procesos = 300;
+    grilla.semillas = {1, 2};
+    grilla.politicas = {Planificacion::RoundRobin, Planificacion::CFS, Planificacion::SRTF};
+    grilla.nucleos = {1, 2, 4};
+    grilla.memorias = {0, 16};
+    auto tabla = [&] {
+        stringstream salida;
+        for (const ResultadoBarrido& r : barrer(grilla, 4)) {
+            Metricas metricas = r.metricas;
+            metricas.quantum.nsSobrecosto = 0;
+            metricas.volcarJSON(salida, metricas.ultimaTerminacion);
+            salida << r.esperaMemoria << "\n";
+        }
+        return salida.str();
+    };
+    assert(tabla() == tabla());
+}
+
+int main() {
+    traza::fijarConsola(traza::Consola::Nada);
+    probarCFS();
+    probarRuedaTemporizadores();
+    probarLoteria();
+    probarStride();
+    probarCuantilP2();
+    probarTiempoReal();
+    probarSaltoRoundRobin();
+    probarSMP();
+    probarGrupos();
+    probarBarrido();
+    printf("test_cpu: ok\n");
     return 0;
 }
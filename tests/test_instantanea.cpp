@@ -0,0 +1,177 @@
+// Las pruebas corren tambien en Release: assert no debe desaparecer
+#undef NDEBUG
+#include "../modules/snapshot/instantanea.h"
+#include "../modules/cpu/cpu.h"
+#include "../modules/cpu/traza.h"
+#include "../modules/disk/disk.h"
+#include "../modules/mem/mem.h"
+#include "../modules/mem/paginacion.h"
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+
+static const string ARCHIVO = (filesystem::temp_directory_path() / "kernel-sim-test_instantanea.snap").string();
+
+// Procesos con rafagas de CPU, E/S y espera, y a veces una tarea periodica.
+// Con un nucleo, cada tanda va a un grupo de control distinto
+static void cargarTrabajo(CPU& cpu, mt19937_64& azar) {
+    cpu.usarGrupo(vector<string>{"raiz", "a", "b", "c"}[azar() % 4]);
+    int n = (int) (azar() % 40);
+    for (int i = 0; i < n; ++i) {
+        PCB programa("p" + to_string(i), 1 + (int) (azar() % 50), (int) (azar() % 5));
+        programa.nice = (int) (azar() % 10) - 5;
+        programa.tickets = 1 + (int) (azar() % 500);
+        if (azar() % 2) {
+            vector<Rafaga> rafagas;
+            int k = 1 + 2 * (int) (azar() % 4);
+            for (int j = 0; j < k; ++j) {
+                TipoRafaga tipo = j % 2 == 0 ? TipoRafaga::CPU : azar() % 2 ? TipoRafaga::Dormir : TipoRafaga::ES;
+                rafagas.push_back({tipo, 1 + (int) (azar() % 30)});
+            }
+            programa.fijarRafagas(rafagas);
+        }
+        cpu.add_process(programa);
+    }
+    if (azar() % 3 == 0) {
+        PCB tarea("rt", 1 + (int) (azar() % 3));
+        tarea.periodo = 10 + (int) (azar() % 20);
+        cpu.agregarTareaPeriodica(tarea);
+    }
+}
+
+static string resumen(const CPU& cpu) {
+    stringstream salida;
+    Metricas metricas = cpu.estadisticas();
+    metricas.quantum.nsSobrecosto = 0; // tiempo real, no simulado
+    metricas.volcarJSON(salida, cpu.reloj());
+    return salida.str();
+}
+
+// Guardar a mitad de camino y seguir desde la copia da lo mismo que seguir con el
+// original, para cada politica, con uno (y grupos de control) y dos nucleos
+static void probarIdaYVueltaCPU() {
+    int politicas = (int) variant_size_v<SchedulerVariante>;
+    for (int politica = 0; politica < politicas; ++politica) {
+        for (int nucleos : {1, 2}) {
+            mt19937_64 azar((uint64_t) (politica * 10 + nucleos));
+            CPU original(1 + (int) (azar() % 6), (Planificacion) politica, nucleos);
+            CPU copia(3, Planificacion::FIFO, 3);
+            Disk disco("C");
+            if (nucleos == 1) {
+                assert(original.crearGrupo("a") && original.crearGrupo("b", "a") && original.crearGrupo("c"));
+                assert(original.fijarPesoGrupo("a", 3072) && original.fijarCuotaGrupo("b", 15, 50));
+            }
+            for (int ronda = 0; ronda < 3; ++ronda) {
+                cargarTrabajo(original, azar);
+                original.ejecutar(1 + (long long) (azar() % 300));
+            }
+
+            string error;
+            assert(instantanea::guardar(ARCHIVO, original, disco, nullptr, error));
+            assert(instantanea::cargar(ARCHIVO, copia, disco, nullptr, error));
+            assert(copia.planificacion() == original.planificacion() && copia.nucleos() == nucleos);
+            assert(resumen(copia) == resumen(original));
+
+            mt19937_64 azarCopia = azar;
+            for (int ronda = 0; ronda < 3; ++ronda) {
+                cargarTrabajo(original, azar);
+                original.ejecutar(1 + (long long) (azar() % 300));
+                cargarTrabajo(copia, azarCopia);
+                copia.ejecutar(1 + (long long) (azarCopia() % 300));
+            }
+            original.ejecutar(100000);
+            copia.ejecutar(100000);
+            assert(resumen(copia) == resumen(original));
+        }
+    }
+}
+
+// Disco y memoria viajan en el mismo archivo; un archivo dañado no cambia nada
+static void probarDiscoYMemoria() {
+    CPU cpu(3, Planificacion::CFS);
+    assert(cpu.fijarRebanadasCFS(4, 30));
+    cpu.add_process(PCB("a", 40));
+    cpu.ejecutar(7);
+    Disk disco("C");
+    disco.get_current_directory()->command("new a.txt", nullptr);
+    disco.get_current_directory()->command("mkdir docs", nullptr);
+    disco.go_to_path("docs");
+    disco.get_current_directory()->command("new b.txt", nullptr);
+    Memoria memoria(256, Ajuste::Mejor);
+    memoria.asignar(10);
+    memoria.asignar(20);
+    memoria.liberar(0, 10);
+
+    string error;
+    assert(instantanea::guardar(ARCHIVO, cpu, disco, &memoria, error));
+
+    // La etiqueta de la seccion del disco rota: falla sin tocar nada
+    ifstream entrada(ARCHIVO, ios::binary);
+    string datos((istreambuf_iterator<char>(entrada)), {});
+    entrada.close();
+    uint32_t etiqueta = (uint32_t) instantanea::Seccion::Disco;
+    size_t posicion = datos.find(string(reinterpret_cast<const char*>(&etiqueta), sizeof(etiqueta)));
+    assert(posicion != string::npos);
+    datos[posicion] ^= 1;
+    string roto = ARCHIVO + ".roto";
+    ofstream(roto, ios::binary) << datos;
+
+    CPU otra(5, Planificacion::RoundRobin, 2);
+    otra.add_process(PCB("b", 10));
+    otra.ejecutar(3);
+    Disk otroDisco("D");
+    Memoria otraMemoria(64);
+    assert(!instantanea::cargar(roto, otra, otroDisco, &otraMemoria, error));
+    assert(otra.nucleos() == 2 && otra.reloj() == 3 && otra.procesos().vivos() == 1);
+    assert(otroDisco.get_name() == "D" && otraMemoria.tamano() == 64);
+    remove(roto.c_str());
+
+    assert(instantanea::cargar(ARCHIVO, otra, otroDisco, &otraMemoria, error));
+    assert(resumen(otra) == resumen(cpu) && otra.planificacion() == Planificacion::CFS);
+    assert(otroDisco.get_name() == "C" && otroDisco.get_current_directory_path() == disco.get_current_directory_path());
+    assert(otroDisco.get_current_directory()->command("ls", nullptr) == disco.get_current_directory()->command("ls", nullptr));
+    assert(otraMemoria.tamano() == 256 && otraMemoria.libres() == memoria.libres());
+    assert(otraMemoria.estrategia() == Ajuste::Mejor && otraMemoria.huecos() == memoria.huecos());
+    assert(otraMemoria.asignar(5) == memoria.asignar(5));
+    remove(ARCHIVO.c_str());
+}
+
+// Memoria virtual: las mismas traducciones y contadores; el TLB vuelve vacio
+static void probarMemoriaVirtual() {
+    MemoriaVirtual memoria(1024);
+    for (uint32_t espacio = 0; espacio < 3; ++espacio) {
+        memoria.crearEspacio(espacio);
+        assert(memoria.mapear(espacio, 0x400000 + espacio * 0x10000, 50));
+    }
+    memoria.desmapear(1, 0x410000, 10);
+    memoria.destruirEspacio(2);
+    for (uint64_t d = 0x400000; d < 0x440000; d += 0x800)
+        memoria.traducir(0, d);
+
+    instantanea::Escritor escritor;
+    memoria.guardar(escritor);
+    instantanea::Lector lector(escritor.datos().data(), escritor.datos().size());
+    MemoriaVirtual cargada;
+    cargada.cargar(lector);
+
+    assert(cargada.marcosLibres() == memoria.marcosLibres());
+    assert(cargada.fallosPagina() == memoria.fallosPagina());
+    assert(cargada.tlb().aciertos() == memoria.tlb().aciertos());
+    assert(!cargada.existe(2) && cargada.existe(1));
+    for (uint32_t espacio = 0; espacio < 2; ++espacio)
+        for (uint64_t d = 0x400000; d < 0x440000; d += 0x800)
+            assert(cargada.traducir(espacio, d) == memoria.traducir(espacio, d));
+}
+
+int main() {
+    traza::fijarConsola(traza::Consola::Nada);
+    probarIdaYVueltaCPU();
+    probarDiscoYMemoria();
+    probarMemoriaVirtual();
+    printf("test_instantanea: ok\n");
+    return 0;
+}
@@ -1,10 +1,206 @@
+// Las pruebas corren tambien en Release: assert no debe desaparecer
+#undef NDEBUG
 #include "../modules/mem/mem.h"
+#include "../modules/mem/buddy.h"
+#include "../modules/mem/paginacion.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Hueco que elegiria cada estrategia recorriendo el mapa bloque por bloque
+static int huecoEsperado(const vector<char>& ocupado, int cantidad, Ajuste ajuste, int cursor) {
+    vector<pair<int, int>> huecos; // (inicio, largo)
+    for (int i = 0; i < (int) ocupado.size();) {
+        if (ocupado[i]) {
+            ++i;
+            continue;
+        }
+        int j = i;
+        while (j < (int) ocupado.size() && !ocupado[j]) ++j;
+        huecos.push_back({i, j - i});
+        i = j;
+    }
+    int mejor = -1, largoMejor = 0;
+    for (auto [inicio, largo] : huecos) {
+        if (largo < cantidad)
+            continue;
+        if (ajuste == Ajuste::Primero)
+            return inicio;
+        if (ajuste == Ajuste::Mejor && (mejor < 0 || largo < largoMejor))
+            mejor = inicio, largoMejor = largo;
+        if (ajuste == Ajuste::Peor && (mejor < 0 || largo > largoMejor))
+            mejor = inicio, largoMejor = largo;
+    }
+    if (ajuste == Ajuste::Siguiente) {
+        for (auto [inicio, largo] : huecos)
+            if (inicio >= cursor && largo >= cantidad) return inicio;
+        for (auto [inicio, largo] : huecos)
+            if (inicio < cursor && largo >= cantidad) return inicio;
+        return -1;
+    }
+    return mejor;
+}
+
+// Mapa de bits (primer ajuste) y arboles de extensiones (las otras tres estrategias)
+// contra la referencia, con liberaciones dobles y parciales de por medio
+static void probarAjustes() {
+    mt19937 azar(7);
+    for (int caso = 0; caso < 200; ++caso) {
+        Ajuste ajuste = (Ajuste) (caso % 4);
+        int n = 1 + (int) (azar() % 500);
+        Memoria memoria(n, ajuste);
+        vector<char> ocupado(n, 0);
+        vector<pair<int, int>> vivos;
+        int cursor = 0;
+        for (int op = 0; op < 1000; ++op) {
+            if (azar() % 3) {
+                int cantidad = 1 + (int) (azar() % (azar() % 4 == 0 ? 100 : 8));
+                int esperado = huecoEsperado(ocupado, cantidad, ajuste, cursor);
+                int inicio = memoria.asignar(cantidad);
+                assert(inicio == esperado);
+                if (inicio >= 0) {
+                    fill(ocupado.begin() + inicio, ocupado.begin() + inicio + cantidad, 1);
+                    vivos.push_back({inicio, cantidad});
+                    cursor = inicio + cantidad;
+                }
+            } else if (!vivos.empty()) {
+                size_t k = azar() % vivos.size();
+                auto [inicio, cantidad] = vivos[k];
+                vivos.erase(vivos.begin() + (ptrdiff_t) k);
+                memoria.liberar(inicio, cantidad);
+                int libres = memoria.libres(), huecos = memoria.huecos();
+                // Liberar dos veces no cuenta los bloques de nuevo ni parte los huecos
+                memoria.liberar(inicio, cantidad);
+                assert(memoria.libres() == libres && memoria.huecos() == huecos);
+                fill(ocupado.begin() + inicio, ocupado.begin() + inicio + cantidad, 0);
+            }
+            assert(memoria.libres() == (int) count(ocupado.begin(), ocupado.end(), 0));
+        }
+    }
+}
+
+// Buddy: bloques alineados a su tamano, sin solaparse; una liberacion repetida o con
+// otra cantidad se rechaza, y al liberar todo los companeros se vuelven a unir
+static void probarBuddy() {
+    mt19937 azar(3);
+    for (int caso = 0; caso < 200; ++caso) {
+        int64_t n = 1 + (int64_t) (azar() % 3000);
+        Buddy buddy(n);
+        vector<char> ocupado(n, 0);
+        vector<pair<int64_t, int64_t>> vivos;
+        for (int op = 0; op < 2000; ++op) {
+            if (azar() % 2) {
+                int64_t cantidad = 1 + (int64_t) (azar() % (azar() % 5 == 0 ? 300 : 10));
+                int64_t inicio = buddy.asignar(cantidad);
+                if (inicio < 0)
+                    continue;
+                int64_t bloque = (int64_t) bit_ceil((uint64_t) cantidad);
+                assert(inicio % bloque == 0 && inicio + bloque <= n);
+                for (int64_t i = inicio; i < inicio + bloque; ++i) {
+                    assert(!ocupado[i]);
+                    ocupado[i] = 1;
+                }
+                vivos.push_back({inicio, cantidad});
+            } else if (!vivos.empty()) {
+                size_t k = azar() % vivos.size();
+                auto [inicio, cantidad] = vivos[k];
+                vivos.erase(vivos.begin() + (ptrdiff_t) k);
+                int64_t bloque = (int64_t) bit_ceil((uint64_t) cantidad);
+                if (bloque > 1)
+                    assert(!buddy.liberar(inicio, bloque / 2)); // orden equivocado
+                assert(buddy.liberar(inicio, cantidad));
+                assert(!buddy.liberar(inicio, cantidad));
+                fill(ocupado.begin() + inicio, ocupado.begin() + inicio + bloque, 0);
+            }
+            assert(buddy.libres() == count(ocupado.begin(), ocupado.end(), 0));
+        }
+        for (auto [inicio, cantidad] : vivos)
+            assert(buddy.liberar(inicio, cantidad));
+        assert(buddy.libres() == n);
+        assert(buddy.mayorBloqueLibre() == (int64_t) bit_floor((uint64_t) n));
+    }
+}
+
+// Un conjunto de dos vias: el menos usado se va, y cada ASID tiene sus entradas
+static void probarTLB() {
+    TLB tlb(1, 2);
+    tlb.insertar(1, 10, 100);
+    tlb.insertar(1, 11, 101);
+    assert(tlb.buscar(1, 10) == 100); // 10 pasa a ser el mas reciente
+    tlb.insertar(1, 12, 102);         // desaloja a 11
+    assert(tlb.buscar(1, 11) == SIN_TRADUCCION);
+    assert(tlb.buscar(1, 10) == 100 && tlb.buscar(1, 12) == 102);
+    assert(tlb.aciertos() == 3 && tlb.fallos() == 1);
+
+    // La misma pagina en otro espacio es otra entrada
+    tlb.vaciar();
+    tlb.insertar(1, 10, 100);
+    tlb.insertar(2, 10, 200);
+    assert(tlb.buscar(1, 10) == 100 && tlb.buscar(2, 10) == 200);
+    tlb.invalidarEspacio(1);
+    assert(tlb.buscar(1, 10) == SIN_TRADUCCION && tlb.buscar(2, 10) == 200);
+    tlb.invalidar(2, 10);
+    assert(tlb.buscar(2, 10) == SIN_TRADUCCION);
+
+    // Destruir un espacio invalida sus traducciones aunque el ASID se reuse
+    MemoriaVirtual memoria(64);
+    memoria.crearEspacio(0);
+    assert(memoria.mapear(0, 0x400000, 1));
+    uint64_t fisica = memoria.traducir(0, 0x400123);
+    assert(fisica != SIN_TRADUCCION && (fisica & (TAMANO_PAGINA - 1)) == 0x123);
+    memoria.destruirEspacio(0);
+    memoria.crearEspacio(0);
+    assert(memoria.traducir(0, 0x400123) == SIN_TRADUCCION);
+    assert(memoria.marcosLibres() == 64);
+}
+
+// traducirLote da las mismas direcciones y los mismos aciertos, fallos del TLB y
+// fallos de pagina que traducir una por una
+static void probarTraducirLote() {
+    mt19937_64 azar(11);
+    MemoriaVirtual unoPorUno(4096), enLote(4096);
+    for (uint32_t espacio = 0; espacio < 4; ++espacio) {
+        unoPorUno.crearEspacio(espacio);
+        enLote.crearEspacio(espacio);
+        for (uint64_t base : {0x400000ull, 0x7fff00000000ull}) {
+            assert(unoPorUno.mapear(espacio, base, 300));
+            assert(enLote.mapear(espacio, base, 300));
+        }
+    }
+    vector<uint64_t> direcciones(4096), esperadas(4096), obtenidas(4096);
+    for (int ronda = 0; ronda < 50; ++ronda) {
+        uint32_t espacio = (uint32_t) (azar() % 5); // el 4 no existe
+        uint64_t direccion = azar() % 2 ? 0x400000 : 0x7fff00000000ull;
+        for (uint64_t& d : direcciones) {
+            // Corridas dentro de una pagina, saltos cortos y alguno fuera de lo mapeado
+            if (azar() % 8 == 0)
+                direccion += (azar() % 5) * TAMANO_PAGINA;
+            else if (azar() % 64 == 0)
+                direccion += 400 * TAMANO_PAGINA;
+            d = direccion + azar() % TAMANO_PAGINA;
+        }
+        for (size_t i = 0; i < direcciones.size(); ++i)
+            esperadas[i] = unoPorUno.traducir(espacio, direcciones[i]);
+        enLote.traducirLote(espacio, direcciones.data(), obtenidas.data(), direcciones.size());
+        assert(obtenidas == esperadas);
+        assert(enLote.tlb().aciertos() == unoPorUno.tlb().aciertos());
+        assert(enLote.tlb().fallos() == unoPorUno.tlb().fallos());
+        assert(enLote.fallosPagina() == unoPorUno.fallosPagina());
+    }
+    assert(enLote.recorridos() <= unoPorUno.recorridos());
+}
 
 int main() {
-    Memoria m(10);
-    m.asignar(3);
-    m.mostrar();
-    m.liberar(0, 3);
-    m.mostrar();
+    probarAjustes();
+    probarBuddy();
+    probarTLB();
+    probarTraducirLote();
+    printf("test_mem: ok\n");
     return 0;
 }